@@ -0,0 +1,100 @@
+#ifndef ANALYZER_ISPY_ASSOCIATIONS_H
+#define ANALYZER_ISPY_ASSOCIATIONS_H
+
+#include "ISpy/Services/interface/IgCollection.h"
+#include <cstddef>
+#include <vector>
+
+// One-to-many associations whose children are created in one block
+// right after (or while) filling their parent: track hits, refitted
+// track points, cluster rechit fractions.
+//
+// By default this is the IgAssociations set of the given name, one
+// pair of object references per child. With ranges set (the service
+// rangeAssociations option) the same calls fill the ranges collection
+// instead, one row (parent, first, count) per block of consecutive
+// children of a parent, where parent, first and first + count - 1 are
+// rows of the parent and child collections. A child that does not
+// follow the previous one of the same parent starts a new row, so
+// this is exact whatever the order, just less compact.
+//
+// All the parents must come from one collection and all the children
+// from another. Make one per event; the last row is written by flush()
+// or on destruction.
+
+class ISpyAssociations
+{
+public:
+  ISpyAssociations(IgDataStorage* storage, const char* name, const char* ranges, bool useRanges)
+    : associations_(0),
+      ranges_(0),
+      parent_(-1),
+      first_(0),
+      count_(0)
+    {
+      if ( useRanges )
+      {
+        ranges_ = &storage->getCollection(ranges);
+        properties_.push_back(ranges_->addProperty("parent", int(0)));
+        properties_.push_back(ranges_->addProperty("first", int(0)));
+        properties_.push_back(ranges_->addProperty("count", int(0)));
+      }
+      else
+        associations_ = &storage->getAssociations(name);
+    }
+
+  ~ISpyAssociations()
+    {
+      flush();
+    }
+
+  void associate(IgCollectionItem& parent, IgCollectionItem& child)
+    {
+      if ( associations_ )
+      {
+        associations_->associate(parent, child);
+        return;
+      }
+
+      int p = parent.currentRow();
+      int c = child.currentRow();
+
+      if ( p == parent_ && c == first_ + count_ )
+      {
+        ++count_;
+        return;
+      }
+
+      flush();
+
+      parent_ = p;
+      first_ = c;
+      count_ = 1;
+    }
+
+  void flush()
+    {
+      if ( count_ == 0 )
+        return;
+
+      IgCollectionItem range = ranges_->create();
+      range[properties_[0]] = parent_;
+      range[properties_[1]] = first_;
+      range[properties_[2]] = count_;
+
+      count_ = 0;
+    }
+
+private:
+  ISpyAssociations(const ISpyAssociations&);
+  ISpyAssociations& operator=(const ISpyAssociations&);
+
+  IgAssociations*	associations_;
+  IgCollection*		ranges_;
+  std::vector<IgProperty> properties_; // parent, first, count
+  int			parent_;
+  int			first_;
+  int			count_;
+};
+
+#endif // ANALYZER_ISPY_ASSOCIATIONS_H
@@ -1,8 +1,9 @@
 #ifndef ANALYZER_ISPY_BASIC_CLUSTER_H
 #define ANALYZER_ISPY_BASIC_CLUSTER_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/EgammaReco/interface/BasicClusterFwd.h"
 
 #ifdef CMSSW_2_2_X
 #include "DataFormats/EgammaReco/interface/BasicCluster.h"
@@ -10,23 +11,24 @@
 #include "DataFormats/CaloRecHit/interface/CaloCluster.h"
 #endif
 
-class ISpyBasicCluster : public edm::EDAnalyzer
+class ISpyBasicCluster : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyBasicCluster(const edm::ParameterSet&);
   virtual ~ISpyBasicCluster(){}
 
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 
 private:
 
 #ifdef CMSSW_2_2_X
-  const std::string algoName(reco::AlgoId key);    
+  const std::string algoName(reco::AlgoId key) const;    
 #else
-  const std::string algoName(reco::CaloCluster::AlgoId key);
+  const std::string algoName(reco::CaloCluster::AlgoId key) const;
 #endif
 
   edm::InputTag	inputTag_;
+  edm::EDGetTokenT<reco::BasicClusterCollection> clusterToken_;
 };
 
 #endif // ANALYZER_ISPY_BASIC_CLUSTER_H
@@ -1,16 +1,18 @@
 #ifndef ANALYZER_ISPY_BEAMSPOT_H
 #define ANALYZER_ISPY_BEAMSPOT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/BeamSpot/interface/BeamSpot.h"
 
-class ISpyBeamSpot : public edm::EDAnalyzer
+class ISpyBeamSpot : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyBeamSpot(const edm::ParameterSet&);
     virtual ~ISpyBeamSpot(void){}
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
     edm::InputTag inputTag_;
+    edm::EDGetTokenT<reco::BeamSpot> beamSpotToken_;
 };
 #endif // ANALYZER_ISPY_BEAMSPOT_H
@@ -0,0 +1,99 @@
+#ifndef ANALYZER_ISPY_BUILD_TIMER_H
+#define ANALYZER_ISPY_BUILD_TIMER_H
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "ISpy/Services/interface/IgCollection.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Runs the geometry builders of ISpyTrackerGeometry, ISpyMuonGeometry
+// and ISpyCaloGeometry. With repeat = 0 (the default) a builder just
+// fills the storage. Otherwise it is first run repeat times into a
+// scratch storage, timing each run and measuring the serialized size
+// of what it wrote, and report() prints the mean, spread and minimum
+// of each builder.
+
+class ISpyBuildTimer
+{
+public:
+  explicit ISpyBuildTimer(unsigned int repeat) : repeat_(repeat) {}
+
+  template <class F>
+  void run(const std::string& name, IgDataStorage* storage, F build)
+    {
+      if ( repeat_ )
+      {
+        Result result;
+        result.name = name;
+        result.bytes = 0;
+
+        for ( unsigned int i = 0; i < repeat_; ++i )
+        {
+          IgDataStorage scratch;
+
+          std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+          build(&scratch);
+          result.times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+
+          if ( i == 0 )
+          {
+            std::stringstream oss;
+            oss << scratch;
+            result.bytes = oss.str().size();
+          }
+        }
+
+        results_.push_back(result);
+      }
+
+      build(storage);
+    }
+
+  void report(const std::string& module) const
+    {
+      if ( results_.empty() )
+        return;
+
+      edm::LogVerbatim log(module);
+      log << module << ": " << repeat_ << " runs per builder (ms: mean, rms, min; bytes)";
+
+      for ( std::vector<Result>::const_iterator ri = results_.begin(), riEnd = results_.end();
+            ri != riEnd; ++ri )
+      {
+        double sum = 0.0, sum2 = 0.0;
+
+        for ( std::vector<double>::const_iterator ti = ri->times.begin(), tiEnd = ri->times.end();
+              ti != tiEnd; ++ti )
+        {
+          sum += *ti;
+          sum2 += (*ti)*(*ti);
+        }
+
+        double n = ri->times.size();
+        double mean = sum/n;
+        double rms = std::sqrt(std::max(0.0, sum2/n - mean*mean));
+        double min = *std::min_element(ri->times.begin(), ri->times.end());
+
+        log << "\n  " << ri->name << ": " << 1e3*mean << " " << 1e3*rms << " " << 1e3*min
+            << "; " << ri->bytes;
+      }
+    }
+
+private:
+  struct Result
+  {
+    std::string name;
+    std::vector<double> times;
+    size_t bytes;
+  };
+
+  unsigned int repeat_;
+  std::vector<Result> results_;
+};
+
+#endif // ANALYZER_ISPY_BUILD_TIMER_H
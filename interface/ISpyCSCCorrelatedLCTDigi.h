@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_CSCCORRELATEDCLCTDIGI_H
 #define ANALYZER_ISPY_CSCCORRELATEDLCTDIGI_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/CSCDigi/interface/CSCCorrelatedLCTDigiCollection.h"
 
-class ISpyCSCCorrelatedLCTDigi : public edm::EDAnalyzer
+class ISpyCSCCorrelatedLCTDigi : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyCSCCorrelatedLCTDigi(const edm::ParameterSet&);
   virtual ~ISpyCSCCorrelatedLCTDigi(void){}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag		inputTag_;
   edm::EDGetTokenT<CSCCorrelatedLCTDigiCollection> digiToken_;
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_CSCRECHIT2D_H
 #define ANALYZER_ISPY_CSCRECHIT2D_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/CSCRecHit/interface/CSCRecHit2DCollection.h"
 
-class ISpyCSCRecHit2D : public edm::EDAnalyzer
+class ISpyCSCRecHit2D : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyCSCRecHit2D(const edm::ParameterSet&);
   virtual ~ISpyCSCRecHit2D(void){}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<CSCRecHit2DCollection> rechitToken_;
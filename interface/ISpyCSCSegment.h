@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_CSC_SEGMENT_H
 #define ANALYZER_ISPY_CSC_SEGMENT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/CSCRecHit/interface/CSCSegmentCollection.h"
 
-class ISpyCSCSegment : public edm::EDAnalyzer
+class ISpyCSCSegment : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyCSCSegment (const edm::ParameterSet&);
   virtual ~ISpyCSCSegment (void) {}
   
-  virtual void analyze (const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 
 private:
   edm::InputTag	inputTag_;
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_CSCSTRIPDIGI_H
 #define ANALYZER_ISPY_CSCSTRIPDIGI_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/CSCDigi/interface/CSCStripDigiCollection.h"
 
-class ISpyCSCStripDigi : public edm::EDAnalyzer
+class ISpyCSCStripDigi : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyCSCStripDigi(const edm::ParameterSet&);
   virtual ~ISpyCSCStripDigi(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag 		inputTag_;
   int 				thresholdOffset_;
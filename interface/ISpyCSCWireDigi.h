@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_CSCWIREDIGI_H
 #define ANALYZER_ISPY_CSCWIREDIGI_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/CSCDigi/interface/CSCWireDigiCollection.h"
 
-class ISpyCSCWireDigi : public edm::EDAnalyzer
+class ISpyCSCWireDigi : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyCSCWireDigi(const edm::ParameterSet&);
   virtual ~ISpyCSCWireDigi(void){}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag		inputTag_;
   edm::EDGetTokenT<CSCWireDigiCollection> digiToken_;
@@ -1,21 +1,23 @@
 #ifndef ANALYZER_ISPY_CALO_CLUSTER_H
 #define ANALYZER_ISPY_CALO_CLUSTER_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/EgammaReco/interface/BasicClusterFwd.h"
 #include "DataFormats/CaloRecHit/interface/CaloCluster.h"
 
-class ISpyCaloCluster : public edm::EDAnalyzer
+class ISpyCaloCluster : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyCaloCluster(const edm::ParameterSet&);
   virtual ~ISpyCaloCluster(){}
 
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 
 private:
-  const std::string algoName(reco::CaloCluster::AlgoId key);
+  const std::string algoName(reco::CaloCluster::AlgoId key) const;
   edm::InputTag	inputTag_;
+  edm::EDGetTokenT<reco::BasicClusterCollection> clusterToken_;
 };
 
 #endif
@@ -1,11 +1,12 @@
 #ifndef ANALYZER_ISPY_CALO_GEOMETRY_H
 #define ANALYZER_ISPY_CALO_GEOMETRY_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Framework/interface/ESHandle.h"
-#include "FWCore/Framework/interface/ESWatcher.h"
+#include "ISpy/Analyzers/interface/ISpyBuildTimer.h"
 #include "DataFormats/DetId/interface/DetId.h"
 #include "DataFormats/HcalDetId/interface/HcalSubdetector.h"
+#include <mutex>
 #include <string>
 
 class GeomDet;
@@ -13,35 +14,37 @@ class SbVec3f;
 class CaloGeometry;
 class IgDataStorage;
 class IgCollectionItem;
-class CaloGeometryRecord;
 
-class ISpyCaloGeometry : public edm::EDAnalyzer
+class ISpyCaloGeometry : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyCaloGeometry(const edm::ParameterSet&);
   virtual ~ISpyCaloGeometry(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+  void endJob(void) override;
 
 private:
 
-  void	buildCalo3D (IgDataStorage *);
-  void	buildCaloRPhi (IgDataStorage *);
-  void	buildCaloRZ (IgDataStorage *);
+  void	buildCalo3D (IgDataStorage *) const;
+  void	buildCaloRPhi (IgDataStorage *) const;
+  void	buildCaloRZ (IgDataStorage *) const;
 
-  void	build3D (IgDataStorage *, const std::string&, DetId::Detector, int);
-  void buildEndcap3D(IgDataStorage *, const std::string&, DetId::Detector, int, int); 
+  void	build3D (IgDataStorage *, const std::string&, DetId::Detector, int) const;
+  void buildEndcap3D(IgDataStorage *, const std::string&, DetId::Detector, int, int) const; 
   
-  void	buildRPhi (IgDataStorage *, const std::string&, DetId::Detector, int, double);
-  void	buildRZ (IgDataStorage *, const std::string&, DetId::Detector, int, double, double);
-
-  const std::string subDetName (HcalSubdetector key);
-  const std::string otherSubDetName (HcalOtherSubdetector key);
-
-  bool caloGeomChanged_;
-
-  edm::ESHandle<CaloGeometry> caloGeom_;
-  edm::ESWatcher<CaloGeometryRecord> watch_caloGeom_;
+  void	buildRPhi (IgDataStorage *, const std::string&, DetId::Detector, int, double) const;
+  void	buildRZ (IgDataStorage *, const std::string&, DetId::Detector, int, double, double) const;
+
+  const std::string subDetName (HcalSubdetector key) const;
+  const std::string otherSubDetName (HcalOtherSubdetector key) const;
+
+  // The geometry is written once per IOV of the CaloGeometryRecord,
+  // by whichever stream sees it first.
+  mutable std::mutex mutex_; // Guards the members below
+  mutable unsigned long long cacheIdentifier_;
+  mutable ISpyBuildTimer timer_;
+  mutable edm::ESHandle<CaloGeometry> caloGeom_;
 
 };
 
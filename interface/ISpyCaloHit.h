@@ -1,21 +1,23 @@
 #ifndef ANALYZER_ISPY_CALOHIT_H
 #define ANALYZER_ISPY_CALOHIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "SimDataFormats/CaloHit/interface/PCaloHitContainer.h"
 
 typedef std::vector<edm::InputTag> VInputTag;
 
-class ISpyCaloHit : public edm::EDAnalyzer
+class ISpyCaloHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyCaloHit(const edm::ParameterSet&);
   virtual ~ISpyCaloHit(void){}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   VInputTag	inputTags_;
+  std::vector<edm::EDGetTokenT<PCaloHitContainer> > hitTokens_;
 };
 
 #endif // ANALYZER_ISPY_CALOHIT_H
@@ -1,16 +1,16 @@
 #ifndef ANALYZER_ISPY_CALOMET_H
 #define ANALYZER_ISPY_CALOMET_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/METReco/interface/CaloMETCollection.h"
 
-class ISpyCaloMET : public edm::EDAnalyzer
+class ISpyCaloMET : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyCaloMET(const edm::ParameterSet&);
     virtual ~ISpyCaloMET(void){}
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
     edm::InputTag inputTag_;
     edm::EDGetTokenT<reco::CaloMETCollection> metToken_;
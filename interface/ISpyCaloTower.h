@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_CALO_TOWER_H
 #define ANALYZER_ISPY_CALO_TOWER_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/CaloTowers/interface/CaloTowerCollection.h"
 
-class ISpyCaloTower : public edm::EDAnalyzer
+class ISpyCaloTower : public edm::global::EDAnalyzer<>
 {
 
 public:
   explicit ISpyCaloTower(const edm::ParameterSet&);
   virtual ~ISpyCaloTower(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 
 private:
   edm::InputTag	inputTag_;
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_DTDIGI_H
 #define ANALYZER_ISPY_DTDIGI_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/DTDigi/interface/DTDigiCollection.h"
 
-class ISpyDTDigi : public edm::EDAnalyzer
+class ISpyDTDigi : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyDTDigi(const edm::ParameterSet&);
   virtual ~ISpyDTDigi(void){}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<DTDigiCollection> digiToken_;
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_DTRECHIT_H
 #define ANALYZER_ISPY_DTRECHIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/DTRecHit/interface/DTRecHitCollection.h"
 
-class ISpyDTRecHit : public edm::EDAnalyzer
+class ISpyDTRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyDTRecHit(const edm::ParameterSet&);
   virtual ~ISpyDTRecHit(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<DTRecHitCollection> rechitToken_;
@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_EBDIGI_H
 #define ANALYZER_ISPY_EBDIGI_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
 #include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
 
-class ISpyEBDigi : public edm::EDAnalyzer
+class ISpyEBDigi : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyEBDigi(const edm::ParameterSet&);
   virtual ~ISpyEBDigi(void){}
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputDigiTag_;
   edm::InputTag inputRecHitTag_;
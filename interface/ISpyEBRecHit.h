@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_EB_REC_HIT_H
 #define ANALYZER_ISPY_EB_REC_HIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
 
-class ISpyEBRecHit : public edm::EDAnalyzer
+class ISpyEBRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyEBRecHit(const edm::ParameterSet&);
   virtual ~ISpyEBRecHit(void) {}
 
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<EcalRecHitCollection> rechitToken_;
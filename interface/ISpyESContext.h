@@ -0,0 +1,86 @@
+#ifndef ANALYZER_ISPY_ES_CONTEXT_H
+#define ANALYZER_ISPY_ES_CONTEXT_H
+
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+
+class CaloGeometry;
+class CaloGeometryRecord;
+class CSCGeometry;
+class DTGeometry;
+class GEMGeometry;
+class GlobalTrackingGeometry;
+class GlobalTrackingGeometryRecord;
+class IdealMagneticFieldRecord;
+class ISpyMuonChamberCache;
+class MagneticField;
+class MuonGeometryRecord;
+class RPCGeometry;
+
+namespace edm {
+  class EventSetup;
+}
+
+// The EventSetup products most ISpy analyzers need, one per stream in
+// ISpyService (see ISpyService::esContext). Each record is looked up
+// on first use in an event and its products are only fetched again
+// when its ESWatcher sees a new IOV, so all the analyzers of an event
+// share one lookup. A record that is not used is never asked for.
+//
+// The accessors return 0 if the product is not valid. Like the event
+// storage, a context is only used by the analyzers of its stream,
+// which run one after the other on the ISpy path.
+
+class ISpyESContext
+{
+public:
+  explicit ISpyESContext(ISpyMuonChamberCache& muonChamberCache);
+
+  // Called by the service for every event
+  void				reset(const edm::EventSetup* eventSetup);
+
+  const CaloGeometry *		caloGeometry(void);
+  const GlobalTrackingGeometry *	globalTrackingGeometry(void);
+  const MagneticField *		magneticField(void);
+
+  const DTGeometry *		dtGeometry(void);
+  const CSCGeometry *		cscGeometry(void);
+  const GEMGeometry *		gemGeometry(void);
+  const RPCGeometry *		rpcGeometry(void);
+  unsigned long long		muonGeometryCacheIdentifier(void);
+
+  // Corners of the muon chambers, shared by all streams
+  ISpyMuonChamberCache &	muonChamberCache(void) { return muonChamberCache_; }
+
+private:
+  void				updateCalo(void);
+  void				updateTracking(void);
+  void				updateField(void);
+  void				updateMuon(void);
+
+  const edm::EventSetup *	eventSetup_;
+
+  bool				caloChecked_;
+  edm::ESWatcher<CaloGeometryRecord> caloWatcher_;
+  edm::ESHandle<CaloGeometry>	caloGeometry_;
+
+  bool				trackingChecked_;
+  edm::ESWatcher<GlobalTrackingGeometryRecord> trackingWatcher_;
+  edm::ESHandle<GlobalTrackingGeometry> globalTrackingGeometry_;
+
+  bool				fieldChecked_;
+  edm::ESWatcher<IdealMagneticFieldRecord> fieldWatcher_;
+  edm::ESHandle<MagneticField>	magneticField_;
+
+  bool				muonChecked_;
+  edm::ESWatcher<MuonGeometryRecord> muonWatcher_;
+  edm::ESHandle<DTGeometry>	dtGeometry_;
+  edm::ESHandle<CSCGeometry>	cscGeometry_;
+  edm::ESHandle<GEMGeometry>	gemGeometry_;
+  edm::ESHandle<RPCGeometry>	rpcGeometry_;
+  unsigned long long		muonCacheIdentifier_;
+
+  ISpyMuonChamberCache &	muonChamberCache_;
+};
+
+#endif // ANALYZER_ISPY_ES_CONTEXT_H
@@ -0,0 +1,138 @@
+#ifndef ANALYZER_ISPY_ECAL_DIGI_H
+#define ANALYZER_ISPY_ECAL_DIGI_H
+
+#include "DataFormats/DetId/interface/DetId.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+#include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
+#include "Geometry/CaloGeometry/interface/CaloCellGeometry.h"
+#include "Geometry/CaloGeometry/interface/CaloGeometry.h"
+#include "ISpy/Services/interface/IgCollection.h"
+#include <algorithm>
+#include <cassert>
+
+// The EB and EE digis (EBDigis_V1, EEDigis_V1) with the energy and
+// time of their rechit, for ISpyEBDigi and ISpyEEDigi.
+//
+// The rechits are an edm::SortedCollection, sorted by DetId, and the
+// digis come out of the unpacker sorted too, so the rechit of each
+// digi is found in one merge-join pass. Should a digi come out of
+// order, it and the rest are looked up with find().
+
+class ISpyEcalDigi
+{
+public:
+  // C is EBDigiCollection or EEDigiCollection
+  template <class C>
+  static void write(IgCollection& digis, const C& digiCollection,
+                    const EcalRecHitCollection& recHits, const CaloGeometry* geom)
+    {
+      IgProperty E     = digis.addProperty("energy", 0.0);
+      IgProperty ETA   = digis.addProperty("eta",    0.0);
+      IgProperty PHI   = digis.addProperty("phi",    0.0);
+      IgProperty TIME  = digis.addProperty("time",   0.0);
+      IgProperty DETID = digis.addProperty("detid",  int(0));
+
+      // The samples stay adc0 to adc9 as the ig format has no array
+      // property and the viewer reads them by name
+      const unsigned int nSamples = 10;
+      IgProperty ADC[nSamples] = {
+        digis.addProperty("adc0", int(0)), digis.addProperty("adc1", int(0)),
+        digis.addProperty("adc2", int(0)), digis.addProperty("adc3", int(0)),
+        digis.addProperty("adc4", int(0)), digis.addProperty("adc5", int(0)),
+        digis.addProperty("adc6", int(0)), digis.addProperty("adc7", int(0)),
+        digis.addProperty("adc8", int(0)), digis.addProperty("adc9", int(0))
+      };
+
+      IgProperty FRONT_1 = digis.addProperty("front_1", IgV3d());
+      IgProperty FRONT_2 = digis.addProperty("front_2", IgV3d());
+      IgProperty FRONT_3 = digis.addProperty("front_3", IgV3d());
+      IgProperty FRONT_4 = digis.addProperty("front_4", IgV3d());
+      IgProperty BACK_1  = digis.addProperty("back_1",  IgV3d());
+      IgProperty BACK_2  = digis.addProperty("back_2",  IgV3d());
+      IgProperty BACK_3  = digis.addProperty("back_3",  IgV3d());
+      IgProperty BACK_4  = digis.addProperty("back_4",  IgV3d());
+
+      RecHits join(recHits);
+
+      for ( typename C::const_iterator di = digiCollection.begin(), diEnd = digiCollection.end();
+            di != diEnd; ++di )
+      {
+        IgCollectionItem d = digis.create();
+
+        auto cell = geom->getGeometry((*di).id());
+        const CaloCellGeometry::CornersVec& corners = cell->getCorners();
+        const GlobalPoint& pos = cell->getPosition();
+
+        EcalRecHitCollection::const_iterator recHit = join.find(DetId((*di).id()));
+
+        // Digis without a rechit are kept, with no energy or time
+        d[E] = recHit != recHits.end() ? static_cast<double>(recHit->energy()) : 0.0;
+        d[ETA] = static_cast<double>(pos.eta());
+        d[PHI] = static_cast<double>(pos.phi());
+        d[TIME] = recHit != recHits.end() ? static_cast<double>(recHit->time()) : 0.0;
+        d[DETID] = static_cast<int>((*di).id());
+
+        typename C::Digi df(*di);
+        for ( unsigned int i = 0, n = std::min(nSamples, static_cast<unsigned int>(df.size())); i != n; ++i )
+          d[ADC[i]] = df.sample(i).adc();
+
+        assert(corners.size() == 8);
+
+        d[FRONT_1] = corner(corners[3]);
+        d[FRONT_2] = corner(corners[2]);
+        d[FRONT_3] = corner(corners[1]);
+        d[FRONT_4] = corner(corners[0]);
+
+        d[BACK_1] = corner(corners[7]);
+        d[BACK_2] = corner(corners[6]);
+        d[BACK_3] = corner(corners[5]);
+        d[BACK_4] = corner(corners[4]);
+      }
+    }
+
+private:
+  // The merge-join, falling back to find() once an id is lower than
+  // the one before
+  class RecHits
+  {
+  public:
+    explicit RecHits(const EcalRecHitCollection& recHits)
+      : recHits_(recHits),
+        rh_(recHits.begin()),
+        sorted_(true),
+        lastId_(0)
+      {}
+
+    EcalRecHitCollection::const_iterator find(DetId id)
+      {
+        if ( id.rawId() < lastId_ )
+          sorted_ = false;
+        lastId_ = id.rawId();
+
+        if ( ! sorted_ )
+          return recHits_.find(id);
+
+        EcalRecHitCollection::const_iterator rhEnd = recHits_.end();
+
+        while ( rh_ != rhEnd && rh_->id().rawId() < id.rawId() )
+          ++rh_;
+
+        return ( rh_ != rhEnd && rh_->id() == id ) ? rh_ : rhEnd;
+      }
+
+  private:
+    const EcalRecHitCollection& recHits_;
+    EcalRecHitCollection::const_iterator rh_;
+    bool sorted_;
+    uint32_t lastId_;
+  };
+
+  static IgV3d corner(const GlobalPoint& p)
+    {
+      return IgV3d(static_cast<double>(p.x()/100.0),
+                   static_cast<double>(p.y()/100.0),
+                   static_cast<double>(p.z()/100.0));
+    }
+};
+
+#endif // ANALYZER_ISPY_ECAL_DIGI_H
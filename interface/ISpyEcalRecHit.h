@@ -1,20 +1,22 @@
 #ifndef ANALYZER_ISPY_ECAL_REC_HIT_H
 #define ANALYZER_ISPY_ECAL_REC_HIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/EcalRecHit/interface/EcalRecHitCollections.h"
 
 typedef std::vector<edm::InputTag> VInputTag;
 
-class ISpyEcalRecHit : public edm::EDAnalyzer
+class ISpyEcalRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyEcalRecHit(const edm::ParameterSet&);
   virtual ~ISpyEcalRecHit(void) {}
 
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   VInputTag	inputTags_;
+  std::vector<edm::EDGetTokenT<EcalRecHitCollection> > rechitTokens_;
 };
 
 #endif // ANALYZER_ISPY_ECAL_REC_HIT_H
@@ -1,18 +1,20 @@
 #ifndef ANALYZER_ISPY_ELECTRON_H
 #define ANALYZER_ISPY_ELECTRON_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/EgammaCandidates/interface/ElectronFwd.h"
 
-class ISpyElectron : public edm::EDAnalyzer
+class ISpyElectron : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyElectron(const edm::ParameterSet&);
     virtual ~ISpyElectron(void) {}
   
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
     edm::InputTag inputTag_;
+    edm::EDGetTokenT<reco::ElectronCollection> electronToken_;
 };
 
 #endif // ANALYZER_ISPY_ELECTRON_H
@@ -1,15 +1,15 @@
 #ifndef ANALYZER_ISPY_EVENT_H
 # define ANALYZER_ISPY_EVENT_H
 
-# include "FWCore/Framework/interface/EDAnalyzer.h"
+# include "FWCore/Framework/interface/global/EDAnalyzer.h"
 
-class ISpyEvent : public edm::EDAnalyzer
+class ISpyEvent : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyEvent(const edm::ParameterSet&);
   virtual ~ISpyEvent(void) {}
 
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 };
 
 #endif // ANALYZER_ISPY_EVENT_H
@@ -1,16 +1,18 @@
 #ifndef ANALYZER_ISPY_EVENTFEATURES_H
 #define ANALYZER_ISPY_EVENTFEATURES_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
 
-class ISpyEventFeatures : public edm::EDAnalyzer
+class ISpyEventFeatures : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyEventFeatures(const edm::ParameterSet&);
     virtual ~ISpyEventFeatures(void){}
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
     edm::InputTag inputTag_;
+    edm::EDGetTokenT<reco::TrackCollection> trackToken_;
 };
 #endif // ANALYZER_ISPY_EVENTFEATURES_H
@@ -0,0 +1,38 @@
+#ifndef ANALYZER_ISPY_EVENT_SCORE_H
+#define ANALYZER_ISPY_EVENT_SCORE_H
+
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Candidate/interface/Candidate.h"
+#include "DataFormats/Common/interface/View.h"
+#include <vector>
+
+/*
+  Scores the event for the top-N mode of the ISpyService (topEvents):
+  the score is the sum over the configured terms of weight times
+  either the number of objects above minPt or their scalar pT sum,
+  e.g. the sum of lepton pT or the number of jets.
+*/
+
+class ISpyEventScore : public edm::global::EDAnalyzer<>
+{
+public:
+  explicit ISpyEventScore(const edm::ParameterSet&);
+  virtual ~ISpyEventScore(void) {}
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  struct Term
+  {
+    edm::InputTag tag;
+    edm::EDGetTokenT<edm::View<reco::Candidate> > token;
+    bool sumPt;
+    double minPt;
+    double weight;
+  };
+
+  std::vector<Term> terms_;
+};
+
+#endif // ANALYZER_ISPY_EVENT_SCORE_H
@@ -0,0 +1,53 @@
+#ifndef ANALYZER_ISPY_EVENT_SELECTOR_H
+#define ANALYZER_ISPY_EVENT_SELECTOR_H
+
+#include "FWCore/Framework/interface/global/EDFilter.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Candidate/interface/Candidate.h"
+#include "DataFormats/Common/interface/TriggerResults.h"
+#include "DataFormats/Common/interface/View.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+  Put in front of the ISpy analyzers in a path so that only the
+  selected events are processed and written. The criteria are checked
+  from the cheapest up and all of those configured must pass:
+  the run:event list, the HLT paths (any of them), and then the
+  minimum number of objects above a pT threshold for each object
+  collection (MET is a collection of one).
+*/
+
+class ISpyEventSelector : public edm::global::EDFilter<>
+{
+public:
+  explicit ISpyEventSelector(const edm::ParameterSet&);
+  virtual ~ISpyEventSelector(void) {}
+
+  bool filter(edm::StreamID, edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  struct ObjectCut
+  {
+    edm::InputTag tag;
+    edm::EDGetTokenT<edm::View<reco::Candidate> > token;
+    unsigned int minNumber;
+    double minPt;
+  };
+
+  bool passEventList(const edm::Event&) const;
+  bool passTrigger(const edm::Event&) const;
+  bool passObjects(const edm::Event&) const;
+
+  // run, event; sorted
+  std::vector<std::pair<unsigned int, unsigned long long> > events_;
+
+  edm::InputTag triggerResultsTag_;
+  edm::EDGetTokenT<edm::TriggerResults> triggerResultsToken_;
+  std::vector<std::string> triggerPaths_;
+
+  std::vector<ObjectCut> objects_;
+};
+
+#endif // ANALYZER_ISPY_EVENT_SELECTOR_H
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_FORWARDPROTON_H
 #define ANALYZER_ISPY_FORWARDPROTON_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/ProtonReco/interface/ForwardProtonFwd.h"
 
-class ISpyForwardProton : public edm::EDAnalyzer
+class ISpyForwardProton : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyForwardProton(const edm::ParameterSet&);
   virtual ~ISpyForwardProton(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<reco::ForwardProtonCollection> protonToken_;
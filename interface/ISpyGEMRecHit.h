@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_GEMRECHIT_H
 #define ANALYZER_ISPY_GEMRECHIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/GEMRecHit/interface/GEMRecHitCollection.h"
 
-class ISpyGEMRecHit : public edm::EDAnalyzer
+class ISpyGEMRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyGEMRecHit(const edm::ParameterSet&);
   virtual ~ISpyGEMRecHit(void){}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<GEMRecHitCollection> rechitToken_;
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_GEM_SEGMENT_H
 #define ANALYZER_ISPY_GEM_SEGMENT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/GEMRecHit/interface/GEMSegmentCollection.h"
 
-class ISpyGEMSegment : public edm::EDAnalyzer
+class ISpyGEMSegment : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyGEMSegment (const edm::ParameterSet&);
   virtual ~ISpyGEMSegment (void) {}
   
-  virtual void analyze (const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 
 private:
   edm::InputTag	inputTag_;
@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_GENJET_H
 # define ANALYZER_ISPY_GENJET_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/JetReco/interface/GenJetCollection.h"
 
-class ISpyGenJet : public edm::EDAnalyzer
+class ISpyGenJet : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyGenJet(const edm::ParameterSet&);
   virtual ~ISpyGenJet(void) {}
  
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   double 	energyCut_;
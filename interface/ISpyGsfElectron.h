@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_GSFELECTRON_H
 #define ANALYZER_ISPY_GSFELECTRON_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/EgammaCandidates/interface/GsfElectronFwd.h"
 
-class ISpyGsfElectron : public edm::EDAnalyzer
+class ISpyGsfElectron : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyGsfElectron(const edm::ParameterSet&);
   virtual ~ISpyGsfElectron(){}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<reco::GsfElectronCollection> electronToken_;
@@ -1,18 +1,20 @@
 #ifndef ANALYZER_ISPY_GSFPFRECTRACK_H
 #define ANALYZER_ISPY_GSFPFRECTRACK_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/ParticleFlowReco/interface/GsfPFRecTrackFwd.h"
 
-class ISpyGsfPFRecTrack : public edm::EDAnalyzer
+class ISpyGsfPFRecTrack : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyGsfPFRecTrack(const edm::ParameterSet&);
   virtual ~ISpyGsfPFRecTrack(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
+  edm::EDGetTokenT<reco::GsfPFRecTrackCollection> trackToken_;
 };
 
 #endif // ANALYZER_ISPY_GSFPFRECTRACK_H
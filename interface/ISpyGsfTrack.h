@@ -1,18 +1,20 @@
 #ifndef ANALYZER_ISPY_GSFTRACK_H
 #define ANALYZER_ISPY_GSFTRACK_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/GsfTrackReco/interface/GsfTrackFwd.h"
 
-class ISpyGsfTrack : public edm::EDAnalyzer
+class ISpyGsfTrack : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyGsfTrack(const edm::ParameterSet&);
   virtual ~ISpyGsfTrack(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
+  edm::EDGetTokenT<reco::GsfTrackCollection> trackToken_;
 };
 
 #endif // ANALYZER_ISPY_GSFTRACK_H
@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_HBREC_HIT_H
 #define ANALYZER_ISPY_HBREC_HIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/HcalRecHit/interface/HcalRecHitCollections.h"
 
-class ISpyHBRecHit : public edm::EDAnalyzer
+class ISpyHBRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyHBRecHit(const edm::ParameterSet&);
   virtual ~ISpyHBRecHit(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   edm::EDGetTokenT<HBHERecHitCollection> rechitToken_;
@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_HEREC_HIT_H
 #define ANALYZER_ISPY_HEREC_HIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/HcalRecHit/interface/HcalRecHitCollections.h"
 
-class ISpyHERecHit : public edm::EDAnalyzer
+class ISpyHERecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyHERecHit(const edm::ParameterSet&);
   virtual ~ISpyHERecHit(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   edm::EDGetTokenT<HBHERecHitCollection> rechitToken_;
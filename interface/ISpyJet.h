@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_JET_H
 # define ANALYZER_ISPY_JET_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/JetReco/interface/CaloJetCollection.h"
 
-class ISpyJet : public edm::EDAnalyzer
+class ISpyJet : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyJet(const edm::ParameterSet&);
   virtual ~ISpyJet(void) {}
  
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   double 	energyCut_;
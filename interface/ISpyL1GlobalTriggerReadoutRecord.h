@@ -1,17 +1,39 @@
 #ifndef ANALYZER_ISPY_L1_GLOBAL_TRIGGER_READOUT_RECORD_H
 #define ANALYZER_ISPY_L1_GLOBAL_TRIGGER_READOUT_RECORD_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
-class ISpyL1GlobalTriggerReadoutRecord : public edm::EDAnalyzer
+class L1GlobalTriggerReadoutRecord;
+
+class ISpyL1GlobalTriggerReadoutRecord : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyL1GlobalTriggerReadoutRecord(const edm::ParameterSet&);
   virtual ~ISpyL1GlobalTriggerReadoutRecord(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
+  // Algorithm names and bits of the menu, in the order of its
+  // AlgorithmMap (by name). Rebuilt when the L1GtTriggerMenuRcd
+  // IOV changes.
+  struct Menu
+  {
+    unsigned long long cacheIdentifier;
+    std::vector<std::string> names;
+    std::vector<int> bits;
+  };
+
   edm::InputTag inputTag_;
+  edm::EDGetTokenT<L1GlobalTriggerReadoutRecord> triggerRecordToken_;
+  bool algorithmDictionary_;
+
+  mutable std::shared_ptr<const Menu> menu_;
+  mutable unsigned int dictionaryRun_; // last run the names were written for
+  mutable std::mutex mutex_; // Guards the two above
 };
 #endif // ANALYZER_ISPY_L1_GLOBAL_TRIGGER_READOUT_RECORD_H
@@ -1,18 +1,53 @@
 #ifndef ANALYZER_ISPY_LOCAL_POSITION_H
 # define ANALYZER_ISPY_LOCAL_POSITION_H
 
+#include "DataFormats/DetId/interface/DetId.h"
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
 #include "DataFormats/GeometryVector/interface/LocalPoint.h"
+#include <unordered_map>
+#include <vector>
 
+class GeomDet;
+class Topology;
 class TrackingRecHit;
 class TrackingGeometry;
 
+// Hit positions for tracks and rechit collections.
+//
+// The hit type is taken from the tracker rtti tag rather than found
+// by trying a dynamic_cast per concrete class, and the GeomDet and
+// topology of each DetId are looked up once per instance. Make one
+// instance per event (it is not meant to be shared between streams)
+// and use it for all the hits of all the tracks.
+
 class ISpyLocalPosition
 {
 public:
+  explicit ISpyLocalPosition(const TrackingGeometry * geometry);
+
   static LocalPoint 	localPosition(const TrackingRecHit * rechit, const TrackingGeometry * geometry);
 
-private:    
+  LocalPoint		localPosition(const TrackingRecHit * rechit);
+  GlobalPoint		globalPosition(const TrackingRecHit * rechit);
+  void			globalPositions(const std::vector<const TrackingRecHit *> & rechits,
+					std::vector<GlobalPoint> & points);
+  const GeomDet *	det(DetId detid) { return cached(detid).det; }
+
+private:
+  enum HitKind { PIXEL, STRIP, MATCHED, OTHER };
+
+  struct CachedDet
+  {
+    const GeomDet *	det;
+    const Topology *	topology;
+  };
+
+  static HitKind	hitKind(const TrackingRecHit * rechit);
+  LocalPoint		localPosition(const TrackingRecHit * rechit, HitKind kind);
+  const CachedDet &	cached(DetId detid);
 
+  const TrackingGeometry *			geometry_;
+  std::unordered_map<unsigned int, CachedDet>	dets_;
 };
 
 #endif // ANALYZER_ISPY_LOCAL_POSITION_H
@@ -0,0 +1,36 @@
+#ifndef ANALYZER_ISPY_LOCAL_POSITION_BENCHMARK_H
+#define ANALYZER_ISPY_LOCAL_POSITION_BENCHMARK_H
+
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
+
+/*
+  Times the hit positions of the tracks in a recorded collection
+  (it needs TrackExtras with rechits, i.e. RECO rather than AOD)
+  with the per-hit dynamic_cast lookup that ISpyTrack used to do and
+  with the batched ISpyLocalPosition, and reports both at endJob.
+  It writes nothing to the ISpyService.
+*/
+
+class ISpyLocalPositionBenchmark : public edm::one::EDAnalyzer<>
+{
+public:
+  explicit ISpyLocalPositionBenchmark(const edm::ParameterSet&);
+  virtual ~ISpyLocalPositionBenchmark(void) {}
+
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+  void endJob(void) override;
+
+private:
+  edm::InputTag inputTag_;
+  edm::EDGetTokenT<reco::TrackCollection> trackToken_;
+  int repeat_;
+
+  unsigned long long hits_;
+  unsigned long long mismatches_;
+  double legacyTime_;
+  double batchedTime_;
+};
+
+#endif // ANALYZER_ISPY_LOCAL_POSITION_BENCHMARK_H
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_MET_H
 # define ANALYZER_ISPY_MET_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/METReco/interface/METFwd.h"
 
-class ISpyMET : public edm::EDAnalyzer
+class ISpyMET : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyMET(const edm::ParameterSet&);
   virtual ~ISpyMET(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   edm::EDGetTokenT<reco::METCollection> metToken_;
@@ -1,7 +1,7 @@
 #ifndef ANALYZER_ISPY_MUON_H
 #define ANALYZER_ISPY_MUON_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 
@@ -20,35 +20,26 @@ class IgProperty;
 // NOTE: TM Should this eventually be made a class from which 
 // Reco, PAT, etc. muons should inherit?
 
-class ISpyMuon : public edm::EDAnalyzer
+class ISpyMuon : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyMuon(const edm::ParameterSet&);
   virtual ~ISpyMuon(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   
   double in_;
   double out_;
   double step_;    
+  double maxSagitta_; // cm, adaptive step if > 0
+  int maxFailed_; // failed propagations in a row before giving up
+  bool helixSegments_; // tracker tracks as HelixSegments_V1, see ISpyTrackRefitter
    
-  IgDataStorage* storage_;
-
-  edm::ESHandle<DTGeometry>  dtGeometry_;
-  bool dtGeomValid_;
-  edm::ESHandle<CSCGeometry> cscGeometry_;
-  bool cscGeomValid_;
-  edm::ESHandle<GEMGeometry> gemGeometry_;
-  bool gemGeomValid_;
-
-  void addChambers(reco::MuonCollection::const_iterator it);
-
   void addCaloEnergy(reco::MuonCollection::const_iterator it, 
                      IgCollectionItem& imuon,
-                     IgProperty& property);
-
+                     IgProperty& property) const;
 
   edm::EDGetTokenT<reco::MuonCollection> muonToken_;
 };
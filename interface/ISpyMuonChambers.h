@@ -0,0 +1,77 @@
+#ifndef ANALYZER_ISPY_MUON_CHAMBERS_H
+#define ANALYZER_ISPY_MUON_CHAMBERS_H
+
+#include "DataFormats/DetId/interface/DetId.h"
+#include "DataFormats/MuonReco/interface/MuonChamberMatch.h"
+#include "ISpy/Services/interface/IgCollection.h"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class CSCGeometry;
+class DTGeometry;
+class GEMGeometry;
+
+// Boxes of the muon chambers matched by the global muons, for
+// ISpyMuon and ISpyPATMuon.
+//
+// The corners of a chamber only depend on the geometry, so they are
+// computed once per MuonGeometryRecord IOV and kept in an
+// ISpyMuonChamberCache owned by the analyzer and shared by its
+// streams. Per event, each chamber is written once to
+// MuonChambers_V1 however many muons cross it, and every muon is
+// associated to its chambers.
+
+class ISpyMuonChamberCache
+{
+public:
+  // front_1..4 then back_1..4, in m
+  struct Corners
+  {
+    IgV3d p[8];
+  };
+
+  ISpyMuonChamberCache(void) : cacheIdentifier_(0) {}
+
+  // False if there is no geometry for the subdetector of id.
+  bool corners(DetId id,
+               unsigned long long cacheIdentifier,
+               const DTGeometry* dtGeometry,
+               const CSCGeometry* cscGeometry,
+               const GEMGeometry* gemGeometry,
+               Corners& c);
+
+private:
+  std::mutex mutex_; // Guards the two below
+  unsigned long long cacheIdentifier_;
+  std::unordered_map<unsigned int, Corners> corners_;
+};
+
+class ISpyMuonChambers
+{
+public:
+  // Make one per event, cacheIdentifier being that of the
+  // MuonGeometryRecord the geometries come from.
+  ISpyMuonChambers(IgDataStorage* storage,
+                   const char* associations,
+                   ISpyMuonChamberCache& cache,
+                   unsigned long long cacheIdentifier,
+                   const DTGeometry* dtGeometry,
+                   const CSCGeometry* cscGeometry,
+                   const GEMGeometry* gemGeometry);
+
+  void add(IgCollectionItem& muon, const std::vector<reco::MuonChamberMatch>& matches);
+
+private:
+  IgCollection&		chambers_;
+  std::vector<IgProperty> properties_; // detid, front_1..4, back_1..4
+  IgAssociations&	associations_;
+  ISpyMuonChamberCache&	cache_;
+  unsigned long long	cacheIdentifier_;
+  const DTGeometry*	dtGeometry_;
+  const CSCGeometry*	cscGeometry_;
+  const GEMGeometry*	gemGeometry_;
+  std::unordered_map<unsigned int, IgCollectionItem> written_; // by raw DetId
+};
+
+#endif // ANALYZER_ISPY_MUON_CHAMBERS_H
@@ -1,10 +1,11 @@
 #ifndef ANALYZER_ISPY_MUON_GEOMETRY_H
 #define ANALYZER_ISPY_MUON_GEOMETRY_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Framework/interface/ESHandle.h"
-#include "FWCore/Framework/interface/ESWatcher.h"
+#include "ISpy/Analyzers/interface/ISpyBuildTimer.h"
 #include "DataFormats/DetId/interface/DetId.h"
+#include <mutex>
 #include <string>
 
 class GeomDet;
@@ -16,42 +17,44 @@ class RPCGeometry;
 class GEMGeometry;
 class IgDataStorage;
 class IgCollectionItem;
-class MuonGeometryRecord;
 
-class ISpyMuonGeometry : public edm::EDAnalyzer
+class ISpyMuonGeometry : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyMuonGeometry(const edm::ParameterSet&);
   virtual ~ISpyMuonGeometry(void) {}
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+  void endJob(void) override;
 
 private:
-  void buildDriftTubes3D(IgDataStorage *);
-  void buildDriftTubesRPhi(IgDataStorage *);
-  void buildDriftTubesRZ(IgDataStorage *);
-
-  void 	buildCSC3D(IgDataStorage *, const std::string&, int);
-  void 	buildCSCRZ(IgDataStorage *);
-
-  void	buildRPC3D(IgDataStorage *);
-  void	buildRPCBarrel3D(IgDataStorage *);
-  void	buildRPCPlusEndcap3D(IgDataStorage *);
-  void	buildRPCMinusEndcap3D(IgDataStorage *);
-  void	buildRPCRPhi(IgDataStorage *);
-  void	buildRPCRZ(IgDataStorage *);
-
-  void 	buildGEM3D(IgDataStorage *, const std::string&, int);
-  void	buildGEMRZ(IgDataStorage *);
-
-  void	addCorners(IgCollectionItem&, const GeomDet *);
-
-  bool muonGeomChanged_;
-
-  edm::ESHandle<CSCGeometry> cscGeom_;
-  edm::ESHandle<DTGeometry> dtGeom_;
-  edm::ESHandle<RPCGeometry> rpcGeom_;
-  edm::ESHandle<GEMGeometry> gemGeom_;
-  edm::ESWatcher<MuonGeometryRecord> watch_muonGeom_;
+  void buildDriftTubes3D(IgDataStorage *) const;
+  void buildDriftTubesRPhi(IgDataStorage *) const;
+  void buildDriftTubesRZ(IgDataStorage *) const;
+
+  void 	buildCSC3D(IgDataStorage *, const std::string&, int) const;
+  void 	buildCSCRZ(IgDataStorage *) const;
+
+  void	buildRPC3D(IgDataStorage *) const;
+  void	buildRPCBarrel3D(IgDataStorage *) const;
+  void	buildRPCPlusEndcap3D(IgDataStorage *) const;
+  void	buildRPCMinusEndcap3D(IgDataStorage *) const;
+  void	buildRPCRPhi(IgDataStorage *) const;
+  void	buildRPCRZ(IgDataStorage *) const;
+
+  void 	buildGEM3D(IgDataStorage *, const std::string&, int) const;
+  void	buildGEMRZ(IgDataStorage *) const;
+
+  void	addCorners(IgCollectionItem&, const GeomDet *) const;
+
+  // The geometry is written once per IOV of the MuonGeometryRecord,
+  // by whichever stream sees it first.
+  mutable std::mutex mutex_; // Guards the members below
+  mutable unsigned long long cacheIdentifier_;
+  mutable ISpyBuildTimer timer_;
+  mutable edm::ESHandle<CSCGeometry> cscGeom_;
+  mutable edm::ESHandle<DTGeometry> dtGeom_;
+  mutable edm::ESHandle<RPCGeometry> rpcGeom_;
+  mutable edm::ESHandle<GEMGeometry> gemGeom_;
 
 };
 
@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_PATELECTRON_H
 #define ANALYZER_ISPY_PATELECTRON_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/PatCandidates/interface/Electron.h"
 
-class ISpyPATElectron : public edm::EDAnalyzer
+class ISpyPATElectron : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPATElectron(const edm::ParameterSet&);
   virtual ~ISpyPATElectron(void){}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   bool isAOD_;
@@ -1,16 +1,16 @@
 #ifndef ANALYZER_ISPY_PATJET_H
 #define ANALYZER_ISPY_PATJET_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/PatCandidates/interface/Jet.h"
 
-class ISpyPATJet : public edm::EDAnalyzer
+class ISpyPATJet : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPATJet(const edm::ParameterSet&);
   virtual ~ISpyPATJet(void){}
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<std::vector<pat::Jet> > jetToken_;
@@ -1,31 +1,32 @@
 #ifndef ANALYZER_ISPY_PATMUON_H
 #define ANALYZER_ISPY_PATMUON_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 
 #include "DataFormats/PatCandidates/interface/Muon.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
 
 #include "Geometry/DTGeometry/interface/DTGeometry.h"
 #include "Geometry/CSCGeometry/interface/CSCGeometry.h"
 #include "Geometry/GEMGeometry/interface/GEMGeometry.h"
 
-class IgCollection;
-class IgDataStorage;
-class IgCollectionItem;
-class IgAssociationSet;
-class IgProperty;
+#include "ISpy/Services/interface/IgCollection.h"
+
+#include <vector>
+
+class MagneticField;
 
 // NOTE: TM See note in ISpyMuon.h
 
-class ISpyPATMuon : public edm::EDAnalyzer
+class ISpyPATMuon : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPATMuon(const edm::ParameterSet&);
   virtual ~ISpyPATMuon(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
 
@@ -35,17 +36,14 @@ private:
   double out_;
   double step_;
 
-  IgDataStorage* storage_;
-
-  GlobalPoint& getOuterPoint(std::vector<pat::Muon>::const_iterator it); 
-  void addChambers(std::vector<pat::Muon>::const_iterator it);
-
-  edm::ESHandle<DTGeometry>  dtGeometry_;
-  bool dtGeomValid_;
-  edm::ESHandle<CSCGeometry> cscGeometry_;
-  bool cscGeomValid_;
-  edm::ESHandle<GEMGeometry> gemGeometry_;
-  bool gemGeomValid_;
+  GlobalPoint getOuterPoint(std::vector<pat::Muon>::const_iterator it,
+                            const DTGeometry* dtGeometry,
+                            const CSCGeometry* cscGeometry,
+                            const GEMGeometry* gemGeometry) const; 
 
+  void globalPoints(std::vector<IgV3d>& points,
+                    reco::TrackRef gMuon,
+                    const GlobalPoint& outerPoint,
+                    const MagneticField* field) const;
 };
 #endif
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_PATPHOTON_H
 #define ANALYZER_ISPY_PATPHOTON_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/PatCandidates/interface/Photon.h"
 
-class ISpyPATPhoton : public edm::EDAnalyzer
+class ISpyPATPhoton : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPATPhoton(const edm::ParameterSet&);
   virtual ~ISpyPATPhoton(void){}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<std::vector<pat::Photon> > photonToken_;
@@ -1,18 +1,20 @@
 #ifndef ANALYZER_ISPY_PFCLUSTER_H
 #define ANALYZER_ISPY_PFCLUSTER_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/ParticleFlowReco/interface/PFClusterFwd.h"
 
-class ISpyPFCluster : public edm::EDAnalyzer
+class ISpyPFCluster : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPFCluster(const edm::ParameterSet&);
   virtual ~ISpyPFCluster(void) {}
     
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
+  edm::EDGetTokenT<reco::PFClusterCollection> clusterToken_;
 };
 
 #endif // ANALYZER_ISPY_PFCLUSTER_H
@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_PFECALRECHIT_H
 #define ANALYZER_ISPY_PFECALRECHIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/ParticleFlowReco/interface/PFRecHitFwd.h"
 
-class ISpyPFEcalRecHit : public edm::EDAnalyzer
+class ISpyPFEcalRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPFEcalRecHit(const edm::ParameterSet&);
   virtual ~ISpyPFEcalRecHit(void) {}
     
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
 
   edm::InputTag inputTag_;
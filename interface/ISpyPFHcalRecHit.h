@@ -1,18 +1,18 @@
 #ifndef ANALYZER_ISPY_PFHCALRECHIT_H
 #define ANALYZER_ISPY_PFHCALRECHIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/ParticleFlowReco/interface/PFRecHitFwd.h"
 
-class ISpyPFHcalRecHit : public edm::EDAnalyzer
+class ISpyPFHcalRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPFHcalRecHit(const edm::ParameterSet&);
   virtual ~ISpyPFHcalRecHit(void) {}
     
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
 
   edm::InputTag hbheInputTag_;
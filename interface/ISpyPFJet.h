@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_PFJET_H
 #define ANALYZER_ISPY_PFJET_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/JetReco/interface/PFJetCollection.h"
 
-class ISpyPFJet : public edm::EDAnalyzer
+class ISpyPFJet : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPFJet(const edm::ParameterSet&);
   virtual ~ISpyPFJet(void){}
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 
 private:
   edm::InputTag inputTag_;
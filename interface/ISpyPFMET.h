@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_PFMET_H
 #define ANALYZER_ISPY_PFMET_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/METReco/interface/PFMETCollection.h"
 
-class ISpyPFMET : public edm::EDAnalyzer
+class ISpyPFMET : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyPFMET(const edm::ParameterSet&);
     virtual ~ISpyPFMET(void){}
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
     edm::InputTag inputTag_;
     edm::EDGetTokenT<reco::PFMETCollection> metToken_;
@@ -1,18 +1,20 @@
 #ifndef ANALYZER_ISPY_PFREC_TRACK_H
 #define ANALYZER_ISPY_PFREC_TRACK_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecTrackFwd.h"
 
-class ISpyPFRecTrack : public edm::EDAnalyzer
+class ISpyPFRecTrack : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPFRecTrack(const edm::ParameterSet&);
   virtual ~ISpyPFRecTrack(void) {}
     
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
+  edm::EDGetTokenT<reco::PFRecTrackCollection> trackToken_;
 };
 
 #endif // ANALYZER_ISPY_PFREC_TRACK_H
@@ -1,16 +1,18 @@
 #ifndef ANALYZER_ISPY_PFTAU_H
 #define ANALYZER_ISPY_PFTAU_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/TauReco/interface/PFTauFwd.h"
 
-class ISpyPFTau : public edm::EDAnalyzer
+class ISpyPFTau : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyPFTau(const edm::ParameterSet&);
     virtual ~ISpyPFTau(void){}
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
     edm::InputTag inputTag_;
+    edm::EDGetTokenT<reco::PFTauCollection> tauToken_;
 };
 #endif // ANALYZER_ISPY_PFTAU_H
@@ -1,22 +1,30 @@
 #ifndef ANALYZER_ISPY_PACKEDCANDIDATE_H
 #define ANALYZER_ISPY_PACKEDCANDIDATE_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/PatCandidates/interface/PackedCandidate.h"
+#include "DataFormats/VertexReco/interface/VertexFwd.h"
 
-class ISpyPackedCandidate : public edm::EDAnalyzer
+class ISpyPackedCandidate : public edm::global::EDAnalyzer<>
 {
 public:
 
   explicit ISpyPackedCandidate(const edm::ParameterSet&);
   virtual ~ISpyPackedCandidate(void){}
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 
 private:
 
   edm::InputTag inputTag_;
   edm::EDGetTokenT<pat::PackedCandidateCollection> candidateToken_;
 
+  bool primaryVertexOnly_;
+  edm::InputTag vertexInputTag_;
+  edm::EDGetTokenT<reco::VertexCollection> vertexToken_;
+  unsigned int maxVertices_;
+  double maxDz_;
+  double maxDxy_;
+
 };
 #endif // ANALYZER_ISPY_PACKEDCANDIDATE_H
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_PHOTON_H
 #define ANALYZER_ISPY_PHOTON_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/EgammaCandidates/interface/PhotonFwd.h"
 
-class ISpyPhoton : public edm::EDAnalyzer
+class ISpyPhoton : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPhoton(const edm::ParameterSet&);
   virtual ~ISpyPhoton(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<reco::PhotonCollection> photonToken_;
@@ -1,18 +1,23 @@
 #ifndef ANALYZER_ISPY_PIXEL_DIGI_H
 #define ANALYZER_ISPY_PIXEL_DIGI_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
 
-class ISpyPixelDigi : public edm::EDAnalyzer
+class ISpyPixelDigi : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyPixelDigi (const edm::ParameterSet&);
   virtual ~ISpyPixelDigi (void) {}
   
-  virtual void analyze( const edm::Event&, const edm::EventSetup& );
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
+  edm::EDGetTokenT<edm::DetSetVector<PixelDigi> > digiToken_;
+  bool		occupancy_; // one summary per module instead of the digis
+  bool		packed_; // digis grouped per module, without positions
 };
 
 #endif // ANALYZER_ISPY_PIXEL_DIGI_H
@@ -1,19 +1,21 @@
 #ifndef ANALYZER_ISPY_PRESHOWERCLUSTER_H
 #define ANALYZER_ISPY_PRESHOWERCLUSTER_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/EgammaReco/interface/PreshowerClusterFwd.h"
 #include <vector>
 
 typedef std::vector<edm::InputTag> VInputTag;
 
-class ISpyPreshowerCluster : public edm::EDAnalyzer
+class ISpyPreshowerCluster : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyPreshowerCluster(const edm::ParameterSet&);
     virtual ~ISpyPreshowerCluster(){};
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
     VInputTag inputTags_;
+    std::vector<edm::EDGetTokenT<reco::PreshowerClusterCollection> > clusterTokens_;
 };
 #endif
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_RPCREC_HIT_H
 #define ANALYZER_ISPY_RPCREC_HIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/RPCRecHit/interface/RPCRecHitCollection.h"
 
-class ISpyRPCRecHit : public edm::EDAnalyzer
+class ISpyRPCRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyRPCRecHit(const edm::ParameterSet&);
   virtual ~ISpyRPCRecHit(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   edm::EDGetTokenT<RPCRecHitCollection> rechitToken_;
@@ -0,0 +1,40 @@
+#ifndef ANALYZER_ISPY_REGION_OF_INTEREST_H
+#define ANALYZER_ISPY_REGION_OF_INTEREST_H
+
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Candidate/interface/Candidate.h"
+#include "DataFormats/Common/interface/View.h"
+#include <vector>
+
+/*
+  Sets the region of interest of the ISpyService for the event: an
+  eta-phi cone of radius deltaR around each of the leading maxObjects
+  objects above minPt of every source (muons, electrons, jets,
+  photons, ...). The hit analyzers that run after it in the path
+  (calorimeter and muon rechits, tracker clusters) then skip the hits
+  outside all the cones.
+*/
+
+class ISpyRegionOfInterest : public edm::global::EDAnalyzer<>
+{
+public:
+  explicit ISpyRegionOfInterest(const edm::ParameterSet&);
+  virtual ~ISpyRegionOfInterest(void) {}
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  struct Source
+  {
+    edm::InputTag tag;
+    edm::EDGetTokenT<edm::View<reco::Candidate> > token;
+    unsigned int maxObjects;
+    double minPt;
+    double deltaR;
+  };
+
+  std::vector<Source> sources_;
+};
+
+#endif // ANALYZER_ISPY_REGION_OF_INTEREST_H
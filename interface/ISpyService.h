@@ -1,7 +1,18 @@
 #ifndef ANALYZER_ISPY_SERVICE_H
 #define ANALYZER_ISPY_SERVICE_H
 
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "ISpy/Analyzers/interface/ISpyESContext.h"
+#include "ISpy/Analyzers/interface/ISpyMuonChambers.h"
+#include "ISpy/Analyzers/interface/ISpyTracer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <ISpy/Services/interface/zip.h>
 
 class IgDataStorage;
@@ -9,6 +20,10 @@ class IgDataStorage;
 namespace edm {
   class ActivityRegistry;
   class StreamContext;
+  class ModuleCallingContext;
+  class ModuleDescription;
+  class PathsAndConsumesOfModulesBase;
+  class ProcessContext;
   class ParameterSet;
   class EventID;
   class Timestamp;
@@ -16,26 +31,160 @@ namespace edm {
   class EventSetup;
     
   namespace service {
+    class SystemBounds;
+
+    // Each stream fills its own pair of storages (event and geometry)
+    // between preEvent and postEvent; the analyzers pick theirs up
+    // with the StreamID they are called with. Nothing guards the
+    // storages of a stream: the ISpy analyzers must all be on a
+    // single path, which runs its modules one after the other. Only
+    // writing the serialized event into the zip archives is
+    // serialized.
     class ISpyService
     {
     public:
       ISpyService (const edm::ParameterSet& pSet, ActivityRegistry& iRegistry);
 
+      void		preallocate (const edm::service::SystemBounds&);
+      void		preBeginJob (const edm::PathsAndConsumesOfModulesBase&, const edm::ProcessContext&);
       void 		postBeginJob (void);
       void 		postEndJob (void);
       void 		preEvent (const edm::StreamContext&);
       void 		postEvent (const edm::StreamContext&);
+      void		preModuleBeginJob (const edm::ModuleDescription&);
+      void		preModuleEvent (const edm::StreamContext&, const edm::ModuleCallingContext&);
+      void		postModuleEvent (const edm::StreamContext&, const edm::ModuleCallingContext&);
+
+      IgDataStorage * 	storage (edm::StreamID sid) { return streams_[sid.value()].storages[0]; }
+      IgDataStorage * 	esStorage (edm::StreamID sid) { return streams_[sid.value()].storages[1]; }
+      // Each distinct error is stored in full once per job, in the
+      // Errors_V1 of the event where it first happens; every event
+      // where it happens gets its id in ErrorIds_V1. The table of all
+      // errors (ErrorTable_V1: id, message, first run and event, count)
+      // is written to each event archive as the "Errors" entry on
+      // closing it.
+      void		error (edm::StreamID sid, const std::string & what);
+
+      // The same, keyed on a pointer that stands for the message
+      // (e.g. the address of the module's InputTag), so that the
+      // message is only formatted the first time.
+      template <class F>
+      void		error (edm::StreamID sid, const void * key, F message)
+	{
+	  if ( ! knownError (sid, key) )
+	    recordError (sid, key, message ());
+	}
+
+      // ISpy modules none of whose event inputs is in the product
+      // registry at the start of the job (e.g. RECO analyzers run on
+      // AOD) are pruned: they return straight away, and the list goes
+      // once to the log and to ErrorTable_V1, with no run or event.
+      // No event refers to it, so it doesn't make any event non-empty.
+      bool		pruned (unsigned int moduleID) const { return moduleID < pruned_.size() && pruned_[moduleID]; }
+
+      // Strings repeated in every event (module labels, types, ...)
+      // can be stored as an id instead. The ids are kept for the whole
+      // job and the table is written to each event archive as the
+      // "Strings" entry (collection Strings_V1: id, value) on closing it.
+      int		intern (const std::string & value);
 
-      IgDataStorage * 	storage (void) { return storages_[0]; }
-      IgDataStorage * 	esStorage (void) { return storages_[1]; }
-      void		error (const std::string & what);
+      // With stringTable set the analyzers write the strings they
+      // repeat in every event as ids (Products_V2, SuperClusters_V2).
+      bool		stringTable (void) const { return stringTable_; }
+
+      // Adds the description of an input product to the event:
+      // Products_V1 (Product: string) or, with stringTable,
+      // Products_V2 (Product: string id).
+      void		product (edm::StreamID sid, const std::string & product);
+
+      // With rangeAssociations set, track hits and points and cluster
+      // rechit fractions are associated by ranges of rows (see
+      // ISpyAssociations) rather than one pair per child.
+      bool		rangeAssociations (void) const { return rangeAssociations_; }
+
+      // With topEvents = N only the N events with the highest score are
+      // written, at the end of the job. Modules add to the score of the
+      // event they are processing (see ISpyEventScore).
+      void		addScore (edm::StreamID sid, double value) { streams_[sid.value()].score += value; }
+
+      // Region of interest: once ISpyRegionOfInterest has run for the
+      // event, the hit analyzers only keep hits within deltaR of one
+      // of its cones (and none at all if there are no cones). Before
+      // that, or without the module, every hit is in the region.
+      void		beginRegionOfInterest (edm::StreamID sid);
+      void		addRegionOfInterest (edm::StreamID sid, double eta, double phi, double deltaR);
+      bool		inRegionOfInterest (edm::StreamID sid, double eta, double phi) const;
+
+      // The geometries and field for the event, fetched again only
+      // when their IOV changes (see ISpyESContext). The context of the
+      // stream is bound to eventSetup on the first call in each event.
+      ISpyESContext &	esContext (edm::StreamID sid, const edm::EventSetup& eventSetup);
 
     private:
+      struct Cone
+      {
+	double		eta;
+	double		phi;
+	double		deltaR;
+	double		deltaR2;
+      };
+
+      struct StreamStorage
+      {
+	StreamStorage (void)
+	  : run(-1), event(-1), score(0.0), roiActive(false), esBound(false),
+	    events(0), rawBytes(0), serializeTime(0.0), writeTime(0.0)
+	  { storages[0] = storages[1] = 0; }
+
+	IgDataStorage	*storages[2];
+	int		run;
+	long long	event;
+	double		score;
+	bool		roiActive;
+	bool		esBound; // esContext set up for this event
+	std::vector<Cone> rois;
+	std::vector<int> errorIds; // referenced by this event
+
+	// Output timing, summed over the streams at the end of the job
+	unsigned long	events;
+	unsigned long long rawBytes;
+	double		serializeTime;
+	double		writeTime;
+      };
+
+      // A kept event: zlib-compressed JSON, in memory or, once the
+      // memory cap is reached, in the spill file at offset.
+      struct TopEvent
+      {
+	double		score;
+	std::string	name;
+	std::string	data;
+	long		offset;
+	size_t		size;
+	size_t		rawSize;
+      };
+
+      struct TopEventOrder
+      {
+	bool operator() (const TopEvent& a, const TopEvent& b) const { return a.score > b.score; }
+      };
+
       void              open(const std::string& name, zipFile& zfile);
-      void              write(std::stringstream& soss, zipFile& zfile);
+      void              write(const std::string& data, zipFile& zfile);
       void              close(zipFile& zfile);
       void              makeHeader();
       void              writeHeader(zipFile& zfile);
+      void              writeEntry(const std::string& name, const std::string& data, zipFile& zfile);
+      void              nextFile(void);
+      void              writeStrings(zipFile& zfile);
+      void              writeErrors(zipFile& zfile);
+      bool              knownError(edm::StreamID sid, const void* key);
+      void              recordError(edm::StreamID sid, const void* key, const std::string& message);
+      void              referenceError(edm::StreamID sid, int id);
+      void              writeEvent(const std::string& name, const std::string& data);
+      void              keepEvent(double score, const std::string& name, const std::string& data);
+      void              writeTopEvents(void);
+      void              reportTiming(void);
 	    
       std::string       outputFileName_;
       std::string       outputESFileName_;
@@ -45,14 +194,54 @@ namespace edm {
       std::string       header_;
 
       int		outputMaxEvents_;
+      int		compressionLevel_;
+      bool		timing_;
+      bool		rangeAssociations_;
+      bool		stringTable_;
+
+      struct ErrorEntry
+      {
+	std::string	message;
+	int		run;
+	long long	event;
+	unsigned long	count;
+      };
+
+      std::vector<ErrorEntry> errors_;
+      std::unordered_map<std::string, int> errorIds_;
+      std::unordered_map<const void*, int> errorKeys_;
+      std::mutex        errorsMutex_;
+
+      std::vector<bool> pruned_; // by module id
+
+      // With traceFileName set, see ISpyTracer
+      std::unique_ptr<ISpyTracer> tracer_;
+      std::vector<int>  traceModules_; // name id by module id, -1 if not traced
+      int               traceSerialize_;
+      int               traceDeflate_;
+      int               traceZipWrite_;
+      int               traceRollover_;
+      std::chrono::steady_clock::time_point beginTime_;
       int		eventCounter_;	    
       int		fileCounter_;	    
-      int		currentRun_;	    
-      long long		currentEvent_;
       
       zipFile           zipFile0_; // Events
       zipFile           zipFile1_; // Geometry
-      IgDataStorage 	*storages_[2];
+      std::vector<StreamStorage> streams_;
+      std::vector<std::unique_ptr<ISpyESContext> > esContexts_; // by stream
+      ISpyMuonChamberCache muonChamberCache_;
+      std::mutex        mutex_; // Guards the zip files and the counters above
+
+      std::unordered_map<std::string, int> stringIds_;
+      std::vector<std::string> strings_;
+      std::mutex        stringsMutex_;
+
+      size_t            topEvents_;
+      size_t            topEventsMaxBytes_;
+      size_t            topEventsBytes_;
+      std::vector<TopEvent> kept_; // min-heap on score
+      std::FILE         *spillFile_;
+      std::mutex        topEventsMutex_;
 
       bool              fileWritten_;
       int               ziperr_;
@@ -1,19 +1,19 @@
 #ifndef ANALYZER_ISPY_SI_PIXEL_CLUSTER_H
 #define ANALYZER_ISPY_SI_PIXEL_CLUSTER_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/Common/interface/DetSetVector.h"
 #include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
 
-class ISpySiPixelCluster : public edm::EDAnalyzer
+class ISpySiPixelCluster : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpySiPixelCluster(const edm::ParameterSet& iPSet);
   virtual ~ISpySiPixelCluster(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   edm::EDGetTokenT<edm::DetSetVector<SiPixelCluster> > clusterToken_;
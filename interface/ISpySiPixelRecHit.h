@@ -1,18 +1,20 @@
 #ifndef ANALYZER_ISPY_SI_PIXEL_REC_HIT_H
 #define ANALYZER_ISPY_SI_PIXEL_REC_HIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHitCollection.h"
 
-class ISpySiPixelRecHit : public edm::EDAnalyzer
+class ISpySiPixelRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpySiPixelRecHit(const edm::ParameterSet& iPSet);
   virtual ~ISpySiPixelRecHit(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
+  edm::EDGetTokenT<SiPixelRecHitCollection> rechitToken_;
 };
 
 #endif // ANALYZER_ISPY_SI_PIXEL_REC_HIT_H
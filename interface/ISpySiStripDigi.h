@@ -1,18 +1,23 @@
 #ifndef ANALYZER_ISPY_SI_STRIP_DIGI_H
 #define ANALYZER_ISPY_SI_STRIP_DIGI_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "DataFormats/Common/interface/DetSetVector.h"
+#include "DataFormats/SiStripDigi/interface/SiStripDigi.h"
 
-class ISpySiStripDigi : public edm::EDAnalyzer
+class ISpySiStripDigi : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpySiStripDigi(const edm::ParameterSet&);
   virtual ~ISpySiStripDigi(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
+  edm::EDGetTokenT<edm::DetSetVector<SiStripDigi> > digiToken_;
+  bool		occupancy_; // one summary per module instead of the digis
+  bool		packed_; // digis grouped per module, without positions
 };
 
 #endif // ANALYZER_ISPY_SI_STRIP_DIGI_H
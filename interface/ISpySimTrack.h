@@ -1,8 +1,11 @@
 #ifndef ANALYZER_ISPY_SIM_TRACK_H
 #define ANALYZER_ISPY_SIM_TRACK_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "SimDataFormats/Track/interface/SimTrackContainer.h"
+#include "SimDataFormats/Vertex/interface/SimVertexContainer.h"
+#include "SimDataFormats/TrackingHit/interface/PSimHitContainer.h"
 #include <map>
 
 class PSimHit;
@@ -10,20 +13,20 @@ class PSimHit;
 typedef std::vector<edm::InputTag> VInputTag;
 typedef std::map<int, std::vector<PSimHit> > SimHits;
 
-class ISpySimTrack : public edm::EDAnalyzer
+class ISpySimTrack : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpySimTrack(const edm::ParameterSet&); 
   virtual ~ISpySimTrack(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   VInputTag trackTags_;
+  std::vector<edm::EDGetTokenT<SimTrackContainer> > trackTokens_;
   VInputTag vertexTags_;
+  std::vector<edm::EDGetTokenT<SimVertexContainer> > vertexTokens_;
   VInputTag hitTags_;
-
-  // first: track ID, second: PSimHit
-  SimHits simHits_;
+  std::vector<edm::EDGetTokenT<PSimHitContainer> > hitTokens_;
 };
 
 #endif // ANALYZER_ISPY_SIM_TRACK_H
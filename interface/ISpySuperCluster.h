@@ -1,21 +1,21 @@
 #ifndef ANALYZER_ISPY_SUPERCLUSTER_H
 #define ANALYZER_ISPY_SUPERCLUSTER_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/CaloRecHit/interface/CaloCluster.h"
 #include "DataFormats/EgammaReco/interface/SuperClusterFwd.h"
 
-class ISpySuperCluster : public edm::EDAnalyzer
+class ISpySuperCluster : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpySuperCluster(const edm::ParameterSet&);
   virtual ~ISpySuperCluster(void) {}
 
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
-  const std::string algoName(reco::CaloCluster::AlgoId key);
+  const std::string algoName(reco::CaloCluster::AlgoId key) const;
   edm::EDGetTokenT<reco::SuperClusterCollection> clusterToken_;
 };
 
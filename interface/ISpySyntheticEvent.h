@@ -0,0 +1,44 @@
+#ifndef ANALYZER_ISPY_SYNTHETIC_EVENT_H
+#define ANALYZER_ISPY_SYNTHETIC_EVENT_H
+
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include <string>
+
+/*
+  Fills the ISpyService event storage with random content of the size
+  of a typical event of a given profile (minBias, ttbarPU200,
+  PbPbCentral, splash), using the same collections as the real
+  analyzers. Run from an EmptySource it measures the serialization
+  and archive writing of the service without any input file, see
+  python/ispy_WriterBenchmark_cfg.py.
+*/
+
+class ISpySyntheticEvent : public edm::global::EDAnalyzer<>
+{
+public:
+  explicit ISpySyntheticEvent(const edm::ParameterSet&);
+  virtual ~ISpySyntheticEvent(void) {}
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  struct Profile
+  {
+    const char *name;
+    unsigned int vertices;
+    unsigned int tracks;
+    unsigned int hitsPerTrack;
+    unsigned int ecalHits;
+    unsigned int hcalHits;
+    unsigned int stripClusters;
+    unsigned int pixelClusters;
+  };
+
+  static const Profile profiles_[];
+
+  std::string profileName_;
+  Profile profile_;
+  unsigned int seed_;
+};
+
+#endif // ANALYZER_ISPY_SYNTHETIC_EVENT_H
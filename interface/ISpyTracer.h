@@ -0,0 +1,76 @@
+#ifndef ANALYZER_ISPY_TRACER_H
+#define ANALYZER_ISPY_TRACER_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Timeline of an ISpy job in the Chrome trace-event format (open it
+// in Perfetto or chrome://tracing): begin and end of each ISpy module
+// and of the serialization, deflate, zip write and file rollover in
+// the ISpyService, per thread, tagged with the stream.
+//
+// Each thread records into its own fixed-size ring buffer, so taking
+// a timestamp needs no lock; only the first record of a new thread
+// registers its buffer. When a buffer is full the oldest records are
+// overwritten. The names are registered up front and recorded as ids.
+// write() is called once at the end of the job, when no thread
+// records any more.
+
+class ISpyTracer
+{
+public:
+  ISpyTracer(const std::string& fileName, size_t capacity);
+
+  int		name(const std::string& name, const std::string& category);
+  void		begin(int name, int stream) { record(name, 'B', stream); }
+  void		end(int name, int stream) { record(name, 'E', stream); }
+  void		write(void) const;
+
+  class Scope
+  {
+  public:
+    Scope(ISpyTracer* tracer, int name, int stream)
+      : tracer_(tracer), name_(name), stream_(stream)
+      { if ( tracer_ ) tracer_->begin(name_, stream_); }
+    ~Scope(void) { if ( tracer_ ) tracer_->end(name_, stream_); }
+
+  private:
+    ISpyTracer *tracer_;
+    int		name_;
+    int		stream_;
+  };
+
+private:
+  struct Record
+  {
+    long long	time; // ns since the start
+    int		name;
+    int		stream;
+    char	phase;
+  };
+
+  struct Buffer
+  {
+    std::vector<Record> records;
+    size_t	count; // all records ever, the ring index is count % capacity
+    int		thread;
+  };
+
+  void		record(int name, char phase, int stream);
+  Buffer *	buffer(void);
+
+  std::string	fileName_;
+  size_t	capacity_;
+  std::chrono::steady_clock::time_point start_;
+
+  std::vector<std::string> names_;
+  std::vector<std::string> categories_;
+
+  std::vector<std::unique_ptr<Buffer> > buffers_;
+  std::mutex	mutex_; // Guards buffers_ (registration only)
+};
+
+#endif // ANALYZER_ISPY_TRACER_H
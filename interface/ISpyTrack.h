@@ -2,25 +2,33 @@
 #ifndef ANALYZER_ISPY_TRACK_H
 #define ANALYZER_ISPY_TRACK_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/TrackReco/interface/TrackFwd.h"
+#include "DataFormats/VertexReco/interface/VertexFwd.h"
 #include <vector>
 
 //typedef std::vector<edm::InputTag> VInputTag;
 
-class ISpyTrack : public edm::EDAnalyzer
+class ISpyTrack : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyTrack(const edm::ParameterSet&);
   virtual ~ISpyTrack(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag	inputTag_;
   edm::EDGetTokenT<reco::TrackCollection> trackToken_;
 
   double ptMin_;
+
+  bool primaryVertexOnly_;
+  edm::InputTag vertexInputTag_;
+  edm::EDGetTokenT<reco::VertexCollection> vertexToken_;
+  unsigned int maxVertices_;
+  double maxDz_;
+  double maxDxy_;
 };
 
 #endif // ANALYZER_ISPY_TRACK_H
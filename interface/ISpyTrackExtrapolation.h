@@ -1,19 +1,20 @@
 #ifndef ANALYZER_ISPY_TRACKEXTRAPOLATION_H
 #define ANALYZER_ISPY_TRACKEXTRAPOLATION_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 #include "DataFormats/JetReco/interface/TrackExtrapolation.h"
 #include "DataFormats/EgammaCandidates/interface/GsfElectronFwd.h"
 #include "DataFormats/MuonReco/interface/MuonFwd.h"
+#include "DataFormats/VertexReco/interface/VertexFwd.h"
 
-class ISpyTrackExtrapolation : public edm::EDAnalyzer
+class ISpyTrackExtrapolation : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyTrackExtrapolation(const edm::ParameterSet&);
     virtual ~ISpyTrackExtrapolation(void){}
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::InputTag gsfElectronInputTag_;
@@ -26,5 +27,12 @@ private:
   double trackPtMin_;
   double electronPtMin_;
   double trackerMuonPtMin_;
+
+  bool primaryVertexOnly_;
+  edm::InputTag vertexInputTag_;
+  edm::EDGetTokenT<reco::VertexCollection> vertexToken_;
+  unsigned int maxVertices_;
+  double maxDz_;
+  double maxDxy_;
 };
 #endif // ANALYZER_ISPY_TRACKEXTRAPOLATION_H
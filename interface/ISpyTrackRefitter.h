@@ -2,21 +2,88 @@
 #define ANALYZER_ISPY_TRACKREFITTER_H
 
 #include "DataFormats/TrackReco/interface/TrackFwd.h"
+#include "FWCore/Utilities/interface/StreamID.h"
+#include "ISpy/Services/interface/IgCollection.h"
+#include <string>
+#include <vector>
 
-class IgCollectionItem;
-class IgAssociations;
-class IgDataStorage;
+class ISpyAssociations;
 class MagneticField;
 
+namespace edm { namespace service { class ISpyService; } }
+
 class ISpyTrackRefitter
 {
 public:
-  static void refitTrack(IgCollectionItem& item, 
-                         IgAssociations& assoc,
+  // Points along the track from in (a fraction of the inner to outer
+  // distance) before the inner state to out after the outer state,
+  // step apart. With maxSagitta > 0 the step is chosen instead so
+  // that the track bends by at most maxSagitta (cm) between points.
+  // Going out from the track, the points inside, along and outside it
+  // are each given up after maxFailed failed propagations in a row.
+  //
+  // This is done in two parts: propagate only appends the points (m)
+  // to the buffer and touches no storage, so that several tracks can
+  // be done concurrently; writePoints then adds them to Points_V1.
+  static void propagate(std::vector<IgV3d>& points,
+                        reco::TrackRef track,
+                        const MagneticField* field,
+                        double in, double out, double step,
+                        double maxSagitta = 0.0,
+                        int maxFailed = 5);
+  static void writePoints(IgCollectionItem& item,
+                          ISpyAssociations& assoc,
+                          IgDataStorage* storage,
+                          const std::vector<IgV3d>& points);
+
+  // Where the field is uniform along the track (the tracker), the
+  // track is written as one HelixSegments_V1 item instead of points:
+  // the reference point pos (m) and momentum p (GeV) at the inner
+  // state, the signed curvature (the direction turns by curvature
+  // radians per metre of transverse path, about the z axis) and the
+  // range s1 to s2 of transverse path length, in m from pos, to draw.
+  // The range is extended by in and out as for propagate.
+  //
+  // Again in two parts: helix fills h and returns false if the field
+  // is not uniform enough or the track loops, in which case propagate
+  // is to be used; writeHelix then adds it to HelixSegments_V1.
+  struct Helix
+  {
+    IgV3d pos;
+    IgV3d p;
+    double curvature;
+    double s1;
+    double s2;
+  };
+
+  static bool helix(Helix& h,
+                    reco::TrackRef track,
+                    const MagneticField* field,
+                    double in, double out);
+  static void writeHelix(IgCollectionItem& item,
+                         ISpyAssociations& assoc,
                          IgDataStorage* storage,
-                         reco::TrackRef track, 
-                         const MagneticField* field,
-                         double in, double out, double step);
+                         const Helix& h);
+
+  // One track done by helix or propagate, to be written later. A
+  // cms::Exception from the propagation is kept in error.
+  struct Refit
+  {
+    Refit(void) : isHelix(false), failed(false) {}
+
+    std::vector<IgV3d> points;
+    Helix helix;
+    bool isHelix;
+    bool failed;
+    std::string error;
+  };
+
+  // A failed refit is recorded as one error per message (e.g. per kind
+  // of muon, message is also the key), counted in ErrorTable_V1. The
+  // exception texts differ from track to track, so only the first one
+  // goes to the log.
+  static void reportError(edm::service::ISpyService& config, edm::StreamID sid,
+                          const char* message, const Refit& refit);
 };
 
 #endif // ANALYZER_ISPY_TRACKREFITTER_H
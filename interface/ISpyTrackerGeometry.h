@@ -1,11 +1,12 @@
 #ifndef ANALYZER_ISPY_TRACKER_GEOMETRY_H
 #define ANALYZER_ISPY_TRACKER_GEOMETRY_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Framework/interface/ESHandle.h"
-#include "FWCore/Framework/interface/ESWatcher.h"
+#include "ISpy/Analyzers/interface/ISpyBuildTimer.h"
 #include "DataFormats/DetId/interface/DetId.h"
 
+#include <mutex>
 #include <string>
 
 class GeomDet;
@@ -14,48 +15,46 @@ class GlobalTrackingGeometry;
 class TrackerGeometry;
 class IgDataStorage;
 class IgCollectionItem;
-class GlobalTrackingGeometryRecord;
-class TrackerDigiGeometryRecord;
 class TrackerTopology;
 
-class ISpyTrackerGeometry : public edm::EDAnalyzer
+class ISpyTrackerGeometry : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyTrackerGeometry(const edm::ParameterSet&);
   virtual ~ISpyTrackerGeometry(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+  void endJob(void) override;
 
 private:
-  void buildTracker3D(IgDataStorage *);
-  void buildPixelBarrel3D(IgDataStorage *);
-  void buildPixelEndcap3D(IgDataStorage *);
-  void buildPixelEndcapMinus3D(IgDataStorage *);
-  void buildPixelEndcapPlus3D(IgDataStorage *);
-
-  void buildTIB3D(IgDataStorage *);
-  void buildTOB3D(IgDataStorage *);
-
-  void buildTEC3D(IgDataStorage *);
-  void buildTECPlus3D(IgDataStorage *);
-  void buildTECMinus3D(IgDataStorage *);
-
-  void buildTID3D(IgDataStorage *);
-  void buildTIDPlus3D(IgDataStorage*);
-  void buildTIDMinus3D(IgDataStorage*);
-
-  void	buildTrackerRPhi(IgDataStorage *);
-  void	buildTrackerRZ(IgDataStorage *);
-
-  bool globalTrackingGeomChanged_;
-  bool trackerGeomChanged_;
-
-  edm::ESHandle<GlobalTrackingGeometry> globalTrackingGeom_;
-  edm::ESHandle<TrackerGeometry>      	trackerGeom_;
-  edm::ESHandle<TrackerTopology>        trackerTopology_;
-
-  edm::ESWatcher<GlobalTrackingGeometryRecord>  watch_globalTrackingGeom_;
-  edm::ESWatcher<TrackerDigiGeometryRecord>	watch_trackerGeom_;
+  void buildTracker3D(IgDataStorage *) const;
+  void buildPixelBarrel3D(IgDataStorage *) const;
+  void buildPixelEndcap3D(IgDataStorage *) const;
+  void buildPixelEndcapMinus3D(IgDataStorage *) const;
+  void buildPixelEndcapPlus3D(IgDataStorage *) const;
+
+  void buildTIB3D(IgDataStorage *) const;
+  void buildTOB3D(IgDataStorage *) const;
+
+  void buildTEC3D(IgDataStorage *) const;
+  void buildTECPlus3D(IgDataStorage *) const;
+  void buildTECMinus3D(IgDataStorage *) const;
+
+  void buildTID3D(IgDataStorage *) const;
+  void buildTIDPlus3D(IgDataStorage*) const;
+  void buildTIDMinus3D(IgDataStorage*) const;
+
+  void	buildTrackerRPhi(IgDataStorage *) const;
+  void	buildTrackerRZ(IgDataStorage *) const;
+
+  // The geometry is written once per IOV of the
+  // TrackerDigiGeometryRecord, by whichever stream sees it first.
+  mutable std::mutex mutex_; // Guards the members below
+  mutable unsigned long long cacheIdentifier_;
+  mutable ISpyBuildTimer timer_;
+  mutable edm::ESHandle<GlobalTrackingGeometry> globalTrackingGeom_;
+  mutable edm::ESHandle<TrackerGeometry>      	trackerGeom_;
+  mutable edm::ESHandle<TrackerTopology>        trackerTopology_;
 
 };
 
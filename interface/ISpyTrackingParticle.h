@@ -1,16 +1,16 @@
 #ifndef ANALYZER_ISPY_TRACKING_PARTICLE_H
 #define ANALYZER_ISPY_TRACKING_PARTICLE_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
-class ISpyTrackingParticle : public edm::EDAnalyzer
+class ISpyTrackingParticle : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyTrackingParticle(const edm::ParameterSet&);
   virtual ~ISpyTrackingParticle(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
 };
@@ -1,17 +1,17 @@
 #ifndef ANALYZER_ISPY_TRACKING_REC_HIT_H
 #define ANALYZER_ISPY_TRACKING_REC_HIT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/TrackingRecHit/interface/TrackingRecHitFwd.h"
 
-class ISpyTrackingRecHit : public edm::EDAnalyzer
+class ISpyTrackingRecHit : public edm::global::EDAnalyzer<>
 {
 public:
   explicit ISpyTrackingRecHit(const edm::ParameterSet&);
   virtual ~ISpyTrackingRecHit(void) {}
        
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
   edm::InputTag inputTag_;
   edm::EDGetTokenT<TrackingRecHitCollection> rechitToken_;
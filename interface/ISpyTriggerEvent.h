@@ -1,31 +1,70 @@
 #ifndef ANALYZER_ISPY_TRIGGER_EVENT_H
 #define ANALYZER_ISPY_TRIGGER_EVENT_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "HLTrigger/HLTcore/interface/HLTConfigProvider.h"
+#include "DataFormats/HLTReco/interface/TriggerEvent.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/TriggerResults.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class IgDataStorage;
 
 /*
   Dump TriggerEvent a la HLTEventAnalyzerAOD, TriggerSummaryAnalyzerAOD
 */
 
-class ISpyTriggerEvent : public edm::EDAnalyzer
+// Per-run tables, filled in globalBeginRun and shared by the streams
+struct ISpyTriggerRun
+{
+  struct TriggerPath
+  {
+    std::string name;
+    int nameId; // ISpyService::intern, with pathDictionary
+    unsigned int index;
+    std::vector<std::string> moduleLabels;
+    std::vector<std::string> moduleTypes;
+    std::vector<edm::InputTag> filterTags;
+    std::vector<int> moduleLabelIds;
+    std::vector<int> moduleTypeIds;
+  };
+
+  ISpyTriggerRun(void) : hltConfigProvided(false) {}
+
+  bool hltConfigProvided;
+  std::vector<TriggerPath> paths;
+};
+
+class ISpyTriggerEvent : public edm::global::EDAnalyzer<edm::RunCache<ISpyTriggerRun> >
 {
 public:
   explicit ISpyTriggerEvent(const edm::ParameterSet&);
   virtual ~ISpyTriggerEvent(void) {}
   
-  virtual void analyze(const edm::Event&, const edm::EventSetup&);
-  virtual void beginRun(const edm::Run&, const edm::EventSetup&);
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+  std::shared_ptr<ISpyTriggerRun> globalBeginRun(const edm::Run&, const edm::EventSetup&) const override;
+  void globalEndRun(const edm::Run&, const edm::EventSetup&) const override {}
 
 private:
+  // False, after reporting why, if the event cannot be written
+  bool inputs(edm::StreamID, const edm::Event&, IgDataStorage*, const ISpyTriggerRun&,
+              edm::Handle<trigger::TriggerEvent>&, edm::Handle<edm::TriggerResults>&) const;
+
+  // TriggerPaths and TriggerObjects, V1 with the names or V2 with
+  // their string ids (pathDictionary), as P says
+  template <class P>
+  void write(edm::StreamID, const edm::Event&, IgDataStorage*, const ISpyTriggerRun&) const;
+
   edm::InputTag triggerEventTag_;
   edm::InputTag triggerResultsTag_;
+  edm::EDGetTokenT<trigger::TriggerEvent> triggerEventToken_;
+  edm::EDGetTokenT<edm::TriggerResults> triggerResultsToken_;
   std::string processName_;
   std::string triggerName_;
-
-  HLTConfigProvider hltConfig_;
-  bool hltConfigProvided_;
+  bool pathDictionary_;
 };
 
 #endif // ANALYZER_ISPY_TRIGGER_EVENT_H
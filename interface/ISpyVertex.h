@@ -1,16 +1,16 @@
 #ifndef ANALYZER_ISPY_VERTEX_H
 #define ANALYZER_ISPY_VERTEX_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/VertexReco/interface/VertexFwd.h"
 
-class ISpyVertex : public edm::EDAnalyzer
+class ISpyVertex : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyVertex(const edm::ParameterSet&);
     virtual ~ISpyVertex(void){}
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
     edm::InputTag priVertexInputTag_;
     edm::InputTag secVertexInputTag_;    
@@ -1,16 +1,16 @@
 #ifndef ANALYZER_ISPY_VERTEXCOMPOSITECANDIDATE_H
 #define ANALYZER_ISPY_VERTEXCOMPOSITECANDIDATE_H
 
-#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 #include "DataFormats/Candidate/interface/VertexCompositeCandidateFwd.h"
 
-class ISpyVertexCompositeCandidate : public edm::EDAnalyzer
+class ISpyVertexCompositeCandidate : public edm::global::EDAnalyzer<>
 {
 public:
     explicit ISpyVertexCompositeCandidate(const edm::ParameterSet&);
     virtual ~ISpyVertexCompositeCandidate(void){}
-    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+    void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
 private:
     edm::InputTag vertexCompositeCandidateInputTag_;
 
@@ -0,0 +1,124 @@
+#ifndef ANALYZER_ISPY_VERTEX_SELECTOR_H
+#define ANALYZER_ISPY_VERTEX_SELECTOR_H
+
+#include "ISpy/Analyzers/interface/ISpyService.h"
+#include "DataFormats/VertexReco/interface/Vertex.h"
+#include "DataFormats/VertexReco/interface/VertexFwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/TypeID.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// Track to primary vertex compatibility, to leave the pileup tracks
+// out of the display.
+//
+// The first maxVertices good vertices of the collection (the primary
+// vertex collections are ordered by sum pT^2, so the hard scatter
+// comes first) are kept sorted by z. A track is compatible if it
+// passes the dz and dxy cuts with respect to one of them; only the
+// vertices within maxDz of the track z at the beam line are tried.
+// With no good vertex at all (cosmics, ...) every track is compatible.
+// Build one per event.
+
+class ISpyVertexSelector
+{
+public:
+  ISpyVertexSelector(const reco::VertexCollection& vertices,
+                     unsigned int maxVertices, double maxDz, double maxDxy)
+    : maxDz_(maxDz),
+      maxDxy_(maxDxy),
+      spread_(0.0)
+    {
+      for ( reco::VertexCollection::const_iterator vi = vertices.begin(), viEnd = vertices.end();
+            vi != viEnd && vertices_.size() < maxVertices; ++vi )
+      {
+        if ( vi->isValid() && ! vi->isFake() )
+          vertices_.push_back(vi->position());
+      }
+
+      std::sort(vertices_.begin(), vertices_.end(), byZ);
+
+      // The z window is taken at the mean transverse position of the
+      // vertices, widened by how far they are spread around it.
+      double x = 0.0, y = 0.0;
+
+      for ( std::vector<reco::Vertex::Point>::const_iterator vi = vertices_.begin(), viEnd = vertices_.end();
+            vi != viEnd; ++vi )
+      {
+        x += vi->x();
+        y += vi->y();
+      }
+
+      if ( ! vertices_.empty() )
+        beamLine_ = reco::Vertex::Point(x/vertices_.size(), y/vertices_.size(), 0.0);
+
+      for ( std::vector<reco::Vertex::Point>::const_iterator vi = vertices_.begin(), viEnd = vertices_.end();
+            vi != viEnd; ++vi )
+        spread_ = std::max(spread_, std::hypot(vi->x() - beamLine_.x(), vi->y() - beamLine_.y()));
+    }
+
+  // The selector for the vertices of the event, or null if they are
+  // not in it: the error is then reported (keyed on tag) and every
+  // track is shown.
+  static std::unique_ptr<ISpyVertexSelector>
+  fromEvent(edm::service::ISpyService& config, edm::StreamID sid, const edm::Event& event,
+            const edm::EDGetTokenT<reco::VertexCollection>& token, const edm::InputTag& tag,
+            unsigned int maxVertices, double maxDz, double maxDxy)
+    {
+      edm::Handle<reco::VertexCollection> vertices;
+      event.getByToken(token, vertices);
+
+      if ( vertices.isValid() )
+        return std::unique_ptr<ISpyVertexSelector>(new ISpyVertexSelector(*vertices, maxVertices, maxDz, maxDxy));
+
+      config.error (sid, &tag, [&] {
+        return "### Error: Vertices "
+               + edm::TypeID (typeid (reco::VertexCollection)).friendlyClassName() + ":"
+               + tag.label() + ":"
+               + tag.instance() + ":"
+               + tag.process() + " are not found.";
+      });
+
+      return std::unique_ptr<ISpyVertexSelector>();
+    }
+
+  // T is reco::Track or pat::PackedCandidate
+  template <class T>
+  bool compatible(const T& track) const
+    {
+      if ( vertices_.empty() )
+        return true;
+
+      double z = track.dz(beamLine_);
+      double window = maxDz_ + spread_*std::abs(track.pz()/track.pt());
+
+      reco::Vertex::Point low(0.0, 0.0, z - window);
+
+      for ( std::vector<reco::Vertex::Point>::const_iterator vi = std::lower_bound(vertices_.begin(), vertices_.end(), low, byZ),
+              viEnd = vertices_.end(); vi != viEnd && vi->z() <= z + window; ++vi )
+      {
+        if ( std::abs(track.dz(*vi)) < maxDz_ && std::abs(track.dxy(*vi)) < maxDxy_ )
+          return true;
+      }
+
+      return false;
+    }
+
+private:
+  static bool byZ(const reco::Vertex::Point& a, const reco::Vertex::Point& b)
+    {
+      return a.z() < b.z();
+    }
+
+  std::vector<reco::Vertex::Point> vertices_;
+  reco::Vertex::Point beamLine_;
+  double maxDz_;
+  double maxDxy_;
+  double spread_;
+};
+
+#endif // ANALYZER_ISPY_VERTEX_SELECTOR_H
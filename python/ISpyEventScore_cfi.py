@@ -0,0 +1,18 @@
+import FWCore.ParameterSet.Config as cms
+
+# Score used by the ISpyService when topEvents is set, e.g.
+#
+#   process.ISpyService.topEvents = cms.untracked.uint32(100)
+#   process.iSpy = cms.Path(process.ISpyEventScore*process.ISpyEvent*...)
+#
+# quantity is 'sumPt' (scalar pT sum of the objects above minPt)
+# or 'count' (number of objects above minPt).
+
+ISpyEventScore = cms.EDAnalyzer('ISpyEventScore',
+                                terms = cms.VPSet(
+    cms.PSet(src = cms.InputTag('muons'), quantity = cms.string('sumPt'),
+             minPt = cms.double(5.0), weight = cms.double(1.0)),
+    cms.PSet(src = cms.InputTag('gedGsfElectrons'), quantity = cms.string('sumPt'),
+             minPt = cms.double(5.0), weight = cms.double(1.0))
+    )
+                                )
@@ -0,0 +1,19 @@
+import FWCore.ParameterSet.Config as cms
+
+# With the defaults every event is accepted. Example:
+#
+#   ISpyEventSelector.triggerPaths = cms.vstring('HLT_IsoMu24_v*')
+#   ISpyEventSelector.objects = cms.VPSet(
+#       cms.PSet(src = cms.InputTag('muons'), minNumber = cms.uint32(2), minPt = cms.double(20.0)),
+#       cms.PSet(src = cms.InputTag('pfMet'), minNumber = cms.uint32(1), minPt = cms.double(50.0))
+#       )
+#   ISpyEventSelector.eventList = cms.VEventID('324998:0:123456')
+#
+#   process.iSpy = cms.Path(process.ISpyEventSelector*process.ISpyEvent*...)
+
+ISpyEventSelector = cms.EDFilter('ISpyEventSelector',
+                                 eventList = cms.VEventID(),
+                                 triggerResultsTag = cms.InputTag('TriggerResults', '', 'HLT'),
+                                 triggerPaths = cms.vstring(),
+                                 objects = cms.VPSet()
+                                 )
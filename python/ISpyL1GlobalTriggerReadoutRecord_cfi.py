@@ -1,5 +1,10 @@
 import FWCore.ParameterSet.Config as cms
 
 ISpyL1GlobalTriggerReadoutRecord = cms.EDAnalyzer('ISpyL1GlobalTriggerReadoutRecord',
-                                                  iSpyL1GlobalTriggerReadoutRecordTag = cms.InputTag("gtDigis")
+                                                  iSpyL1GlobalTriggerReadoutRecordTag = cms.InputTag("gtDigis"),
+                                                  # If True, write the algorithm names once per run
+                                                  # (L1GtAlgorithmNames_V1 in the geometry file) and only
+                                                  # the decision and technical words, 32 bits per row,
+                                                  # in the events (L1GtTrigger_V2, TechTrigger_V2)
+                                                  algorithmDictionary = cms.untracked.bool(False)
                                                   )
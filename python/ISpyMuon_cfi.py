@@ -1,5 +1,16 @@
 import FWCore.ParameterSet.Config as cms
 
 ISpyMuon = cms.EDAnalyzer('ISpyMuon' ,
-                          iSpyMuonTag = cms.InputTag("muons")
+                          iSpyMuonTag = cms.InputTag("muons"),
+                          # If > 0, the step between the propagated points is chosen from the
+                          # track curvature so that the track bends by at most this (cm) between
+                          # two points, instead of the fixed propagatorStep (default 0.05)
+                          propagatorMaxSagitta = cms.untracked.double(0.0),
+                          # The points inside, along and outside the track are each given up
+                          # after this many failed propagations in a row
+                          propagatorMaxFailed = cms.untracked.int32(5),
+                          # If True, write the tracker track of the muons as one helix
+                          # segment (HelixSegments_V1, MuonTrackerHelices_V1) rather than
+                          # propagated points wherever the field along it is uniform
+                          helixSegments = cms.untracked.bool(False)
                           )
@@ -1,5 +1,12 @@
 import FWCore.ParameterSet.Config as cms
 
 ISpyPackedCandidate = cms.EDAnalyzer('ISpyPackedCandidate',
-                            iSpyPackedCandidateTag = cms.InputTag('packedPFCandidates')
+                            iSpyPackedCandidateTag = cms.InputTag('packedPFCandidates'),
+                            # Only tracks within maxDz/maxDxy (cm) of one of the first
+                            # maxVertices primary vertices
+                            primaryVertexOnly = cms.untracked.bool(False),
+                            iSpyPriVertexTag = cms.untracked.InputTag("offlineSlimmedPrimaryVertices"),
+                            maxVertices = cms.untracked.uint32(1),
+                            maxDz = cms.untracked.double(0.2),
+                            maxDxy = cms.untracked.double(0.5)
                            )
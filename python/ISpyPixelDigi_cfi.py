@@ -1,5 +1,12 @@
 import FWCore.ParameterSet.Config as cms
 
 ISpyPixelDigi = cms.EDAnalyzer('ISpyPixelDigi' ,
-                               iSpyPixelDigiTag = cms.InputTag("siPixelDigis")
+                               iSpyPixelDigiTag = cms.InputTag("siPixelDigis"),
+                               # At most one of occupancy and packed can be set
+                               # If True, write one PixelOccupancy_V1 row per module (detid, position,
+                               # number of digis, sum of adc) instead of the digis
+                               occupancy = cms.untracked.bool(False),
+                               # If True, write one PixelDigis_V2 row per module with the row,
+                               # column and adc of its digis, and no positions
+                               packed = cms.untracked.bool(False)
                                )
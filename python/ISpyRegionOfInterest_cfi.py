@@ -0,0 +1,24 @@
+import FWCore.ParameterSet.Config as cms
+
+# Keeps only the hits near the leading physics objects. It must run
+# before the hit analyzers, e.g.
+#
+#   process.iSpy = cms.Path(process.ISpyEventSelector*
+#                           process.ISpyRegionOfInterest*
+#                           process.ISpyEvent*...)
+#
+# Each source adds an eta-phi cone of radius deltaR around its
+# leading maxObjects objects with pT above minPt.
+
+ISpyRegionOfInterest = cms.EDAnalyzer('ISpyRegionOfInterest',
+                                      sources = cms.VPSet(
+    cms.PSet(src = cms.InputTag('muons'), maxObjects = cms.uint32(4),
+             minPt = cms.double(3.0), deltaR = cms.double(0.3)),
+    cms.PSet(src = cms.InputTag('gedGsfElectrons'), maxObjects = cms.uint32(4),
+             minPt = cms.double(5.0), deltaR = cms.double(0.3)),
+    cms.PSet(src = cms.InputTag('photons'), maxObjects = cms.uint32(4),
+             minPt = cms.double(10.0), deltaR = cms.double(0.3)),
+    cms.PSet(src = cms.InputTag('ak4PFJets'), maxObjects = cms.uint32(6),
+             minPt = cms.double(30.0), deltaR = cms.double(0.5))
+    )
+                                      )
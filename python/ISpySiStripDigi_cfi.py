@@ -1,5 +1,12 @@
 import FWCore.ParameterSet.Config as cms
 
 ISpySiStripDigi = cms.EDAnalyzer('ISpySiStripDigi' ,
-                                 iSpySiStripDigiTag = cms.InputTag("siStripDigis:ZeroSuppressed")
+                                 iSpySiStripDigiTag = cms.InputTag("siStripDigis:ZeroSuppressed"),
+                                 # At most one of occupancy and packed can be set
+                                 # If True, write one SiStripOccupancy_V1 row per module (detid, position,
+                                 # number of digis, sum of adc) instead of the digis
+                                 occupancy = cms.untracked.bool(False),
+                                 # If True, write one SiStripDigis_V2 row per run of adjacent strips
+                                 # with the first strip and the adc values, and no positions
+                                 packed = cms.untracked.bool(False)
                                  )
@@ -6,5 +6,12 @@ ISpyTrackExtrapolation = cms.EDAnalyzer('ISpyTrackExtrapolation' ,
                                         electronPtMin = cms.double(1.0),
                                         trackerMuonPtMin = cms.double(1.0),
                                         iSpyGsfElectronTrackExtrapolationTag = cms.InputTag("gedGsfElectrons"),
-                                        iSpyMuonTrackExtrapolationTag = cms.InputTag("muons")
+                                        iSpyMuonTrackExtrapolationTag = cms.InputTag("muons"),
+                                        # Only tracks within maxDz/maxDxy (cm) of one of the first
+                                        # maxVertices primary vertices
+                                        primaryVertexOnly = cms.untracked.bool(False),
+                                        iSpyPriVertexTag = cms.untracked.InputTag("offlinePrimaryVertices"),
+                                        maxVertices = cms.untracked.uint32(1),
+                                        maxDz = cms.untracked.double(0.2),
+                                        maxDxy = cms.untracked.double(0.5)
                                         )
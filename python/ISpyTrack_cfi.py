@@ -3,4 +3,11 @@ import FWCore.ParameterSet.Config as cms
 ISpyTrack = cms.EDAnalyzer('ISpyTrack' ,
                            iSpyTrackTag = cms.InputTag("generalTracks"),
                            ptMin = cms.double(2.0),
+                           # Only tracks within maxDz/maxDxy (cm) of one of the first
+                           # maxVertices primary vertices
+                           primaryVertexOnly = cms.untracked.bool(False),
+                           iSpyPriVertexTag = cms.untracked.InputTag("offlinePrimaryVertices"),
+                           maxVertices = cms.untracked.uint32(1),
+                           maxDz = cms.untracked.double(0.2),
+                           maxDxy = cms.untracked.double(0.5)
                            )
@@ -3,5 +3,9 @@ import FWCore.ParameterSet.Config as cms
 ISpyTriggerEvent = cms.EDAnalyzer('ISpyTriggerEvent',
                                   triggerEventTag = cms.InputTag('hltTriggerSummaryAOD'),
                                   triggerResultsTag = cms.InputTag('TriggerResults'),
-                                  processName = cms.string('HLT')
+                                  processName = cms.string('HLT'),
+                                  # If True, the path names, module labels and types are written as
+                                  # ids in the archive's string table (Strings_V1) rather than
+                                  # strings (TriggerPaths_V2, TriggerObjects_V2)
+                                  pathDictionary = cms.untracked.bool(False)
                                   )
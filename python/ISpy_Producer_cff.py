@@ -1,4 +1,5 @@
 from ISpy.Analyzers.ISpyEvent_cfi import *
+from ISpy.Analyzers.ISpyEventSelector_cfi import *
 from ISpy.Analyzers.ISpyBasicCluster_cfi import *
 from ISpy.Analyzers.ISpyBeamSpot_cfi import *
 from ISpy.Analyzers.ISpyCSCRecHit2D_cfi import *
@@ -44,6 +45,7 @@ from ISpy.Analyzers.ISpyPhoton_cfi import *
 from ISpy.Analyzers.ISpyPixelDigi_cfi import *
 from ISpy.Analyzers.ISpyPreshowerCluster_cfi import *
 from ISpy.Analyzers.ISpyRPCRecHit_cfi import *
+from ISpy.Analyzers.ISpyRegionOfInterest_cfi import *
 from ISpy.Analyzers.ISpySiPixelCluster_cfi import *
 from ISpy.Analyzers.ISpySiPixelRecHit_cfi import *
 from ISpy.Analyzers.ISpySiStripCluster_cfi import *
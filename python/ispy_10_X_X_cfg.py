@@ -50,6 +50,7 @@ process.maxEvents = cms.untracked.PSet(
         input = cms.untracked.int32(10)
         )
 
+process.load("ISpy.Analyzers.ISpyEventSelector_cfi")
 process.load("ISpy.Analyzers.ISpyEvent_cfi")
 process.load('ISpy.Analyzers.ISpyCSCRecHit2D_cfi')
 process.load('ISpy.Analyzers.ISpyCSCSegment_cfi')
@@ -103,7 +104,9 @@ process.ISpyVertex.iSpyVertexTag = cms.InputTag('offlinePrimaryVertices')
 process.ISpyTrackExtrapolation.iSpyTrackExtrapolationTag = cms.InputTag("trackExtrapolator")
 process.ISpyTrackExtrapolation.trackPtMin = cms.double(2.0)
 
-process.iSpy = cms.Path(process.ISpyEvent*
+# Accepts every event unless criteria are set, see ISpyEventSelector_cfi
+process.iSpy = cms.Path(process.ISpyEventSelector*
+                        process.ISpyEvent*
                         process.ISpyCSCRecHit2D*
                         process.ISpyCSCSegment*
                         process.ISpyDTRecHit*
@@ -0,0 +1,50 @@
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+# Times ISpyCSCStripDigi on RAW data with a high CSC occupancy, such as
+# a cosmic run:
+#
+#   cmsRun ispy_CSCStripDigiBenchmark_cfg.py inputFiles=file:cosmics-raw.root globalTag=...
+#
+# The service prints events/s and MB/s at the end of the job and the time
+# spent in the analyzer is in csc-strip-digi-trace.json (open it in Perfetto).
+
+options = VarParsing('analysis')
+options.register('globalTag', '103X_dataRun2_Prompt_v3', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 'global tag of the input')
+options.setDefault('maxEvents', 1000)
+options.parseArguments()
+
+process = cms.Process("ISPY")
+
+process.load("Configuration.StandardSequences.GeometryDB_cff")
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+process.load("Configuration.StandardSequences.RawToDigi_Data_cff")
+
+process.GlobalTag.globaltag = options.globalTag
+
+process.source = cms.Source("PoolSource",
+                            fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+from FWCore.MessageLogger.MessageLogger_cfi import *
+
+process.add_(
+    cms.Service("ISpyService",
+                outputFileName = cms.untracked.string('csc-strip-digi-benchmark.ig'),
+                outputESFileName = cms.untracked.string('csc-strip-digi-benchmark-ES.ig'),
+                outputMaxEvents = cms.untracked.int32(-1),
+                timing = cms.untracked.bool(True),
+                traceFileName = cms.untracked.string('csc-strip-digi-trace.json')
+                )
+    )
+
+process.load('ISpy.Analyzers.ISpyCSCStripDigi_cfi')
+
+process.iSpy = cms.Path(process.muonCSCDigis*
+                        process.ISpyCSCStripDigi)
+process.schedule = cms.Schedule(process.iSpy)
@@ -0,0 +1,57 @@
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+# Times ISpyEBDigi and ISpyEEDigi on events with the full ECAL readout
+# (e.g. RAW-RECO of a run with the ECAL zero suppression off):
+#
+#   cmsRun ispy_EcalDigiBenchmark_cfg.py inputFiles=file:raw-reco.root globalTag=...
+#
+# The unpacked digis are matched to the rechits of the input file. The
+# service prints events/s and MB/s at the end of the job and the time
+# spent in each analyzer is in ecal-digi-trace.json (open it in Perfetto).
+
+options = VarParsing('analysis')
+options.register('globalTag', '103X_dataRun2_Prompt_v3', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 'global tag of the input')
+options.setDefault('maxEvents', 100)
+options.parseArguments()
+
+process = cms.Process("ISPY")
+
+process.load("Configuration.StandardSequences.GeometryDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+process.load("Configuration.StandardSequences.RawToDigi_Data_cff")
+
+process.GlobalTag.globaltag = options.globalTag
+
+process.source = cms.Source("PoolSource",
+                            fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+from FWCore.MessageLogger.MessageLogger_cfi import *
+
+process.add_(
+    cms.Service("ISpyService",
+                outputFileName = cms.untracked.string('ecal-digi-benchmark.ig'),
+                outputESFileName = cms.untracked.string('ecal-digi-benchmark-ES.ig'),
+                outputMaxEvents = cms.untracked.int32(-1),
+                timing = cms.untracked.bool(True),
+                traceFileName = cms.untracked.string('ecal-digi-trace.json')
+                )
+    )
+
+process.load('ISpy.Analyzers.ISpyEBDigi_cfi')
+process.load('ISpy.Analyzers.ISpyEEDigi_cfi')
+
+process.ISpyEBDigi.iSpyEBDigiTag = cms.InputTag('ecalDigis:ebDigis')
+process.ISpyEEDigi.iSpyEEDigiTag = cms.InputTag('ecalDigis:eeDigis')
+
+process.iSpy = cms.Path(process.ecalDigis*
+                        process.ISpyEBDigi*
+                        process.ISpyEEDigi)
+process.schedule = cms.Schedule(process.iSpy)
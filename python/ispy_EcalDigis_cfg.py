@@ -34,10 +34,7 @@ process.maxEvents = cms.untracked.PSet(
     input = cms.untracked.int32(10)
 )
 
-process.iSpy_digis = cms.Path(process.ISpyEBDigi*
-                              process.ISpyEEDigi)
-
 process.p3 = cms.Path(process.RawToDigi)
 process.p4 = cms.Path(process.reconstruction)
 process.p5 = cms.Path(process.iSpy_sequence)
-process.schedule = cms.Schedule(process.p3, process.p4, process.iSpy_digis, process.p5)
+process.schedule = cms.Schedule(process.p3, process.p4, process.p5)
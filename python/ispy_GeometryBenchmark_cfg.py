@@ -0,0 +1,43 @@
+import FWCore.ParameterSet.Config as cms
+
+# Times each build*3D/RPhi/RZ function of the tracker, muon and
+# calorimeter geometry analyzers, repeat times each, with the size of
+# what it writes. No input file is needed; the numbers are printed at
+# the end of the job.
+
+process = cms.Process("ISPY")
+
+process.load("Configuration.StandardSequences.GeometryDB_cff")
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+
+process.GlobalTag.globaltag = '103X_dataRun2_HLT_v1'
+
+process.source = cms.Source("EmptySource")
+
+from FWCore.MessageLogger.MessageLogger_cfi import *
+
+process.add_(
+    cms.Service("ISpyService",
+    outputFileName = cms.untracked.string('geometry-benchmark.ig'),
+    outputESFileName = cms.untracked.string('geometry-benchmark-ES.ig')
+    )
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1)
+)
+
+process.load("ISpy.Analyzers.ISpyTrackerGeometry_cfi")
+process.load("ISpy.Analyzers.ISpyMuonGeometry_cfi")
+process.load("ISpy.Analyzers.ISpyCaloGeometry_cfi")
+
+repeat = cms.untracked.uint32(20)
+
+process.ISpyTrackerGeometry.benchmarkRepeat = repeat
+process.ISpyMuonGeometry.benchmarkRepeat = repeat
+process.ISpyCaloGeometry.benchmarkRepeat = repeat
+
+process.iSpy = cms.Path(process.ISpyTrackerGeometry*
+                        process.ISpyMuonGeometry*
+                        process.ISpyCaloGeometry)
+process.schedule = cms.Schedule(process.iSpy)
@@ -0,0 +1,32 @@
+import FWCore.ParameterSet.Config as cms
+
+# Times ISpyLocalPosition against the old per-hit lookup on
+# recorded tracks. The tracks need their rechits, so use a RECO
+# (not AOD) file. The result is printed at the end of the job.
+
+process = cms.Process("ISPY")
+
+process.load("Configuration.StandardSequences.GeometryDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+
+process.GlobalTag.globaltag = '103X_dataRun2_HLT_v1'
+
+process.source = cms.Source(
+    'PoolSource',
+    fileNames = cms.untracked.vstring('file:///myRECO.root')
+    )
+
+from FWCore.MessageLogger.MessageLogger_cfi import *
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+)
+
+process.ISpyLocalPositionBenchmark = cms.EDAnalyzer('ISpyLocalPositionBenchmark',
+                                                    iSpyTrackTag = cms.InputTag("generalTracks"),
+                                                    repeat = cms.untracked.int32(10)
+                                                    )
+
+process.iSpy = cms.Path(process.ISpyLocalPositionBenchmark)
+process.schedule = cms.Schedule(process.iSpy)
@@ -0,0 +1,29 @@
+# Run the 10_X_X configuration with several threads and streams.
+# Each stream fills its own event in the ISpyService, so the .ig
+# output should contain the same events as a single-threaded run
+# (in a different order); ispy_MT_check.py runs both and compares them.
+#
+#   cmsRun ispy_MT_cfg.py threads=4 outputFileName=mt.ig
+
+from ISpy.Analyzers.ispy_10_X_X_cfg import process
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('python')
+options.register('threads', 4, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 'Number of threads, with one stream each')
+options.register('outputFileName', '', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 'ISpyService output file, all events in one archive')
+options.register('maxEvents', 0, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 'Number of input events, if not 0')
+options.parseArguments()
+
+process.options.numberOfThreads = cms.untracked.uint32(options.threads)
+process.options.numberOfStreams = cms.untracked.uint32(0)
+
+if options.outputFileName:
+    process.ISpyService.outputFileName = cms.untracked.string(options.outputFileName)
+    process.ISpyService.outputMaxEvents = cms.untracked.int32(-1)
+
+if options.maxEvents:
+    process.maxEvents.input = cms.untracked.int32(options.maxEvents)
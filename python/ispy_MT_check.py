@@ -0,0 +1,129 @@
+#! /usr/bin/env python
+#
+# Check that a multithreaded run writes the same events as a
+# single-threaded one: runs ispy_MT_cfg.py with 1 and with N threads
+# and compares the two .ig archives event by event.
+#
+#   python ispy_MT_check.py [--threads 4] [--events 20]
+#   python ispy_MT_check.py --compare st_0.ig mt_0.ig
+#
+# The event entries must have the same names and, once the ids into
+# the archive's Strings and Errors tables are replaced by what they
+# refer to (those tables are filled in the order the streams get to
+# them), the same contents. Exits with 1 on any difference.
+
+import json
+import os
+import re
+import subprocess
+import sys
+import zipfile
+
+EVENT = re.compile(r'Events/Run_\d+/Event_\d+$')
+
+# Properties holding an id into the Strings (Strings_V1) entry,
+# see the README
+STRING_IDS = {
+    'Products_V2': ['Product'],
+    'SuperClusters_V2': ['algo'],
+    'TriggerPaths_V2': ['Name'],
+    'TriggerObjects_V2': ['path', 'moduleLabel', 'moduleType'],
+}
+
+# Properties holding an id into the Errors (ErrorTable_V1) entry
+ERROR_IDS = {
+    'ErrorIds_V1': ['id'],
+}
+
+def parse(text):
+    # The entries are python literals, but for nan and inf
+    return eval(text, {'__builtins__': {}}, {'nan': float('nan'), 'inf': float('inf')})
+
+def table(archive, suffix, collection, key, value):
+    for name in archive.namelist():
+        if name.endswith(suffix):
+            data = parse(archive.read(name).decode('utf-8'))
+            types = [t[0] for t in data['Types'][collection]]
+            k, v = types.index(key), types.index(value)
+            return dict((row[k], row[v]) for row in data['Collections'][collection])
+    return {}
+
+def resolve(data, ids, values):
+    for collection, properties in ids.items():
+        if collection not in data['Collections']:
+            continue
+        types = [t[0] for t in data['Types'][collection]]
+        columns = [types.index(p) for p in properties if p in types]
+        for row in data['Collections'][collection]:
+            for c in columns:
+                row[c] = values.get(row[c], row[c])
+
+def events(fileName):
+    archive = zipfile.ZipFile(fileName)
+    strings = table(archive, 'Strings', 'Strings_V1', 'id', 'value')
+    errors = table(archive, 'Errors', 'ErrorTable_V1', 'id', 'message')
+
+    result = {}
+    for name in archive.namelist():
+        m = EVENT.search(name)
+        if not m:
+            continue
+        data = parse(archive.read(name).decode('utf-8'))
+        resolve(data, STRING_IDS, strings)
+        resolve(data, ERROR_IDS, errors)
+        if 'ErrorIds_V1' in data['Collections']:
+            data['Collections']['ErrorIds_V1'].sort()
+        result[m.group(0)] = json.dumps(data, sort_keys=True)
+    return result
+
+def compare(reference, test):
+    ref = events(reference)
+    out = events(test)
+    failed = False
+
+    for name in sorted(set(ref) - set(out)):
+        print('missing from %s: %s' % (test, name))
+        failed = True
+    for name in sorted(set(out) - set(ref)):
+        print('not in %s: %s' % (reference, name))
+        failed = True
+    for name in sorted(set(ref) & set(out)):
+        if ref[name] != out[name]:
+            print('differs: %s' % name)
+            failed = True
+
+    print('%s: %d events, %s: %d events, %s' % (reference, len(ref), test, len(out),
+                                                 'DIFFERENT' if failed else 'same'))
+    return not failed
+
+def run(threads, events, name):
+    cfg = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'ispy_MT_cfg.py')
+    args = ['cmsRun', cfg, 'threads=%d' % threads, 'outputFileName=%s.ig' % name]
+    if events:
+        args.append('maxEvents=%d' % events)
+    subprocess.check_call(args)
+    # ISpyService numbers its archives
+    return os.path.join(os.getenv('ANALYSIS_OUTDIR', ''), '%s_0.ig' % name)
+
+def main(argv):
+    threads, nevents = 4, 0
+
+    if len(argv) == 3 and argv[0] == '--compare':
+        return 0 if compare(argv[1], argv[2]) else 1
+
+    while argv:
+        option = argv.pop(0)
+        if option == '--threads':
+            threads = int(argv.pop(0))
+        elif option == '--events':
+            nevents = int(argv.pop(0))
+        else:
+            print('usage: ispy_MT_check.py [--threads N] [--events N] | --compare reference.ig test.ig')
+            return 2
+
+    reference = run(1, nevents, 'ispy_MT_check_1')
+    test = run(threads, nevents, 'ispy_MT_check_%d' % threads)
+    return 0 if compare(reference, test) else 1
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,57 @@
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+# Times the ISpyService output (serialization, deflate and the zip
+# writing done in postEvent) on synthetic events, without input files:
+#
+#   for c in 1 6 9; do for t in 1 4 8; do
+#     cmsRun ispy_WriterBenchmark_cfg.py profile=ttbarPU200 compression=$c threads=$t
+#   done; done
+#
+# The numbers (events/s, MB/s, peak RSS) are printed at the end of the job.
+
+options = VarParsing('analysis')
+options.register('profile', 'minBias', VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                 'minBias, ttbarPU200, PbPbCentral or splash')
+options.register('compression', 9, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 'zlib compression level of the archive entries')
+options.register('ranges', False, VarParsing.multiplicity.singleton, VarParsing.varType.bool,
+                 'range associations for the track hits')
+options.register('threads', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 'number of threads and streams')
+options.setDefault('maxEvents', 100)
+options.parseArguments()
+
+process = cms.Process("ISPY")
+
+process.source = cms.Source('EmptySource')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(options.threads)
+    )
+
+from FWCore.MessageLogger.MessageLogger_cfi import *
+
+process.add_(
+    cms.Service("ISpyService",
+                outputFileName = cms.untracked.string('benchmark_%s.ig' % options.profile),
+                outputESFileName = cms.untracked.string('benchmarkES.ig'),
+                outputMaxEvents = cms.untracked.int32(-1),
+                compressionLevel = cms.untracked.int32(options.compression),
+                rangeAssociations = cms.untracked.bool(options.ranges),
+                timing = cms.untracked.bool(True)
+                )
+    )
+
+process.ISpySyntheticEvent = cms.EDAnalyzer('ISpySyntheticEvent',
+                                            profile = cms.untracked.string(options.profile),
+                                            seed = cms.untracked.uint32(1)
+                                            )
+
+process.iSpy = cms.Path(process.ISpySyntheticEvent)
+process.schedule = cms.Schedule(process.iSpy)
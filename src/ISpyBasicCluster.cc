@@ -24,10 +24,12 @@ using namespace edm::service;
 
 ISpyBasicCluster::ISpyBasicCluster (const edm::ParameterSet& iConfig)
     : inputTag_ (iConfig.getParameter<edm::InputTag>("iSpyBasicClusterTag"))
-{}
+{
+  clusterToken_ = consumes<reco::BasicClusterCollection>(inputTag_);
+}
 
 void 
-ISpyBasicCluster::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyBasicCluster::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   
@@ -39,22 +41,24 @@ ISpyBasicCluster::analyze (const edm::Event& event, const edm::EventSetup& event
       "You must add the service in the configuration file\n"
       "or remove the module that requires it";
   }
+
+  if ( config->pruned(moduleDescription().id()) )
+    return;
    
-  IgDataStorage *storage = config->storage();
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord> ().get (geom);
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyBasicCluster::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
     
   edm::Handle<reco::BasicClusterCollection> collection;
-  event.getByLabel (inputTag_, collection);
+  event.getByToken (clusterToken_, collection);
  
   if ( collection.isValid ())
   {	    	
@@ -64,10 +68,7 @@ ISpyBasicCluster::analyze (const edm::Event& event, const edm::EventSetup& event
                           + inputTag_.instance() + ":" 
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
     
     IgCollection &icollection = storage->getCollection("BasicClusters_V1");
     IgProperty ENERGY = icollection.addProperty("energy", 0.0);
@@ -112,14 +113,15 @@ ISpyBasicCluster::analyze (const edm::Event& event, const edm::EventSetup& event
       }
 #else
       std::vector<std::pair<DetId, float> > clusterDetIds = (*it).hitsAndFractions ();
-      
+
+
       for (std::vector<std::pair<DetId, float> >::iterator id = clusterDetIds.begin (), idend = clusterDetIds.end (); id != idend; ++id)
       {
         IgCollectionItem idetid = idetids.create();
         idetid[DETID] = static_cast<int>((*id).first);
         idetid[FRACT] = static_cast<double>((*id).second);
 
-        auto cell = (*geom).getGeometry ((*id).first);
+        auto cell = geom->getGeometry ((*id).first);
         const CaloCellGeometry::CornersVec& corners = cell->getCorners ();
         
         assert(corners.size() == 8);
@@ -142,19 +144,20 @@ ISpyBasicCluster::analyze (const edm::Event& event, const edm::EventSetup& event
   }
   else 
   {
-    std::string error = "### Error: BasicClusters "
-                        + edm::TypeID (typeid (reco::BasicClusterCollection)).friendlyClassName () + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: BasicClusters "
+             + edm::TypeID (typeid (reco::BasicClusterCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
 #ifdef CMSSW_2_2_X
 
 const std::string
-ISpyBasicCluster::algoName (reco::AlgoId key) 
+ISpyBasicCluster::algoName (reco::AlgoId key) const
 { 
   std::map<reco::AlgoId, std::string> type; 
     
@@ -170,7 +173,7 @@ ISpyBasicCluster::algoName (reco::AlgoId key)
 #else
 
 const std::string
-ISpyBasicCluster::algoName (reco::CaloCluster::AlgoId key)
+ISpyBasicCluster::algoName (reco::CaloCluster::AlgoId key) const
 {
   std::map<reco::CaloCluster::AlgoId, std::string> type;
 
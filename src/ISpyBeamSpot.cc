@@ -16,9 +16,12 @@ using namespace edm::service;
 using namespace edm;
 
 ISpyBeamSpot::ISpyBeamSpot(const edm::ParameterSet& iConfig)
-: inputTag_(iConfig.getParameter<edm::InputTag>("iSpyBeamSpotTag")){}
+: inputTag_(iConfig.getParameter<edm::InputTag>("iSpyBeamSpotTag"))
+{
+  beamSpotToken_ = consumes<reco::BeamSpot>(inputTag_);
+}
 
-void ISpyBeamSpot::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyBeamSpot::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -31,10 +34,13 @@ void ISpyBeamSpot::analyze(const edm::Event& event, const edm::EventSetup& event
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<reco::BeamSpot> collection;
-  event.getByLabel(inputTag_, collection);
+  event.getByToken(beamSpotToken_, collection);
 
   if ( collection.isValid() )
   {
@@ -44,10 +50,7 @@ void ISpyBeamSpot::analyze(const edm::Event& event, const edm::EventSetup& event
                            + inputTag_.instance() + ":"
                            + inputTag_.process();
 
-     IgCollection& products = storage->getCollection("Products_V1");
-     IgProperty PROD = products.addProperty("Product", std::string ());
-     IgCollectionItem item = products.create();
-     item[PROD] = product;
+     config->product(sid, product);
 
      IgCollection& beamSpot = storage->getCollection("BeamSpot_V1");
 
@@ -68,11 +71,12 @@ void ISpyBeamSpot::analyze(const edm::Event& event, const edm::EventSetup& event
 
    else
    {
-     std::string error = "### Error: BeamSpot "
-                         + edm::TypeID (typeid (reco::BeamSpot)).friendlyClassName() + ":"
-                          + inputTag_.label() + ":"
-                          + inputTag_.instance() + " not found";
-      config->error(error);
+     config->error (sid, &inputTag_, [&] {
+       return "### Error: BeamSpot "
+              + edm::TypeID (typeid (reco::BeamSpot)).friendlyClassName() + ":"
+              + inputTag_.label() + ":"
+              + inputTag_.instance() + " not found";
+     });
   }
  
 }
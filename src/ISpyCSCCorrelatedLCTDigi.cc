@@ -28,7 +28,7 @@ ISpyCSCCorrelatedLCTDigi::ISpyCSCCorrelatedLCTDigi(const edm::ParameterSet& iCon
   digiToken_ = consumes<CSCCorrelatedLCTDigiCollection>(inputTag_);
 }
 
-void ISpyCSCCorrelatedLCTDigi::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyCSCCorrelatedLCTDigi::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -41,16 +41,18 @@ void ISpyCSCCorrelatedLCTDigi::analyze(const edm::Event& event, const edm::Event
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<CSCGeometry> geom;
-  eventSetup.get<MuonGeometryRecord>().get(geom);
+  const CSCGeometry* geom = config->esContext(sid, eventSetup).cscGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyCSCCorrelatedLCTDigi::analyze: Invalid MuonGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -65,10 +67,7 @@ void ISpyCSCCorrelatedLCTDigi::analyze(const edm::Event& event, const edm::Event
 			  + inputTag_.instance() + ":"
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& digis = storage->getCollection("CSCCorrelatedLCTDigis_V2");
 
@@ -170,12 +169,13 @@ void ISpyCSCCorrelatedLCTDigi::analyze(const edm::Event& event, const edm::Event
   }
   else
   {
-    std::string error = "### Error: CSCLCTDigis "
-			+ edm::TypeID (typeid (CSCCorrelatedLCTDigiCollection)).friendlyClassName() + ":"
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":"
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: CSCLCTDigis "
+             + edm::TypeID (typeid (CSCCorrelatedLCTDigiCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
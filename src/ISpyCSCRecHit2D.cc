@@ -33,7 +33,7 @@ ISpyCSCRecHit2D::ISpyCSCRecHit2D(const edm::ParameterSet& iConfig)
   rechitToken_ = consumes<CSCRecHit2DCollection>(inputTag_); 
 }
 
-void ISpyCSCRecHit2D::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyCSCRecHit2D::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   
@@ -46,17 +46,19 @@ void ISpyCSCRecHit2D::analyze(const edm::Event& event, const edm::EventSetup& ev
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<CSCGeometry> geom;
-  eventSetup.get<MuonGeometryRecord> ().get (geom);
+  const CSCGeometry* geom = config->esContext(sid, eventSetup).cscGeometry();
  
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyCSCRecHit2D::analyze: Invalid MuonGeometryRecord ";
     
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -71,10 +73,7 @@ void ISpyCSCRecHit2D::analyze(const edm::Event& event, const edm::EventSetup& ev
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& recHits = storage->getCollection("CSCRecHit2Ds_V2");
 
@@ -110,7 +109,11 @@ void ISpyCSCRecHit2D::analyze(const edm::Event& event, const edm::EventSetup& ev
       float dx = sqrt(it->localPositionError().xx());
       float dy = sqrt(it->localPositionError().yy());
           
-      GlobalPoint gp;
+      GlobalPoint gp = det->surface().toGlobal(xyzLocal);
+
+      if ( ! config->inRegionOfInterest(sid, gp.eta(), gp.phi()) )
+        continue;
+
       IgCollectionItem irechit = recHits.create();
 
       gp = det->surface().toGlobal(LocalPoint((x - dx), y, z));
@@ -164,12 +167,13 @@ void ISpyCSCRecHit2D::analyze(const edm::Event& event, const edm::EventSetup& ev
 
   else
   {
-    std::string error = "### Error: CSCRecHit2Ds "
-                        + edm::TypeID (typeid (CSCRecHit2DCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: CSCRecHit2Ds "
+             + edm::TypeID (typeid (CSCRecHit2DCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -28,7 +28,7 @@ ISpyCSCSegment::ISpyCSCSegment (const edm::ParameterSet& iConfig)
 }
 
 void 
-ISpyCSCSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyCSCSegment::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -41,16 +41,18 @@ ISpyCSCSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSe
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
    
-  edm::ESHandle<CSCGeometry> geom;
-  eventSetup.get<MuonGeometryRecord> ().get (geom);
+  const CSCGeometry* geom = config->esContext(sid, eventSetup).cscGeometry();
   
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyCSCSegment::analyze: Invalid MuonGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -65,10 +67,7 @@ ISpyCSCSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSe
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 	
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &segments = storage->getCollection ("CSCSegments_V2");
     IgProperty DET_ID   = segments.addProperty ("detid", int (0)); 
@@ -94,6 +93,7 @@ ISpyCSCSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSe
 
     CSCSegmentCollection::const_iterator it = collection->begin ();
     CSCSegmentCollection::const_iterator end = collection->end ();
+
     for (; it != end; ++it) 
     {
       IgCollectionItem isegment = segments.create ();
@@ -198,12 +198,13 @@ ISpyCSCSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSe
   }
   else 
   {
-    std::string error = "### Error: CSCSegments "
-			+ edm::TypeID (typeid (CSCSegmentCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: CSCSegments "
+             + edm::TypeID (typeid (CSCSegmentCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
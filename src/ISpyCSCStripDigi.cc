@@ -18,6 +18,8 @@
 #include "DataFormats/MuonDetId/interface/CSCDetId.h"
 #include "DataFormats/CSCDigi/interface/CSCStripDigi.h"
 
+#include <algorithm>
+
 using namespace edm::service;
 using namespace edm;
 
@@ -28,7 +30,7 @@ ISpyCSCStripDigi::ISpyCSCStripDigi(const edm::ParameterSet& iConfig)
   digiToken_ = consumes<CSCStripDigiCollection>(inputTag_);
 }
 
-void ISpyCSCStripDigi::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyCSCStripDigi::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -41,16 +43,18 @@ void ISpyCSCStripDigi::analyze(const edm::Event& event, const edm::EventSetup& e
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<CSCGeometry> geom;
-  eventSetup.get<MuonGeometryRecord>().get(geom);
+  const CSCGeometry* geom = config->esContext(sid, eventSetup).cscGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyCSCStripDigi::analyze: Invalid MuonGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -65,10 +69,7 @@ void ISpyCSCStripDigi::analyze(const edm::Event& event, const edm::EventSetup& e
 			  + inputTag_.instance() + ":"
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& digis = storage->getCollection("CSCStripDigis_V2");
 
@@ -83,29 +84,44 @@ void ISpyCSCStripDigi::analyze(const edm::Event& event, const edm::EventSetup& e
     for ( CSCStripDigiCollection::DigiRangeIterator dri = collection->begin(), driEnd = collection->end();
 	  dri != driEnd; ++dri )
     {
-      const CSCDetId& cscDetId = (*dri).first;
+      const CSCDetId& id = (*dri).first;
       const CSCStripDigiCollection::Range& range = (*dri).second;
 
+      // All the digis of the range are in this layer
+      const CSCLayer* layer = geom->layer(id);
+      const CSCLayerGeometry* layerGeom = layer->geometry();
+
+      std::pair<float, float> yLIM = layerGeom->yLimitsOfStripPlane();
+      const float yB = yLIM.first;
+      const float yT = yLIM.second;
+
+      const int endcap = id.endcap();
+      const int station = id.station();
+      const int ring = id.ring();
+      const int chamber = id.chamber();
+
       for(CSCStripDigiCollection::const_iterator dit = range.first;
 	    dit != range.second; ++dit)
       {      
-	CSCDetId id = cscDetId;
-	std::vector<int> adcCounts = (*dit).getADCCounts();
+	const std::vector<int>& adcCounts = (*dit).getADCCounts();
+
+	if ( adcCounts.size() < 2 )
+	  continue;
+
+	// The pedestal is the mean of the first two samples; the digi
+	// is kept if any sample is above it by more than the offset
+	const int signalThreshold = (adcCounts[0] + adcCounts[1])/2 + thresholdOffset_;
+	int maxCount = adcCounts[0];
 
-	int signalThreshold = (adcCounts[0] + adcCounts[1])/2 + thresholdOffset_;  
-            
-	if ( std::find_if(adcCounts.begin(),adcCounts.end(),bind2nd(std::greater<int>(),signalThreshold)) != adcCounts.end() ) 
+	for ( size_t i = 1, n = adcCounts.size(); i != n; ++i )
+	  maxCount = std::max(maxCount, adcCounts[i]);
+
+	if ( maxCount > signalThreshold ) 
 	{
 	  IgCollectionItem digi = digis.create();
 
 	  int stripId = (*dit).getStrip();
 
-	  const CSCLayer* layer = geom->layer(id);
-      	  const CSCLayerGeometry* layerGeom = layer->geometry();
-
-	  std::pair<float, float> yLIM = layerGeom->yLimitsOfStripPlane();
-          float yB = yLIM.first;
-          float yT = yLIM.second;
 	  float xB = layerGeom->xOfStrip(stripId, yB);
 	  float xT = layerGeom->xOfStrip(stripId, yT);
 	  GlobalPoint gST = layer->toGlobal( LocalPoint( xT, yT, 0. ) );
@@ -118,22 +134,23 @@ void ISpyCSCStripDigi::analyze(const edm::Event& event, const edm::EventSetup& e
 	  		     static_cast<double>(gSB.y()/100.0),
       	 		     static_cast<double>(gSB.z()/100.0));
 
-	  digi[EC] = static_cast<int>(id.endcap());
-	  digi[ST] = static_cast<int>(id.station());
-	  digi[RG] = static_cast<int>(id.ring());
-	  digi[CH] = static_cast<int>(id.chamber());
+	  digi[EC] = endcap;
+	  digi[ST] = station;
+	  digi[RG] = ring;
+	  digi[CH] = chamber;
 	}
       }      
     }
   }
   else
   {
-    std::string error = "### Error: CSCStripDigis "
-			+ edm::TypeID (typeid (CSCStripDigiCollection)).friendlyClassName() + ":"
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":"
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: CSCStripDigis "
+             + edm::TypeID (typeid (CSCStripDigiCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -27,7 +27,7 @@ ISpyCSCWireDigi::ISpyCSCWireDigi(const edm::ParameterSet& iConfig)
   digiToken_ = consumes<CSCWireDigiCollection>(inputTag_);
 }
 
-void ISpyCSCWireDigi::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyCSCWireDigi::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -40,16 +40,18 @@ void ISpyCSCWireDigi::analyze(const edm::Event& event, const edm::EventSetup& ev
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<CSCGeometry> geom;
-  eventSetup.get<MuonGeometryRecord>().get(geom);
+  const CSCGeometry* geom = config->esContext(sid, eventSetup).cscGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyCSCWireDigi::analyze: Invalid MuonGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -64,10 +66,7 @@ void ISpyCSCWireDigi::analyze(const edm::Event& event, const edm::EventSetup& ev
 			  + inputTag_.instance() + ":"
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& digis = storage->getCollection("CSCWireDigis_V2");
 
@@ -115,12 +114,13 @@ void ISpyCSCWireDigi::analyze(const edm::Event& event, const edm::EventSetup& ev
   }
   else
   {
-    std::string error = "### Error: CSCWireDigis "
-			+ edm::TypeID (typeid (CSCWireDigiCollection)).friendlyClassName() + ":"
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":"
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: CSCWireDigis "
+             + edm::TypeID (typeid (CSCWireDigiCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
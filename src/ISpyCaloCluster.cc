@@ -24,10 +24,12 @@ using namespace edm::service;
 
 ISpyCaloCluster::ISpyCaloCluster (const edm::ParameterSet& iConfig)
   : inputTag_(iConfig.getParameter<edm::InputTag>("iSpyCaloClusterTag"))
-{}
+{
+  clusterToken_ = consumes<reco::BasicClusterCollection>(inputTag_);
+}
 
 void 
-ISpyCaloCluster::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyCaloCluster::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   
@@ -39,22 +41,24 @@ ISpyCaloCluster::analyze (const edm::Event& event, const edm::EventSetup& eventS
       "You must add the service in the configuration file\n"
       "or remove the module that requires it";
   }
+
+  if ( config->pruned(moduleDescription().id()) )
+    return;
    
-  IgDataStorage* storage = config->storage();
+  IgDataStorage* storage = config->storage(sid);
 
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord> ().get (geom);
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyCaloCluster::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
     
   edm::Handle<reco::BasicClusterCollection> collection;
-  event.getByLabel (inputTag_, collection);
+  event.getByToken (clusterToken_, collection);
  
   if ( collection.isValid ())
   {	    	
@@ -64,10 +68,7 @@ ISpyCaloCluster::analyze (const edm::Event& event, const edm::EventSetup& eventS
                           + inputTag_.instance() + ":" 
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
     
     IgCollection& clusters = storage->getCollection("CaloClusters_V1");
     IgProperty E    = clusters.addProperty("energy", 0.0);
@@ -101,7 +102,8 @@ ISpyCaloCluster::analyze (const edm::Event& event, const edm::EventSetup& eventS
       c[ALGO] = algoName((*ci).algo());
 
       std::vector<std::pair<DetId, float> > hitsAndFractions = (*ci).hitsAndFractions();
-      
+
+
       for ( std::vector<std::pair<DetId, float> >::iterator hi = 
               hitsAndFractions.begin(), hie = hitsAndFractions.end(); hi != hie; ++hi )
       {
@@ -109,7 +111,7 @@ ISpyCaloCluster::analyze (const edm::Event& event, const edm::EventSetup& eventS
         rhf[DETID] = (*hi).first;
         rhf[FRACT] = static_cast<double>((*hi).second);
 
-        auto cell = (*geom).getGeometry((*hi).first);
+        auto cell = geom->getGeometry((*hi).first);
         const CaloCellGeometry::CornersVec& corners = cell->getCorners();
         
         assert(corners.size() == 8);
@@ -131,16 +133,17 @@ ISpyCaloCluster::analyze (const edm::Event& event, const edm::EventSetup& eventS
 
   else 
   {
-    std::string error = "### Error: CaloClusters "
-                        + edm::TypeID (typeid (reco::BasicClusterCollection)).friendlyClassName () + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: CaloClusters "
+             + edm::TypeID (typeid (reco::BasicClusterCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
-const std::string ISpyCaloCluster::algoName(reco::CaloCluster::AlgoId algoId)
+const std::string ISpyCaloCluster::algoName(reco::CaloCluster::AlgoId algoId) const
 {
   if ( algoId == reco::CaloCluster::island )
     return "island";
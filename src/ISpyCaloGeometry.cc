@@ -27,10 +27,18 @@
 using namespace edm::service;
 
 ISpyCaloGeometry::ISpyCaloGeometry(const edm::ParameterSet& iPSet)
+  : cacheIdentifier_(0),
+    timer_(iPSet.getUntrackedParameter<unsigned int>("benchmarkRepeat", 0))
 {}
 
 void
-ISpyCaloGeometry::analyze( const edm::Event& event, const edm::EventSetup& eventSetup) 
+ISpyCaloGeometry::endJob(void)
+{
+  timer_.report("ISpyCaloGeometry");
+}
+
+void
+ISpyCaloGeometry::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {    
   edm::Service<ISpyService> config;
   if (! config.isAvailable ()) 
@@ -42,11 +50,19 @@ ISpyCaloGeometry::analyze( const edm::Event& event, const edm::EventSetup& event
       "or remove the module that requires it";
   }
  
-  eventSetup.get<CaloGeometryRecord> ().get (caloGeom_);
+  const CaloGeometryRecord& record = eventSetup.get<CaloGeometryRecord> ();
+
+  std::lock_guard<std::mutex> lock (mutex_);
+
+  if (record.cacheIdentifier () == cacheIdentifier_)
+    return;
+
+  cacheIdentifier_ = record.cacheIdentifier ();
+  record.get (caloGeom_);
  
-  IgDataStorage *storage  = config->esStorage ();
+  IgDataStorage *storage  = config->esStorage(sid);
      
-  if (caloGeom_.isValid () && watch_caloGeom_.check (eventSetup))
+  if (caloGeom_.isValid ())
   {
     buildCalo3D (storage);
     buildCaloRPhi (storage);
@@ -56,47 +72,47 @@ ISpyCaloGeometry::analyze( const edm::Event& event, const edm::EventSetup& event
 }
 
 void
-ISpyCaloGeometry::buildCalo3D (IgDataStorage *storage)
+ISpyCaloGeometry::buildCalo3D (IgDataStorage *storage) const
 {
-  build3D (storage, "EcalBarrel3D_V1", DetId::Ecal, EcalBarrel);
-  buildEndcap3D (storage, "EcalEndcapPlus3D_V1", DetId::Ecal, EcalEndcap, 1);
-  buildEndcap3D (storage, "EcalEndcapMinus3D_V1", DetId::Ecal, EcalEndcap, -1);
+  timer_.run("build3D EcalBarrel3D_V1", storage, [&](IgDataStorage *s) { build3D (s, "EcalBarrel3D_V1", DetId::Ecal, EcalBarrel); });
+  timer_.run("buildEndcap3D EcalEndcapPlus3D_V1", storage, [&](IgDataStorage *s) { buildEndcap3D (s, "EcalEndcapPlus3D_V1", DetId::Ecal, EcalEndcap, 1); });
+  timer_.run("buildEndcap3D EcalEndcapMinus3D_V1", storage, [&](IgDataStorage *s) { buildEndcap3D (s, "EcalEndcapMinus3D_V1", DetId::Ecal, EcalEndcap, -1); });
 
   // build3D (storage, "EcalPreshower3D_V1", DetId::Ecal, EcalPreshower);
-  build3D (storage, "HcalBarrel3D_V1", DetId::Hcal, HcalBarrel);
+  timer_.run("build3D HcalBarrel3D_V1", storage, [&](IgDataStorage *s) { build3D (s, "HcalBarrel3D_V1", DetId::Hcal, HcalBarrel); });
 
-  buildEndcap3D (storage, "HcalEndcapPlus3D_V1", DetId::Hcal, HcalEndcap, 1);
-  buildEndcap3D (storage, "HcalEndcapMinus3D_V1", DetId::Hcal, EcalEndcap, -1);
+  timer_.run("buildEndcap3D HcalEndcapPlus3D_V1", storage, [&](IgDataStorage *s) { buildEndcap3D (s, "HcalEndcapPlus3D_V1", DetId::Hcal, HcalEndcap, 1); });
+  timer_.run("buildEndcap3D HcalEndcapMinus3D_V1", storage, [&](IgDataStorage *s) { buildEndcap3D (s, "HcalEndcapMinus3D_V1", DetId::Hcal, EcalEndcap, -1); });
 
-  build3D (storage, "HcalOuter3D_V1", DetId::Hcal, HcalOuter);
+  timer_.run("build3D HcalOuter3D_V1", storage, [&](IgDataStorage *s) { build3D (s, "HcalOuter3D_V1", DetId::Hcal, HcalOuter); });
 
-  buildEndcap3D (storage, "HcalForwardPlus3D_V1", DetId::Hcal, HcalForward, 1);
-  buildEndcap3D (storage, "HcalForwardMinus3D_V1", DetId::Hcal, HcalForward, -1);
+  timer_.run("buildEndcap3D HcalForwardPlus3D_V1", storage, [&](IgDataStorage *s) { buildEndcap3D (s, "HcalForwardPlus3D_V1", DetId::Hcal, HcalForward, 1); });
+  timer_.run("buildEndcap3D HcalForwardMinus3D_V1", storage, [&](IgDataStorage *s) { buildEndcap3D (s, "HcalForwardMinus3D_V1", DetId::Hcal, HcalForward, -1); });
 }
 
 void
-ISpyCaloGeometry::buildCaloRPhi (IgDataStorage *storage)
+ISpyCaloGeometry::buildCaloRPhi (IgDataStorage *storage) const
 {
-  buildRPhi (storage, "EcalBarrelRPhi_V1", DetId::Ecal, EcalBarrel, 3.0);
-  buildRPhi (storage, "HcalBarrelRPhi_V1", DetId::Hcal, HcalBarrel, 10.0);
-  buildRPhi (storage, "HcalOuterRPhi_V1", DetId::Hcal, HcalOuter, 20.0);
+  timer_.run("buildRPhi EcalBarrelRPhi_V1", storage, [&](IgDataStorage *s) { buildRPhi (s, "EcalBarrelRPhi_V1", DetId::Ecal, EcalBarrel, 3.0); });
+  timer_.run("buildRPhi HcalBarrelRPhi_V1", storage, [&](IgDataStorage *s) { buildRPhi (s, "HcalBarrelRPhi_V1", DetId::Hcal, HcalBarrel, 10.0); });
+  timer_.run("buildRPhi HcalOuterRPhi_V1", storage, [&](IgDataStorage *s) { buildRPhi (s, "HcalOuterRPhi_V1", DetId::Hcal, HcalOuter, 20.0); });
 }
 
 void
-ISpyCaloGeometry::buildCaloRZ (IgDataStorage *storage)
+ISpyCaloGeometry::buildCaloRZ (IgDataStorage *storage) const
 {
   double phiStart = M_PI / 2.0;
-  buildRZ (storage, "EcalBarrelRZ_V1", DetId::Ecal, EcalBarrel, phiStart, M_PI / 160.0);
-  buildRZ (storage, "EcalEndcapRZ_V1", DetId::Ecal, EcalEndcap, phiStart, M_PI / 40.0);
-  buildRZ (storage, "EcalPreshowerRZ_V1", DetId::Ecal, EcalPreshower, phiStart, M_PI / 40.0);
-  buildRZ (storage, "HcalBarrelRZ_V1", DetId::Hcal, HcalBarrel, phiStart, M_PI / 30.0);
-  buildRZ (storage, "HcalEndcapRZ_V1", DetId::Hcal, HcalEndcap, phiStart, M_PI / 20.0);
-  buildRZ (storage, "HcalOuterRZ_V1", DetId::Hcal, HcalOuter, phiStart, M_PI / 30.0);
-  buildRZ (storage, "HcalForwardRZ_V1", DetId::Hcal, HcalForward, phiStart, M_PI / 20.0);
+  timer_.run("buildRZ EcalBarrelRZ_V1", storage, [&](IgDataStorage *s) { buildRZ (s, "EcalBarrelRZ_V1", DetId::Ecal, EcalBarrel, phiStart, M_PI / 160.0); });
+  timer_.run("buildRZ EcalEndcapRZ_V1", storage, [&](IgDataStorage *s) { buildRZ (s, "EcalEndcapRZ_V1", DetId::Ecal, EcalEndcap, phiStart, M_PI / 40.0); });
+  timer_.run("buildRZ EcalPreshowerRZ_V1", storage, [&](IgDataStorage *s) { buildRZ (s, "EcalPreshowerRZ_V1", DetId::Ecal, EcalPreshower, phiStart, M_PI / 40.0); });
+  timer_.run("buildRZ HcalBarrelRZ_V1", storage, [&](IgDataStorage *s) { buildRZ (s, "HcalBarrelRZ_V1", DetId::Hcal, HcalBarrel, phiStart, M_PI / 30.0); });
+  timer_.run("buildRZ HcalEndcapRZ_V1", storage, [&](IgDataStorage *s) { buildRZ (s, "HcalEndcapRZ_V1", DetId::Hcal, HcalEndcap, phiStart, M_PI / 20.0); });
+  timer_.run("buildRZ HcalOuterRZ_V1", storage, [&](IgDataStorage *s) { buildRZ (s, "HcalOuterRZ_V1", DetId::Hcal, HcalOuter, phiStart, M_PI / 30.0); });
+  timer_.run("buildRZ HcalForwardRZ_V1", storage, [&](IgDataStorage *s) { buildRZ (s, "HcalForwardRZ_V1", DetId::Hcal, HcalForward, phiStart, M_PI / 20.0); });
 }
 
 void
-ISpyCaloGeometry::build3D (IgDataStorage *storage, const std::string &name, DetId::Detector det, int subdetn) 
+ISpyCaloGeometry::build3D (IgDataStorage *storage, const std::string &name, DetId::Detector det, int subdetn) const
 {
   IgCollection &geometry = storage->getCollection (name.c_str ());  
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -152,7 +168,7 @@ ISpyCaloGeometry::build3D (IgDataStorage *storage, const std::string &name, DetI
 
 
 void
-ISpyCaloGeometry::buildEndcap3D (IgDataStorage *storage, const std::string &name, DetId::Detector det, int subdetn, int side) 
+ISpyCaloGeometry::buildEndcap3D (IgDataStorage *storage, const std::string &name, DetId::Detector det, int subdetn, int side) const
 {
   IgCollection &geometry = storage->getCollection (name.c_str ());  
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -220,7 +236,7 @@ ISpyCaloGeometry::buildEndcap3D (IgDataStorage *storage, const std::string &name
 
 
 void
-ISpyCaloGeometry::buildRPhi (IgDataStorage *storage, const std::string &name, DetId::Detector det, int subdetn, double width) 
+ISpyCaloGeometry::buildRPhi (IgDataStorage *storage, const std::string &name, DetId::Detector det, int subdetn, double width) const
 {
   IgCollection &geometry = storage->getCollection (name.c_str ());  
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -277,7 +293,7 @@ ISpyCaloGeometry::buildRPhi (IgDataStorage *storage, const std::string &name, De
 }
 
 void
-ISpyCaloGeometry::buildRZ (IgDataStorage *storage, const std::string &name, DetId::Detector det, int subdetn, double p0, double pD) 
+ISpyCaloGeometry::buildRZ (IgDataStorage *storage, const std::string &name, DetId::Detector det, int subdetn, double p0, double pD) const
 {
   IgCollection &geometry = storage->getCollection (name.c_str ());  
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -341,7 +357,7 @@ ISpyCaloGeometry::buildRZ (IgDataStorage *storage, const std::string &name, DetI
 }
 
 const std::string
-ISpyCaloGeometry::subDetName (HcalSubdetector key) 
+ISpyCaloGeometry::subDetName (HcalSubdetector key) const
 { 
   std::map<HcalSubdetector, std::string> type; 
     
@@ -357,7 +373,7 @@ ISpyCaloGeometry::subDetName (HcalSubdetector key)
 }
 
 const std::string
-ISpyCaloGeometry::otherSubDetName (HcalOtherSubdetector key) 
+ISpyCaloGeometry::otherSubDetName (HcalOtherSubdetector key) const
 { 
   std::map<HcalOtherSubdetector, std::string> type; 
     
@@ -22,9 +22,12 @@ using namespace edm;
 
 ISpyCaloHit::ISpyCaloHit(const edm::ParameterSet& iConfig)
   : inputTags_(iConfig.getParameter<std::vector<edm::InputTag> >("iSpyCaloHitTags"))
-{}
+{
+  for ( VInputTag::const_iterator ti = inputTags_.begin(); ti != inputTags_.end(); ++ti )
+    hitTokens_.push_back(consumes<PCaloHitContainer>(*ti));
+}
 
-void ISpyCaloHit::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyCaloHit::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -37,16 +40,18 @@ void ISpyCaloHit::analyze(const edm::Event& event, const edm::EventSetup& eventS
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord>().get(geom);
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyCaloHit::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -54,7 +59,7 @@ void ISpyCaloHit::analyze(const edm::Event& event, const edm::EventSetup& eventS
       ti != inputTags_.end(); ++ti)
   {
     edm::Handle<PCaloHitContainer> collection;
-    event.getByLabel(*ti, collection);
+    event.getByToken(hitTokens_[ti - inputTags_.begin()], collection);
 
     if(collection.isValid())
     {
@@ -64,10 +69,7 @@ void ISpyCaloHit::analyze(const edm::Event& event, const edm::EventSetup& eventS
 			    + inputTag_.instance() + ":"
 			    + inputTag_.process();
 
-      IgCollection& products = storage->getCollection("Products_V1");
-      IgProperty PROD = products.addProperty("Product", std::string ());
-      IgCollectionItem item = products.create();
-      item[PROD] = product;
+      config->product(sid, product);
 
       IgCollection& hits = storage->getCollection("PCaloHits_V1");
 
@@ -94,7 +96,7 @@ void ISpyCaloHit::analyze(const edm::Event& event, const edm::EventSetup& eventS
       {
 	const DetId detid ((*i).id());
 
-	auto cell = (*geom).getGeometry(detid);
+	auto cell = geom->getGeometry(detid);
 	const CaloCellGeometry::CornersVec& corners = cell->getCorners();
 	const GlobalPoint& pos = cell->getPosition();
         
@@ -179,12 +181,13 @@ void ISpyCaloHit::analyze(const edm::Event& event, const edm::EventSetup& eventS
     }
     else
     {
-      std::string error = "### Error: CaloHits "
-			  + edm::TypeID (typeid (PCaloHitContainer)).friendlyClassName() + ":"
-			  + (*ti).label() + ":"
-			  + (*ti).instance() + ":"
-			  + (*ti).process() + " are not found.";
-      config->error (error);
+      config->error (sid, &(*ti), [&] {
+        return "### Error: CaloHits "
+               + edm::TypeID (typeid (PCaloHitContainer)).friendlyClassName() + ":"
+               + (*ti).label() + ":"
+               + (*ti).instance() + ":"
+               + (*ti).process() + " are not found.";
+      });
     }
   }
 }
@@ -23,7 +23,7 @@ ISpyCaloMET::ISpyCaloMET(const edm::ParameterSet& iConfig)
   metToken_ = consumes<CaloMETCollection>(inputTag_);
 }
 
-void ISpyCaloMET::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyCaloMET::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -36,7 +36,10 @@ void ISpyCaloMET::analyze(const edm::Event& event, const edm::EventSetup& eventS
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<CaloMETCollection> collection;
   event.getByToken(metToken_, collection);
@@ -49,10 +52,7 @@ void ISpyCaloMET::analyze(const edm::Event& event, const edm::EventSetup& eventS
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& mets = storage->getCollection("CaloMETs_V1");
 
@@ -62,7 +62,6 @@ void ISpyCaloMET::analyze(const edm::Event& event, const edm::EventSetup& eventS
     IgProperty PY = mets.addProperty("py", 0.0);
     IgProperty PZ = mets.addProperty("pz", 0.0);
    
- 
     for( CaloMETCollection::const_iterator it = collection->begin (), itEnd = collection->end (); it != itEnd; ++it)
     {
       IgCollectionItem m = mets.create();
@@ -77,11 +76,12 @@ void ISpyCaloMET::analyze(const edm::Event& event, const edm::EventSetup& eventS
 
   else
   {
-    std::string error = "### Error: CaloMETs "
-                        + edm::TypeID (typeid (CaloMETCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + " are not found";
-    config->error(error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: CaloMETs "
+             + edm::TypeID (typeid (CaloMETCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + " are not found";
+    });
   }
 }
 
@@ -28,7 +28,7 @@ ISpyCaloTower::ISpyCaloTower (const edm::ParameterSet& iConfig)
 }
 
 void
-ISpyCaloTower::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyCaloTower::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   
@@ -40,16 +40,18 @@ ISpyCaloTower::analyze( const edm::Event& event, const edm::EventSetup& eventSet
       "You must add the service in the configuration file\n"
       "or remove the module that requires it";
   }
+
+  if ( config->pruned(moduleDescription().id()) )
+    return;
     
   edm::Handle<CaloTowerCollection> collection;
   event.getByToken(caloTowerToken_, collection);
 
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord> ().get (geom);
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
 
-  if (collection.isValid () && geom.isValid ())
+  if (collection.isValid () && geom)
   {	    
-    IgDataStorage *storage = config->storage ();
+    IgDataStorage *storage = config->storage(sid);
 
     std::string product = "CaloTowers "
 			  + edm::TypeID (typeid (CaloTowerCollection)).friendlyClassName () + ":" 
@@ -57,10 +59,7 @@ ISpyCaloTower::analyze( const edm::Event& event, const edm::EventSetup& eventSet
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &caloTowers = storage->getCollection("CaloTowers_V2");
     IgProperty ET   = caloTowers.addProperty("et", 0.0);
@@ -88,7 +87,7 @@ ISpyCaloTower::analyze( const edm::Event& event, const edm::EventSetup& eventSet
 
     for (CaloTowerCollection::const_iterator it=collection->begin(), itEnd=collection->end(); it!=itEnd; ++it)
     {
-      auto cell = (*geom).getGeometry((*it).id());
+      auto cell = geom->getGeometry((*it).id());
 
       const CaloCellGeometry::CornersVec& corners = cell->getCorners();
       assert(corners.size()==8);
@@ -123,12 +122,13 @@ ISpyCaloTower::analyze( const edm::Event& event, const edm::EventSetup& eventSet
   }
   else 
   {
-    std::string error = "### Error: CaloTowers "
-			+ edm::TypeID (typeid (CaloTowerCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: CaloTowers "
+             + edm::TypeID (typeid (CaloTowerCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
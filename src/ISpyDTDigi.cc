@@ -24,7 +24,7 @@ ISpyDTDigi::ISpyDTDigi(const edm::ParameterSet& iConfig)
   digiToken_ = consumes<DTDigiCollection>(inputTag_);
 }
 
-void ISpyDTDigi::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyDTDigi::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -37,16 +37,18 @@ void ISpyDTDigi::analyze (const edm::Event& event, const edm::EventSetup& eventS
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<DTGeometry> geom;
-  eventSetup.get<MuonGeometryRecord>().get(geom);
+  const DTGeometry* geom = config->esContext(sid, eventSetup).dtGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyDTDigi::analyze: Invalid MuonGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -61,10 +63,7 @@ void ISpyDTDigi::analyze (const edm::Event& event, const edm::EventSetup& eventS
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& digis = storage->getCollection("DTDigis_V1");
 
@@ -155,12 +154,13 @@ void ISpyDTDigi::analyze (const edm::Event& event, const edm::EventSetup& eventS
   }
   else 
   {
-    std::string error = "### Error: DTDigis "
-			+ edm::TypeID (typeid (DTDigiCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: DTDigis "
+             + edm::TypeID (typeid (DTDigiCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
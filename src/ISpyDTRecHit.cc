@@ -27,7 +27,7 @@ ISpyDTRecHit::ISpyDTRecHit(const edm::ParameterSet& iConfig)
   rechitToken_ = consumes<DTRecHitCollection>(inputTag_);
 }
 
-void ISpyDTRecHit::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyDTRecHit::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -40,16 +40,18 @@ void ISpyDTRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<DTGeometry> geom;
-  eventSetup.get<MuonGeometryRecord>().get(geom);
+  const DTGeometry* geom = config->esContext(sid, eventSetup).dtGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyDTRecHit::analyze: Invalid MuonGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -64,10 +66,7 @@ void ISpyDTRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& recHits = storage->getCollection("DTRecHits_V1");
 
@@ -97,6 +96,13 @@ void ISpyDTRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
     for ( DTRecHitCollection::const_iterator dit = collection->begin();
 	  dit != collection->end(); ++dit )
     {
+      const DTLayer* layer = geom->layer((*dit).wireId());  
+
+      GlobalPoint center = layer->toGlobal((*dit).localPosition());
+
+      if ( ! config->inRegionOfInterest(sid, center.eta(), center.phi()) )
+        continue;
+
       IgCollectionItem recHit = recHits.create();
 
       const DTRecHit1D* lrechit = (*dit).componentRecHit(Left);
@@ -123,7 +129,6 @@ void ISpyDTRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
       double digitime = (*dit).digiTime();
       recHit[DIGITIME] = static_cast<double>(digitime);
 
-      const DTLayer* layer = geom->layer((*dit).wireId());  
       const DTTopology& topo = layer->specificTopology();
 
       const GeomDetUnit* det = geom->idToDetUnit((*dit).wireId().layerId());
@@ -199,12 +204,13 @@ void ISpyDTRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
     
   else 
   {
-    std::string error = "### Error: DTRecHits "
-			+ edm::TypeID (typeid (DTRecHitCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: DTRecHits "
+             + edm::TypeID (typeid (DTRecHitCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -24,7 +24,7 @@ ISpyDTRecSegment4D::ISpyDTRecSegment4D (const edm::ParameterSet& iConfig)
 }
 
 void 
-ISpyDTRecSegment4D::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyDTRecSegment4D::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -37,16 +37,18 @@ ISpyDTRecSegment4D::analyze (const edm::Event& event, const edm::EventSetup& eve
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<DTGeometry> geom;
-  eventSetup.get<MuonGeometryRecord> ().get (geom);
+  const DTGeometry* geom = config->esContext(sid, eventSetup).dtGeometry();
     
-  if(! geom.isValid())
+  if(! geom)
   {
     std::string error = 
       "### Error: ISpyDTRecHitSegment4D::analyze: Invalid MuonGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -61,10 +63,7 @@ ISpyDTRecSegment4D::analyze (const edm::Event& event, const edm::EventSetup& eve
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 	
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &segments = storage->getCollection ("DTRecSegment4D_V1");
     IgProperty DET_ID   = segments.addProperty ("detid", int (0)); 
@@ -77,6 +76,7 @@ ISpyDTRecSegment4D::analyze (const edm::Event& event, const edm::EventSetup& eve
 
     DTRecSegment4DCollection::const_iterator it = collection->begin ();
     DTRecSegment4DCollection::const_iterator end = collection->end ();
+
     for (; it != end; ++it) 
     {
       DTChamberId chId ((*it).geographicalId ().rawId ());
@@ -109,12 +109,13 @@ ISpyDTRecSegment4D::analyze (const edm::Event& event, const edm::EventSetup& eve
   }
   else 
   {
-    std::string error = "### Error: DTRecSegment4Ds "
-			+ edm::TypeID (typeid (DTRecSegment4DCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: DTRecSegment4Ds "
+             + edm::TypeID (typeid (DTRecSegment4DCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -0,0 +1,168 @@
+#include "ISpy/Analyzers/interface/ISpyESContext.h"
+
+#include "FWCore/Framework/interface/EventSetup.h"
+
+#include "Geometry/CaloGeometry/interface/CaloGeometry.h"
+#include "Geometry/CommonDetUnit/interface/GlobalTrackingGeometry.h"
+#include "Geometry/CSCGeometry/interface/CSCGeometry.h"
+#include "Geometry/DTGeometry/interface/DTGeometry.h"
+#include "Geometry/GEMGeometry/interface/GEMGeometry.h"
+#include "Geometry/Records/interface/CaloGeometryRecord.h"
+#include "Geometry/Records/interface/GlobalTrackingGeometryRecord.h"
+#include "Geometry/Records/interface/MuonGeometryRecord.h"
+#include "Geometry/RPCGeometry/interface/RPCGeometry.h"
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+namespace
+{
+  // Each muon geometry is fetched on its own: a job without, say, the
+  // GEM geometry still gets the others, and that handle stays invalid.
+  template <class T>
+  void
+  getMuonGeometry(const MuonGeometryRecord& record, edm::ESHandle<T>& handle)
+  {
+    handle = edm::ESHandle<T>();
+
+    try
+    {
+      record.get(handle);
+    }
+    catch (cms::Exception&)
+    {
+      // Left invalid
+    }
+  }
+}
+
+ISpyESContext::ISpyESContext(ISpyMuonChamberCache& muonChamberCache)
+  : eventSetup_(0),
+    caloChecked_(false),
+    trackingChecked_(false),
+    fieldChecked_(false),
+    muonChecked_(false),
+    muonCacheIdentifier_(0),
+    muonChamberCache_(muonChamberCache)
+{}
+
+void
+ISpyESContext::reset(const edm::EventSetup* eventSetup)
+{
+  eventSetup_ = eventSetup;
+  caloChecked_ = trackingChecked_ = fieldChecked_ = muonChecked_ = false;
+}
+
+void
+ISpyESContext::updateCalo(void)
+{
+  if ( caloChecked_ )
+    return;
+
+  if ( caloWatcher_.check(*eventSetup_) )
+    eventSetup_->get<CaloGeometryRecord>().get(caloGeometry_);
+
+  caloChecked_ = true;
+}
+
+void
+ISpyESContext::updateTracking(void)
+{
+  if ( trackingChecked_ )
+    return;
+
+  if ( trackingWatcher_.check(*eventSetup_) )
+    eventSetup_->get<GlobalTrackingGeometryRecord>().get(globalTrackingGeometry_);
+
+  trackingChecked_ = true;
+}
+
+void
+ISpyESContext::updateField(void)
+{
+  if ( fieldChecked_ )
+    return;
+
+  if ( fieldWatcher_.check(*eventSetup_) )
+    eventSetup_->get<IdealMagneticFieldRecord>().get(magneticField_);
+
+  fieldChecked_ = true;
+}
+
+void
+ISpyESContext::updateMuon(void)
+{
+  if ( muonChecked_ )
+    return;
+
+  if ( muonWatcher_.check(*eventSetup_) )
+  {
+    const MuonGeometryRecord& record = eventSetup_->get<MuonGeometryRecord>();
+
+    getMuonGeometry(record, dtGeometry_);
+    getMuonGeometry(record, cscGeometry_);
+    getMuonGeometry(record, gemGeometry_);
+    getMuonGeometry(record, rpcGeometry_);
+    muonCacheIdentifier_ = record.cacheIdentifier();
+  }
+
+  muonChecked_ = true;
+}
+
+const CaloGeometry *
+ISpyESContext::caloGeometry(void)
+{
+  updateCalo();
+  return caloGeometry_.isValid() ? caloGeometry_.product() : 0;
+}
+
+const GlobalTrackingGeometry *
+ISpyESContext::globalTrackingGeometry(void)
+{
+  updateTracking();
+  return globalTrackingGeometry_.isValid() ? globalTrackingGeometry_.product() : 0;
+}
+
+const MagneticField *
+ISpyESContext::magneticField(void)
+{
+  updateField();
+  return magneticField_.isValid() ? magneticField_.product() : 0;
+}
+
+const DTGeometry *
+ISpyESContext::dtGeometry(void)
+{
+  updateMuon();
+  return dtGeometry_.isValid() ? dtGeometry_.product() : 0;
+}
+
+const CSCGeometry *
+ISpyESContext::cscGeometry(void)
+{
+  updateMuon();
+  return cscGeometry_.isValid() ? cscGeometry_.product() : 0;
+}
+
+const GEMGeometry *
+ISpyESContext::gemGeometry(void)
+{
+  updateMuon();
+  return gemGeometry_.isValid() ? gemGeometry_.product() : 0;
+}
+
+const RPCGeometry *
+ISpyESContext::rpcGeometry(void)
+{
+  updateMuon();
+  return rpcGeometry_.isValid() ? rpcGeometry_.product() : 0;
+}
+
+unsigned long long
+ISpyESContext::muonGeometryCacheIdentifier(void)
+{
+  updateMuon();
+  return muonCacheIdentifier_;
+}
@@ -29,7 +29,7 @@ ISpyESRecHit::ISpyESRecHit (const edm::ParameterSet& iConfig)
 }
 
 void
-ISpyESRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyESRecHit::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -42,16 +42,18 @@ ISpyESRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
     
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord> ().get (geom);
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyESRecHit::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -66,10 +68,7 @@ ISpyESRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &recHits = storage->getCollection("ESRecHits_V2");
     IgProperty E = recHits.addProperty("energy", 0.0);
@@ -88,7 +87,7 @@ ISpyESRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
 
     for (std::vector<EcalRecHit>::const_iterator it=collection->begin(), itEnd=collection->end(); it!=itEnd; ++it)
     {
-      auto cell = (*geom).getGeometry ((*it).detid ());
+      auto cell = geom->getGeometry ((*it).detid ());
       const CaloCellGeometry::CornersVec& corners = cell->getCorners ();
       const GlobalPoint& pos = cell->getPosition ();
       float energy = (*it).energy ();
@@ -96,6 +95,9 @@ ISpyESRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
       float eta = pos.eta ();
       float phi = pos.phi ();
 
+      if ( ! config->inRegionOfInterest(sid, eta, phi) )
+        continue;
+
       IgCollectionItem irechit = recHits.create();
       irechit[E] = static_cast<double>(energy);
       irechit[ETA] = static_cast<double>(eta);
@@ -135,12 +137,13 @@ ISpyESRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
     
   else 
   {
-    std::string error = "### Error: ESRecHits "
-			+ edm::TypeID (typeid (EcalRecHitCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: ESRecHits "
+             + edm::TypeID (typeid (EcalRecHitCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
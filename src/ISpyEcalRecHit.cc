@@ -25,10 +25,13 @@ using namespace edm::service;
 
 ISpyEcalRecHit::ISpyEcalRecHit (const edm::ParameterSet& iConfig)
   : inputTags_(iConfig.getParameter<std::vector<edm::InputTag> >("iSpyEcalRecHitTags"))
-{}
+{
+  for ( VInputTag::const_iterator ti = inputTags_.begin(); ti != inputTags_.end(); ++ti )
+    rechitTokens_.push_back(consumes<EcalRecHitCollection>(*ti));
+}
 
 void
-ISpyEcalRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyEcalRecHit::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -41,16 +44,18 @@ ISpyEcalRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSe
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
     
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord> ().get (geom);
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyEcalRecHit::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -58,7 +63,7 @@ ISpyEcalRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSe
 	ti != inputTags_.end(); ++ti )
   {
     edm::Handle<EcalRecHitCollection> collection;
-    event.getByLabel (*ti, collection);
+    event.getByToken (rechitTokens_[ti - inputTags_.begin()], collection);
 
     if( collection.isValid () )
     {	    
@@ -68,10 +73,7 @@ ISpyEcalRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSe
 			    + (*ti).instance() + ":" 
 			    + (*ti).process();
 	    
-      IgCollection& products = storage->getCollection("Products_V1");
-      IgProperty PROD = products.addProperty("Product", std::string ());
-      IgCollectionItem item = products.create();
-      item[PROD] = product;
+      config->product(sid, product);
 	    
       IgCollection &recHits = storage->getCollection("EcalRecHits_V1");
       IgProperty E = recHits.addProperty("energy", 0.0);
@@ -89,7 +91,7 @@ ISpyEcalRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSe
 
       for( std::vector<EcalRecHit>::const_iterator it=collection->begin(), itEnd=collection->end(); it!=itEnd; ++it)
       {
-	auto cell = (*geom).getGeometry ((*it).detid ());
+	auto cell = geom->getGeometry ((*it).detid ());
 	const CaloCellGeometry::CornersVec& corners = cell->getCorners ();
 	const GlobalPoint& pos = cell->getPosition ();
 	float energy = (*it).energy ();
@@ -131,12 +133,13 @@ ISpyEcalRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSe
     
     else 
     {
-      std::string error = "### Error: EcalRecHits "
-			  + edm::TypeID (typeid (EcalRecHitCollection)).friendlyClassName () + ":" 
-			  + (*ti).label() + ":"
-			  + (*ti).instance() + ":" 
-			  + (*ti).process() + " are not found.";
-      config->error (error);
+      config->error (sid, &(*ti), [&] {
+        return "### Error: EcalRecHits "
+               + edm::TypeID (typeid (EcalRecHitCollection)).friendlyClassName () + ":"
+               + (*ti).label() + ":"
+               + (*ti).instance() + ":"
+               + (*ti).process() + " are not found.";
+      });
     }
   }
 }
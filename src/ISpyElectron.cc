@@ -25,9 +25,11 @@ using namespace reco;
 
 ISpyElectron::ISpyElectron(const edm::ParameterSet& iConfig)
   : inputTag_(iConfig.getParameter<edm::InputTag>("iSpyElectronTag"))
-{}
+{
+  electronToken_ = consumes<reco::ElectronCollection>(inputTag_);
+}
 
-void ISpyElectron::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyElectron::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -40,10 +42,13 @@ void ISpyElectron::analyze(const edm::Event& event, const edm::EventSetup& event
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<ElectronCollection> collection;
-  event.getByLabel(inputTag_, collection);
+  event.getByToken(electronToken_, collection);
 
   if ( collection.isValid() )
   {
@@ -53,10 +58,7 @@ void ISpyElectron::analyze(const edm::Event& event, const edm::EventSetup& event
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& electrons = storage->getCollection("Electrons_V1");
 
@@ -116,12 +118,13 @@ void ISpyElectron::analyze(const edm::Event& event, const edm::EventSetup& event
   }
   else
   {
-    std::string error = "### Error: Electrons "
-                        + edm::TypeID (typeid (ElectronCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: Electrons "
+             + edm::TypeID (typeid (ElectronCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
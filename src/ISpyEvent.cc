@@ -32,7 +32,7 @@ ISpyEvent::ISpyEvent (const edm::ParameterSet& iPSet)
 {}
 
 void 
-ISpyEvent::analyze( const edm::Event& event, const edm::EventSetup& /* eventSetup */)
+ISpyEvent::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& /* eventSetup */) const
 {
   edm::Service<ISpyService> config;
   if (! config.isAvailable ()) 
@@ -59,7 +59,7 @@ ISpyEvent::analyze( const edm::Event& event, const edm::EventSetup& /* eventSetu
 
   std::string datetime (oss.str ());
  
-  IgDataStorage *storage = config->storage ();
+  IgDataStorage *storage = config->storage(sid);
   assert(storage);
   IgCollection &eventColl = storage->getCollection ("Event_V3");
 
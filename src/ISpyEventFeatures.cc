@@ -19,9 +19,11 @@ using namespace edm::service;
 
 ISpyEventFeatures::ISpyEventFeatures(const edm::ParameterSet& iConfig)
 : inputTag_(iConfig.getParameter<edm::InputTag>("iSpyEventFeaturesTag"))
-{}
+{
+  trackToken_ = consumes<reco::TrackCollection>(inputTag_);
+}
 
-void ISpyEventFeatures::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyEventFeatures::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -34,10 +36,13 @@ void ISpyEventFeatures::analyze(const edm::Event& event, const edm::EventSetup&
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<reco::TrackCollection> collection;
-  event.getByLabel (inputTag_, collection);
+  event.getByToken (trackToken_, collection);
 
   if ( collection.isValid() )
   {	    	
@@ -47,10 +52,7 @@ void ISpyEventFeatures::analyze(const edm::Event& event, const edm::EventSetup&
                           + inputTag_.instance() + ":" 
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& features = storage->getCollection("EventFeatures_V1");
     
@@ -73,13 +75,13 @@ void ISpyEventFeatures::analyze(const edm::Event& event, const edm::EventSetup&
 
   else
   {
-    std::string error = "### Error: EventFeatures "
-                        + edm::TypeID (typeid (reco::TrackCollection)).friendlyClassName () + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-  
-    config->error(error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: EventFeatures "
+             + edm::TypeID (typeid (reco::TrackCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
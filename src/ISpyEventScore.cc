@@ -0,0 +1,80 @@
+#include "ISpy/Analyzers/interface/ISpyEventScore.h"
+#include "ISpy/Analyzers/interface/ISpyService.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+using namespace edm::service;
+
+ISpyEventScore::ISpyEventScore(const edm::ParameterSet& iConfig)
+{
+  std::vector<edm::ParameterSet> terms = iConfig.getParameter<std::vector<edm::ParameterSet> >("terms");
+
+  for ( std::vector<edm::ParameterSet>::const_iterator ti = terms.begin(), tiEnd = terms.end();
+        ti != tiEnd; ++ti )
+  {
+    Term term;
+    term.tag = ti->getParameter<edm::InputTag>("src");
+    term.token = consumes<edm::View<reco::Candidate> >(term.tag);
+    term.minPt = ti->getParameter<double>("minPt");
+    term.weight = ti->getParameter<double>("weight");
+
+    std::string quantity = ti->getParameter<std::string>("quantity");
+
+    if ( quantity != "sumPt" && quantity != "count" )
+      throw cms::Exception ("Configuration")
+        << "ISpyEventScore: quantity must be \"sumPt\" or \"count\", not \""
+        << quantity << "\"";
+
+    term.sumPt = (quantity == "sumPt");
+
+    terms_.push_back(term);
+  }
+}
+
+void
+ISpyEventScore::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup&) const
+{
+  edm::Service<ISpyService> config;
+
+  if ( ! config.isAvailable() ) 
+  {
+    throw cms::Exception ("Configuration")
+      << "ISpyEventScore requires the ISpyService\n"
+      "which is not present in the configuration file.\n"
+      "You must add the service in the configuration file\n"
+      "or remove the module that requires it";
+  }
+
+  double score = 0.0;
+
+  for ( std::vector<Term>::const_iterator term = terms_.begin(), termEnd = terms_.end();
+        term != termEnd; ++term )
+  {
+    edm::Handle<edm::View<reco::Candidate> > collection;
+    event.getByToken(term->token, collection);
+
+    if ( ! collection.isValid() )
+      continue;
+
+    double value = 0.0;
+
+    for ( edm::View<reco::Candidate>::const_iterator ci = collection->begin(), ciEnd = collection->end();
+          ci != ciEnd; ++ci )
+    {
+      if ( ci->pt() < term->minPt )
+        continue;
+
+      value += term->sumPt ? ci->pt() : 1.0;
+    }
+
+    score += term->weight*value;
+  }
+
+  config->addScore(sid, score);
+}
+
+DEFINE_FWK_MODULE(ISpyEventScore);
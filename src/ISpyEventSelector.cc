@@ -0,0 +1,127 @@
+#include "ISpy/Analyzers/interface/ISpyEventSelector.h"
+
+#include "DataFormats/Provenance/interface/EventID.h"
+
+#include "FWCore/Common/interface/TriggerNames.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <algorithm>
+
+ISpyEventSelector::ISpyEventSelector(const edm::ParameterSet& iConfig)
+  : triggerResultsTag_(iConfig.getParameter<edm::InputTag>("triggerResultsTag")),
+    triggerPaths_(iConfig.getParameter<std::vector<std::string> >("triggerPaths"))
+{
+  std::vector<edm::EventID> events = iConfig.getParameter<std::vector<edm::EventID> >("eventList");
+
+  for ( std::vector<edm::EventID>::const_iterator ei = events.begin(), eiEnd = events.end(); 
+        ei != eiEnd; ++ei )
+    events_.push_back(std::make_pair(ei->run(), static_cast<unsigned long long>(ei->event())));
+
+  std::sort(events_.begin(), events_.end());
+
+  if ( ! triggerPaths_.empty() )
+    triggerResultsToken_ = consumes<edm::TriggerResults>(triggerResultsTag_);
+
+  std::vector<edm::ParameterSet> objects = iConfig.getParameter<std::vector<edm::ParameterSet> >("objects");
+
+  for ( std::vector<edm::ParameterSet>::const_iterator oi = objects.begin(), oiEnd = objects.end();
+        oi != oiEnd; ++oi )
+  {
+    ObjectCut cut;
+    cut.tag = oi->getParameter<edm::InputTag>("src");
+    cut.token = consumes<edm::View<reco::Candidate> >(cut.tag);
+    cut.minNumber = oi->getParameter<unsigned int>("minNumber");
+    cut.minPt = oi->getParameter<double>("minPt");
+
+    objects_.push_back(cut);
+  }
+}
+
+bool
+ISpyEventSelector::filter(edm::StreamID, edm::Event& event, const edm::EventSetup&) const
+{
+  return passEventList(event) && passTrigger(event) && passObjects(event);
+}
+
+bool
+ISpyEventSelector::passEventList(const edm::Event& event) const
+{
+  if ( events_.empty() )
+    return true;
+
+  return std::binary_search(events_.begin(), events_.end(),
+                            std::make_pair(event.id().run(), static_cast<unsigned long long>(event.id().event())));
+}
+
+bool
+ISpyEventSelector::passTrigger(const edm::Event& event) const
+{
+  if ( triggerPaths_.empty() )
+    return true;
+
+  edm::Handle<edm::TriggerResults> triggerResults;
+  event.getByToken(triggerResultsToken_, triggerResults);
+
+  if ( ! triggerResults.isValid() )
+    return false;
+
+  const edm::TriggerNames& triggerNames = event.triggerNames(*triggerResults);
+
+  for ( unsigned int i = 0, n = triggerResults->size(); i < n; ++i )
+  {
+    if ( ! triggerResults->accept(i) )
+      continue;
+
+    const std::string& name = triggerNames.triggerName(i);
+
+    // A trailing * matches any version or suffix, e.g. HLT_IsoMu24_v*
+    for ( std::vector<std::string>::const_iterator pi = triggerPaths_.begin(), piEnd = triggerPaths_.end();
+          pi != piEnd; ++pi )
+    {
+      if ( ! pi->empty() && (*pi)[pi->size()-1] == '*' )
+      {
+        if ( name.compare(0, pi->size()-1, *pi, 0, pi->size()-1) == 0 )
+          return true;
+      }
+      else if ( name == *pi )
+        return true;
+    }
+  }
+
+  return false;
+}
+
+bool
+ISpyEventSelector::passObjects(const edm::Event& event) const
+{
+  for ( std::vector<ObjectCut>::const_iterator cut = objects_.begin(), cutEnd = objects_.end();
+        cut != cutEnd; ++cut )
+  {
+    edm::Handle<edm::View<reco::Candidate> > collection;
+    event.getByToken(cut->token, collection);
+
+    if ( ! collection.isValid() )
+      return false;
+
+    if ( collection->size() < cut->minNumber )
+      return false;
+
+    unsigned int n = 0;
+
+    for ( edm::View<reco::Candidate>::const_iterator ci = collection->begin(), ciEnd = collection->end();
+          ci != ciEnd && n < cut->minNumber; ++ci )
+    {
+      if ( ci->pt() >= cut->minPt )
+        ++n;
+    }
+
+    if ( n < cut->minNumber )
+      return false;
+  }
+
+  return true;
+}
+
+DEFINE_FWK_MODULE(ISpyEventSelector);
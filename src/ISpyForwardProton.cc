@@ -22,7 +22,7 @@ ISpyForwardProton::ISpyForwardProton(const edm::ParameterSet& iConfig)
   protonToken_ = consumes<ForwardProtonCollection>(inputTag_);
 }
 
-void ISpyForwardProton::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyForwardProton::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   
@@ -35,7 +35,10 @@ void ISpyForwardProton::analyze(const edm::Event& event, const edm::EventSetup&
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<ForwardProtonCollection> collection;
   event.getByToken(protonToken_, collection);
@@ -48,10 +51,7 @@ void ISpyForwardProton::analyze(const edm::Event& event, const edm::EventSetup&
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& protons = storage->getCollection("ForwardProtons_V1");
     
@@ -88,12 +88,13 @@ void ISpyForwardProton::analyze(const edm::Event& event, const edm::EventSetup&
   }
   else
   {
-    std::string error = "### Error: ForwardProtons "
-                        + edm::TypeID (typeid (ForwardProtonCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: ForwardProtons "
+             + edm::TypeID (typeid (ForwardProtonCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
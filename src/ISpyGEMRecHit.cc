@@ -31,7 +31,7 @@ ISpyGEMRecHit::ISpyGEMRecHit(const edm::ParameterSet& iConfig)
   rechitToken_ = consumes<GEMRecHitCollection>(inputTag_); 
 }
 
-void ISpyGEMRecHit::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyGEMRecHit::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   if (event.id ().event () != 600317833) return;
   edm::Service<ISpyService> config;
@@ -45,17 +45,19 @@ void ISpyGEMRecHit::analyze(const edm::Event& event, const edm::EventSetup& even
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<GEMGeometry> geom;
-  eventSetup.get<MuonGeometryRecord> ().get (geom);
+  const GEMGeometry* geom = config->esContext(sid, eventSetup).gemGeometry();
  
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyGEMRecHit::analyze: Invalid MuonGeometryRecord ";
     
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -71,10 +73,7 @@ void ISpyGEMRecHit::analyze(const edm::Event& event, const edm::EventSetup& even
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& recHits = storage->getCollection("GEMRecHits_V2");
 
@@ -152,12 +151,13 @@ void ISpyGEMRecHit::analyze(const edm::Event& event, const edm::EventSetup& even
 
   else
   {
-    std::string error = "### Error: GEMRecHits "
-                        + edm::TypeID (typeid (GEMRecHitCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: GEMRecHits "
+             + edm::TypeID (typeid (GEMRecHitCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -28,7 +28,7 @@ ISpyGEMSegment::ISpyGEMSegment (const edm::ParameterSet& iConfig)
 }
 
 void 
-ISpyGEMSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyGEMSegment::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   if (event.id ().event () != 600317833) return;
   edm::Service<ISpyService> config;
@@ -42,16 +42,18 @@ ISpyGEMSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSe
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
    
-  edm::ESHandle<GEMGeometry> geom;
-  eventSetup.get<MuonGeometryRecord> ().get (geom);
+  const GEMGeometry* geom = config->esContext(sid, eventSetup).gemGeometry();
   
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyGEMSegment::analyze: Invalid MuonGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -66,10 +68,7 @@ ISpyGEMSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSe
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 	
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &segments = storage->getCollection ("GEMSegments_V2");
     IgProperty DET_ID   = segments.addProperty ("detid", int (0)); 
@@ -95,6 +94,7 @@ ISpyGEMSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSe
 
     GEMSegmentCollection::const_iterator it = collection->begin ();
     GEMSegmentCollection::const_iterator end = collection->end ();
+
     for (; it != end; ++it) 
     {
       IgCollectionItem isegment = segments.create ();
@@ -200,12 +200,13 @@ ISpyGEMSegment::analyze (const edm::Event& event, const edm::EventSetup& eventSe
   }
   else 
   {
-    std::string error = "### Error: GEMSegments "
-			+ edm::TypeID (typeid (GEMSegmentCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: GEMSegments "
+             + edm::TypeID (typeid (GEMSegmentCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -24,7 +24,7 @@ ISpyGenJet::ISpyGenJet (const edm::ParameterSet& iConfig)
 }
 
 void
-ISpyGenJet::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyGenJet::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   if (! config.isAvailable ()) 
@@ -35,13 +35,16 @@ ISpyGenJet::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
       "You must add the service in the configuration file\n"
       "or remove the module that requires it";
   }
+
+  if ( config->pruned(moduleDescription().id()) )
+    return;
     
   edm::Handle<reco::GenJetCollection> collection;
   event.getByToken(jetToken_, collection);
     
   if (collection.isValid ())
   {	
-    IgDataStorage *storage = config->storage ();
+    IgDataStorage *storage = config->storage(sid);
 	
     std::string product = "GenJets "
 			  + edm::TypeID (typeid (reco::GenJetCollection)).friendlyClassName () + ":" 
@@ -49,10 +52,7 @@ ISpyGenJet::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &jets = storage->getCollection ("GenJets_V1");
 
@@ -72,12 +72,13 @@ ISpyGenJet::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
   }    
   else 
   {
-    std::string error = "### Error: Jets "
-			+ edm::TypeID (typeid (reco::GenJetCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: Jets "
+             + edm::TypeID (typeid (reco::GenJetCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
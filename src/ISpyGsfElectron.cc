@@ -27,7 +27,7 @@ ISpyGsfElectron::ISpyGsfElectron(const edm::ParameterSet& iConfig)
   electronToken_ = consumes<GsfElectronCollection>(inputTag_);
 }
 
-void ISpyGsfElectron::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyGsfElectron::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -40,7 +40,10 @@ void ISpyGsfElectron::analyze(const edm::Event& event, const edm::EventSetup& ev
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<GsfElectronCollection> collection;
   event.getByToken(electronToken_, collection);
@@ -53,10 +56,7 @@ void ISpyGsfElectron::analyze(const edm::Event& event, const edm::EventSetup& ev
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& electrons = storage->getCollection("GsfElectrons_V1");
 
@@ -118,12 +118,13 @@ void ISpyGsfElectron::analyze(const edm::Event& event, const edm::EventSetup& ev
   }
   else
   {
-    std::string error = "### Error: GsfElectrons "
-                        + edm::TypeID (typeid (GsfElectronCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: GsfElectrons "
+             + edm::TypeID (typeid (GsfElectronCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -22,9 +22,11 @@ using namespace reco;
 
 ISpyGsfPFRecTrack::ISpyGsfPFRecTrack(const edm::ParameterSet& iConfig)
 : inputTag_(iConfig.getParameter<edm::InputTag>("iSpyGsfPFRecTrackTag"))
-{}
+{
+  trackToken_ = consumes<reco::GsfPFRecTrackCollection>(inputTag_);
+}
 
-void ISpyGsfPFRecTrack::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyGsfPFRecTrack::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -37,12 +39,15 @@ void ISpyGsfPFRecTrack::analyze(const edm::Event& event, const edm::EventSetup&
       "or remove the module that requires it";
   }
 
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
   edm::Handle<GsfPFRecTrackCollection> collection;
-  event.getByLabel(inputTag_, collection);
+  event.getByToken(trackToken_, collection);
 
   if ( collection.isValid() )
   {
-    IgDataStorage* storage = config->storage();
+    IgDataStorage* storage = config->storage(sid);
 
     std::string product = "GsfPFRecTracks "
                           + edm::TypeID (typeid (GsfPFRecTrackCollection)).friendlyClassName() + ":"
@@ -50,10 +55,7 @@ void ISpyGsfPFRecTrack::analyze(const edm::Event& event, const edm::EventSetup&
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& gsftracks = storage->getCollection("GsfPFRecTracks_V1");
     IgProperty PT  = gsftracks.addProperty("pt", 0.0); 
@@ -151,12 +153,13 @@ void ISpyGsfPFRecTrack::analyze(const edm::Event& event, const edm::EventSetup&
 
   else
   {
-    std::string error = "### Error: GsfPFRecTracks "
-                        + edm::TypeID (typeid (GsfPFRecTrackCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: GsfPFRecTracks "
+             + edm::TypeID (typeid (GsfPFRecTrackCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -26,9 +26,11 @@ using namespace reco;
 
 ISpyGsfTrack::ISpyGsfTrack(const edm::ParameterSet& iConfig)
   : inputTag_(iConfig.getParameter<edm::InputTag>("iSpyGsfTrackTag"))
-{}
+{
+  trackToken_ = consumes<reco::GsfTrackCollection>(inputTag_);
+}
 
-void ISpyGsfTrack::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyGsfTrack::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -41,21 +43,23 @@ void ISpyGsfTrack::analyze(const edm::Event& event, const edm::EventSetup& event
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<GlobalTrackingGeometry> geometry;
-  eventSetup.get<GlobalTrackingGeometryRecord>().get(geometry);
+  const GlobalTrackingGeometry* geometry = config->esContext(sid, eventSetup).globalTrackingGeometry();
 
-  if ( ! geometry.isValid() )
+  if ( ! geometry )
   {
     std::string error = 
       "### Error: ISpyGsfPFRecTrack::analyze: Invalid GlobalTrackingGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
   edm::Handle<GsfTrackCollection> collection;
-  event.getByLabel(inputTag_, collection);
+  event.getByToken(trackToken_, collection);
   
   if ( collection.isValid() )
   {   
@@ -65,10 +69,7 @@ void ISpyGsfTrack::analyze(const edm::Event& event, const edm::EventSetup& event
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& tracks = storage->getCollection("GsfTracks_V1");
     
@@ -91,7 +92,9 @@ void ISpyGsfTrack::analyze(const edm::Event& event, const edm::EventSetup& event
     IgProperty HIT_POS = hits.addProperty("pos", IgV3d());
 
     IgAssociations &trackHits = storage->getAssociations("GsfTrackHits_V1");
- 
+
+    ISpyLocalPosition positions(geometry);
+
     for (reco::GsfTrackCollection::const_iterator track = collection->begin (), trackEnd = collection->end ();
          track != trackEnd; ++track)
     {
@@ -138,11 +141,9 @@ void ISpyGsfTrack::analyze(const edm::Event& event, const edm::EventSetup& event
           {
             IgCollectionItem hit = hits.create ();
            
-            LocalPoint point = ISpyLocalPosition::localPosition(&(**it), geometry.product());
+            GlobalPoint point = positions.globalPosition(&(**it));
             
-            hit[HIT_POS] = IgV3d(geometry->idToDet((*it)->geographicalId())->surface().toGlobal(point).x()/100.0,
-                                geometry->idToDet((*it)->geographicalId())->surface().toGlobal(point).y()/100.0,
-                                geometry->idToDet((*it)->geographicalId())->surface().toGlobal(point).z()/100.0);
+            hit[HIT_POS] = IgV3d(point.x()/100.0, point.y()/100.0, point.z()/100.0);
             
             trackHits.associate (item, hit);
           }
@@ -152,12 +153,13 @@ void ISpyGsfTrack::analyze(const edm::Event& event, const edm::EventSetup& event
   }
   else
   {
-    std::string error = "### Error: GsfTracks "
-                        + edm::TypeID (typeid (GsfTrackCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: GsfTracks "
+             + edm::TypeID (typeid (GsfTrackCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -28,7 +28,7 @@ ISpyHERecHit::ISpyHERecHit (const edm::ParameterSet& iConfig)
 }
 
 void
-ISpyHERecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyHERecHit::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -41,16 +41,18 @@ ISpyHERecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord> ().get (geom);
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyHERecHit::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
     
@@ -65,10 +67,7 @@ ISpyHERecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &recHits = storage->getCollection("HERecHits_V2");
     IgProperty E = recHits.addProperty("energy", 0.0);
@@ -89,7 +88,7 @@ ISpyHERecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
     {
       if ((*it).id ().subdet () == HcalEndcap)
       {
-	auto cell = (*geom).getGeometry ((*it).detid ());
+	auto cell = geom->getGeometry ((*it).detid ());
 	const CaloCellGeometry::CornersVec& corners = cell->getCorners ();
 	const GlobalPoint& pos = cell->getPosition ();
 	float energy = (*it).energy ();
@@ -102,6 +101,9 @@ ISpyHERecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
 	float eta = pos.eta ();
 	float phi = pos.phi ();
 
+	if ( ! config->inRegionOfInterest(sid, eta, phi) )
+	  continue;
+
 	IgCollectionItem irechit = recHits.create();
 	irechit[E] = static_cast<double>(energy);
 	irechit[ETA] = static_cast<double>(eta);
@@ -138,12 +140,13 @@ ISpyHERecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
   }
   else 
   {
-    std::string error = "### Error: HERecHits "
-			+ edm::TypeID (typeid (HBHERecHitCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: HERecHits "
+             + edm::TypeID (typeid (HBHERecHitCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -28,7 +28,7 @@ ISpyHFRecHit::ISpyHFRecHit (const edm::ParameterSet& iConfig)
 }
 
 void
-ISpyHFRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyHFRecHit::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -41,16 +41,18 @@ ISpyHFRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
     
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord> ().get (geom);
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
     
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyHFRecHit::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -65,10 +67,7 @@ ISpyHFRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &recHits = storage->getCollection("HFRecHits_V2");
     IgProperty E = recHits.addProperty("energy", 0.0);
@@ -87,7 +86,7 @@ ISpyHFRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
 
     for (std::vector<HFRecHit>::const_iterator it=collection->begin(), itEnd=collection->end(); it!=itEnd; ++it)
     {
-      auto cell = (*geom).getGeometry ((*it).detid ());
+      auto cell = geom->getGeometry ((*it).detid ());
       const CaloCellGeometry::CornersVec& corners = cell->getCorners ();
       const GlobalPoint& pos = cell->getPosition ();
       float energy = (*it).energy ();
@@ -95,6 +94,9 @@ ISpyHFRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
       float eta = pos.eta ();
       float phi = pos.phi ();
 
+      if ( ! config->inRegionOfInterest(sid, eta, phi) )
+        continue;
+
       IgCollectionItem irechit = recHits.create();
       irechit[E] = static_cast<double>(energy);
       irechit[ETA] = static_cast<double>(eta);
@@ -130,12 +132,13 @@ ISpyHFRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetu
   }
   else 
   {
-    std::string error = "### Error: HFRecHits "
-			+ edm::TypeID (typeid (HFRecHitCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: HFRecHits "
+             + edm::TypeID (typeid (HFRecHitCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
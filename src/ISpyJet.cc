@@ -25,7 +25,7 @@ ISpyJet::ISpyJet (const edm::ParameterSet& iConfig)
 }
 
 void
-ISpyJet::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyJet::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   if (! config.isAvailable ()) 
@@ -36,6 +36,9 @@ ISpyJet::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
       "You must add the service in the configuration file\n"
       "or remove the module that requires it";
   }
+
+  if ( config->pruned(moduleDescription().id()) )
+    return;
     
   edm::Handle<reco::CaloJetCollection> collection;
   event.getByToken(jetToken_, collection);
@@ -45,7 +48,7 @@ ISpyJet::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
 
   if (collection.isValid ())
   {	
-    IgDataStorage *storage = config->storage ();
+    IgDataStorage *storage = config->storage(sid);
 	
     std::string product = "Jets "
 			  + edm::TypeID (typeid (reco::CaloJetCollection)).friendlyClassName () + ":" 
@@ -53,10 +56,7 @@ ISpyJet::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &jets = storage->getCollection ("Jets_V2");
 
@@ -84,12 +84,13 @@ ISpyJet::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
   }    
   else 
   {
-    std::string error = "### Error: Jets "
-			+ edm::TypeID (typeid (reco::CaloJetCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: Jets "
+             + edm::TypeID (typeid (reco::CaloJetCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -18,15 +18,44 @@
 #include "CondFormats/DataRecord/interface/L1GtTriggerMaskAlgoTrigRcd.h"
 #include "CondFormats/DataRecord/interface/L1GtTriggerMaskTechTrigRcd.h"
 
+#include <cstdint>
 #include <sstream>
 
 using namespace edm::service;
 using namespace edm;
 
+namespace
+{
+  // One row per 32 bits of the word: row i holds bits 32i to 32i+31,
+  // least significant first.
+  void packBits(IgCollection& collection, IgProperty& BITS, const std::vector<bool>& word)
+  {
+    uint32_t bits = 0;
+
+    for ( size_t i = 0, n = word.size(); i != n; ++i )
+    {
+      if ( word[i] )
+        bits |= 1u << (i % 32);
+
+      if ( i % 32 == 31 || i + 1 == n )
+      {
+        IgCollectionItem row = collection.create();
+        row[BITS] = static_cast<int>(bits);
+        bits = 0;
+      }
+    }
+  }
+}
+
 ISpyL1GlobalTriggerReadoutRecord::ISpyL1GlobalTriggerReadoutRecord(const edm::ParameterSet& iConfig)
-  : inputTag_(iConfig.getParameter<edm::InputTag>("iSpyL1GlobalTriggerReadoutRecordTag")){}
+  : inputTag_(iConfig.getParameter<edm::InputTag>("iSpyL1GlobalTriggerReadoutRecordTag")),
+    algorithmDictionary_(iConfig.getUntrackedParameter<bool>("algorithmDictionary", false)),
+    dictionaryRun_(0)
+{
+  triggerRecordToken_ = consumes<L1GlobalTriggerReadoutRecord>(inputTag_);
+}
 
-void ISpyL1GlobalTriggerReadoutRecord::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyL1GlobalTriggerReadoutRecord::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -39,16 +68,15 @@ void ISpyL1GlobalTriggerReadoutRecord::analyze(const edm::Event& event, const ed
       "or remove the module that requires it";
   }
 
-  edm::Handle<L1GlobalTriggerReadoutRecord> triggerRecord;
-  event.getByLabel(inputTag_, triggerRecord);
+  if ( config->pruned(moduleDescription().id()) )
+    return;
 
-  edm::ESHandle<L1GtTriggerMask> l1GtTmTech;
-  edm::ESHandle<L1GtTriggerMask> l1GtTmAlgo;
-  edm::ESHandle<L1GtTriggerMenu> menuRcd;
+  edm::Handle<L1GlobalTriggerReadoutRecord> triggerRecord;
+  event.getByToken(triggerRecordToken_, triggerRecord);
 
   if( triggerRecord.isValid() )
   {
-    IgDataStorage* storage = config->storage();
+    IgDataStorage* storage = config->storage(sid);
 
     std::string product = "L1GlobalTriggerReadoutRecord "
 			  + edm::TypeID (typeid (L1GlobalTriggerReadoutRecord)).friendlyClassName() + ":"
@@ -56,38 +84,46 @@ void ISpyL1GlobalTriggerReadoutRecord::analyze(const edm::Event& event, const ed
 			  + inputTag_.instance() + ":"
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
-    IgCollection& gtTrigger = storage->getCollection("L1GtTrigger_V1");
-	
-    IgProperty ALGO = gtTrigger.addProperty("algorithm", std::string());
-    IgProperty ABN  = gtTrigger.addProperty("algoBitNumber", int(0));
-    IgProperty RES  = gtTrigger.addProperty("result", int(0));
+    std::shared_ptr<const Menu> menu;
+    bool writeDictionary = false;
 
-    edm::ESHandle<L1GtTriggerMenu> menuRcd;
-    eventSetup.get<L1GtTriggerMenuRcd>().get(menuRcd) ;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
 
-    const L1GtTriggerMenu* menu = menuRcd.product();
-    const AlgorithmMap amap = menu->gtAlgorithmMap();
+      const L1GtTriggerMenuRcd& menuRecord = eventSetup.get<L1GtTriggerMenuRcd>();
 
-    const DecisionWord dWord = triggerRecord->decisionWord();
- 
-    for( AlgorithmMap::const_iterator mit = amap.begin(), mitEnd = amap.end(); 
-	 mit != mitEnd; ++mit )
-    {
-      std::string algo = mit->first;
-      int result = menu->gtAlgorithmResult(algo, dWord);
-
-      IgCollectionItem t = gtTrigger.create();
-      
-      int algoBitNumber = (mit->second).algoBitNumber();
-            
-      t[ALGO] = algo;
-      t[ABN]  = algoBitNumber;
-      t[RES]  = result;
+      if ( ! menu_ || menu_->cacheIdentifier != menuRecord.cacheIdentifier() )
+      {
+        edm::ESHandle<L1GtTriggerMenu> menuRcd;
+        menuRecord.get(menuRcd);
+
+        const AlgorithmMap& amap = menuRcd->gtAlgorithmMap();
+
+        std::shared_ptr<Menu> m(new Menu);
+        m->cacheIdentifier = menuRecord.cacheIdentifier();
+        m->names.reserve(amap.size());
+        m->bits.reserve(amap.size());
+
+        for ( AlgorithmMap::const_iterator mit = amap.begin(), mitEnd = amap.end();
+              mit != mitEnd; ++mit )
+        {
+          m->names.push_back(mit->first);
+          m->bits.push_back((mit->second).algoBitNumber());
+        }
+
+        menu_ = m;
+        dictionaryRun_ = 0;
+      }
+
+      menu = menu_;
+
+      if ( algorithmDictionary_ && dictionaryRun_ != event.id().run() )
+      {
+        dictionaryRun_ = event.id().run();
+        writeDictionary = true;
+      }
     }
 
     /*
@@ -100,27 +136,70 @@ void ISpyL1GlobalTriggerReadoutRecord::analyze(const edm::Event& event, const ed
       const L1GtTriggerMask *trigMaskAlgo = l1GtTmAlgo.product ();
     */
 
-    const TechnicalTriggerWord gtTTWord = triggerRecord->technicalTriggerWord();
+    const DecisionWord& dWord = triggerRecord->decisionWord();
+    const TechnicalTriggerWord& gtTTWord = triggerRecord->technicalTriggerWord();
 
-    IgCollection& tTrigger = storage->getCollection("TechTrigger_V1");
-	
-    IgProperty TBIT = tTrigger.addProperty("bitNumber", int(0));
-    IgProperty TRESULT = tTrigger.addProperty("result", int(0));
+    if ( algorithmDictionary_ )
+    {
+      // The names go once per run (and menu) to the geometry file
+      // and the events only carry the two words.
+      if ( writeDictionary )
+      {
+        IgCollection& algoNames = config->esStorage(sid)->getCollection("L1GtAlgorithmNames_V1");
+        IgProperty AN_ABN  = algoNames.addProperty("algoBitNumber", int(0));
+        IgProperty AN_ALGO = algoNames.addProperty("algorithm", std::string());
+
+        for ( size_t i = 0, n = menu->names.size(); i != n; ++i )
+        {
+          IgCollectionItem an = algoNames.create();
+          an[AN_ABN]  = menu->bits[i];
+          an[AN_ALGO] = menu->names[i];
+        }
+      }
+
+      IgCollection& gtTrigger = storage->getCollection("L1GtTrigger_V2");
+      IgProperty ABITS = gtTrigger.addProperty("bits", int(0));
+      packBits(gtTrigger, ABITS, dWord);
 
-    int tbitNumber = 0;
-    TechnicalTriggerWord::const_iterator GTtbitItr;
-    for(GTtbitItr = gtTTWord.begin(); GTtbitItr != gtTTWord.end(); GTtbitItr++)
+      IgCollection& tTrigger = storage->getCollection("TechTrigger_V2");
+      IgProperty TBITS = tTrigger.addProperty("bits", int(0));
+      packBits(tTrigger, TBITS, gtTTWord);
+    }
+
+    else
     {
-      IgCollectionItem tt = tTrigger.create();
-      tt[TBIT]  = tbitNumber;
-      if(*GTtbitItr)
-	tt[TRESULT]  = 1;
-      else
-	tt[TRESULT]  = 0;
+      IgCollection& gtTrigger = storage->getCollection("L1GtTrigger_V1");
 	
-      tbitNumber++; 
-    }
+      IgProperty ALGO = gtTrigger.addProperty("algorithm", std::string());
+      IgProperty ABN  = gtTrigger.addProperty("algoBitNumber", int(0));
+      IgProperty RES  = gtTrigger.addProperty("result", int(0));
+
+      // The result of an algorithm is its bit in the decision word
+      for ( size_t i = 0, n = menu->names.size(); i != n; ++i )
+      {
+        const int algoBitNumber = menu->bits[i];
+
+        IgCollectionItem t = gtTrigger.create();
+        t[ALGO] = menu->names[i];
+        t[ABN]  = algoBitNumber;
+        t[RES]  = static_cast<int>(algoBitNumber >= 0
+                                   && static_cast<size_t>(algoBitNumber) < dWord.size()
+                                   && dWord[algoBitNumber]);
+      }
+
+      IgCollection& tTrigger = storage->getCollection("TechTrigger_V1");
 	
+      IgProperty TBIT = tTrigger.addProperty("bitNumber", int(0));
+      IgProperty TRESULT = tTrigger.addProperty("result", int(0));
+
+      for ( size_t i = 0, n = gtTTWord.size(); i != n; ++i )
+      {
+        IgCollectionItem tt = tTrigger.create();
+        tt[TBIT]    = static_cast<int>(i);
+        tt[TRESULT] = gtTTWord[i] ? 1 : 0;
+      }
+    }
+
     /*
       Are these useful?
 
@@ -170,36 +249,18 @@ void ISpyL1GlobalTriggerReadoutRecord::analyze(const edm::Event& event, const ed
       std::ostringstream ttn;
       ttn <<"x"<< std::hex << l1GtfeWord.totalTriggerNr();
       gtfe[TTN] = std::string(ttn.str());
-		
-      IgCollection& l1GtFdlWordColl = storage->getCollection("L1GtFdlWord_V1");
-      IgCollection& l1GtPsbWordColl = storage->getCollection("L1GtPsbWord_V1");
-
-      for ( std::vector<L1GtFdlWord>::const_iterator itFdl = 
-      triggerRecord->gtFdlVector().begin();
-      itFdl != triggerRecord->gtFdlVector().end(); ++itFdl ) 
-      {
-      itFdl->print(std::cout);	 
-      }
- 
-      for ( std::vector<L1GtPsbWord>::const_iterator itPsb = 
-      triggerRecord->gtPsbVector().begin();	
-      itPsb != triggerRecord->gtPsbVector().end(); ++itPsb ) 
-      {
-	     
-      itPsb->print(std::cout);
-      }
     */
   }
 
   else
   {
-    std::string error = "### Error: L1GlobalTriggerReadoutRecord "
-
-			+ edm::TypeID (typeid (L1GlobalTriggerReadoutRecord)).friendlyClassName() + ":"
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":"
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: L1GlobalTriggerReadoutRecord "
+             + edm::TypeID (typeid (L1GlobalTriggerReadoutRecord)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -2,9 +2,8 @@
 
 #include "DataFormats/DetId/interface/DetId.h"
 
-#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
-#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit1D.h"
-#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit2D.h"
+#include "DataFormats/TrackerRecHit2D/interface/trackerHitRTTI.h"
+#include "DataFormats/TrackerRecHit2D/interface/TrackerSingleRecHit.h"
 #include "DataFormats/TrackerRecHit2D/interface/SiStripMatchedRecHit2D.h"
 
 #include "Geometry/CommonDetUnit/interface/GeomDet.h"
@@ -13,68 +12,139 @@
 #include "Geometry/CommonTopologies/interface/StripTopology.h"
 #include "Geometry/CommonTopologies/interface/PixelTopology.h"
 
-LocalPoint 
+ISpyLocalPosition::ISpyLocalPosition(const TrackingGeometry* geometry)
+  : geometry_(geometry)
+{}
+
+LocalPoint
 ISpyLocalPosition::localPosition(const TrackingRecHit* rechit,  const TrackingGeometry* geometry)
 {
-  DetId detid = rechit->geographicalId(); 
-  
-  if ( const SiPixelRecHit* hit = dynamic_cast<const SiPixelRecHit*>(rechit) ) 
-  {                
-    float bcx = hit->cluster().get()->x();
-    float bcy = hit->cluster().get()->y();
-
-    const PixelTopology* topology =
-      dynamic_cast<const PixelTopology*>(&(geometry->idToDetUnit(detid)->topology()));
-    assert(topology);
-
-    return LocalPoint(topology->localX(bcx), topology->localY(bcy), 0);
+  ISpyLocalPosition positions(geometry);
+  return positions.localPosition(rechit);
+}
+
+ISpyLocalPosition::HitKind
+ISpyLocalPosition::hitKind(const TrackingRecHit* rechit)
+{
+  // SiPixelRecHit and SiStripRecHit2D are both "single",
+  // SiStripRecHit1D is "single1D": all are TrackerSingleRecHits
+  // and the cluster reference tells pixel from strip.
+  switch ( trackerHitRTTI::rtti(*rechit) )
+  {
+  case trackerHitRTTI::single:
+  case trackerHitRTTI::single1D:
+    {
+      const TrackerSingleRecHit* hit = static_cast<const TrackerSingleRecHit*>(rechit);
+
+      if ( hit->omniClusterRef().isPixel() )
+        return PIXEL;
+      if ( hit->omniClusterRef().isStrip() )
+        return STRIP;
+
+      return OTHER;
+    }
+  case trackerHitRTTI::match:
+    return MATCHED;
+  default:
+    return OTHER;
   }
-  
-  if ( const SiStripRecHit1D* hit = dynamic_cast<const SiStripRecHit1D*>(rechit) )
-  {         
-    float bc = hit->cluster().get()->barycenter();
+}
 
-    const StripTopology* topology =
-      dynamic_cast<const StripTopology*>(&(geometry->idToDetUnit(detid)->topology()));
-    assert(topology);
+const ISpyLocalPosition::CachedDet&
+ISpyLocalPosition::cached(DetId detid)
+{
+  std::unordered_map<unsigned int, CachedDet>::iterator it = dets_.find(detid.rawId());
 
-    return topology->localPosition(bc);
-  }
-  
-  if ( const SiStripRecHit2D* hit = dynamic_cast<const SiStripRecHit2D*>(rechit) )
-  {
-    float bc = hit->cluster().get()->barycenter();
-    
-    const StripTopology* topology = 
-      dynamic_cast<const StripTopology*>(&(geometry->idToDetUnit(detid)->topology()));
-    assert(topology);
+  if ( it != dets_.end() )
+    return it->second;
 
-    return topology->localPosition(bc);
-  }
-          
-  if ( const SiStripMatchedRecHit2D* hit = dynamic_cast<const SiStripMatchedRecHit2D*>(rechit) )
+  CachedDet c;
+  c.det = geometry_->idToDet(detid);
+
+  // Glued dets (matched hits) have no topology of their own
+  const GeomDet* unit = geometry_->idToDetUnit(detid);
+  c.topology = unit ? &(unit->topology()) : 0;
+
+  return dets_.insert(std::make_pair(detid.rawId(), c)).first->second;
+}
+
+LocalPoint
+ISpyLocalPosition::localPosition(const TrackingRecHit* rechit)
+{
+  return localPosition(rechit, hitKind(rechit));
+}
+
+LocalPoint
+ISpyLocalPosition::localPosition(const TrackingRecHit* rechit, HitKind kind)
+{
+  switch ( kind )
   {
-    const StripTopology* topology =
-      dynamic_cast<const StripTopology*>(&(geometry->idToDetUnit(detid)->topology()));
-    assert(topology);
-
-    float bc1 = hit->monoCluster().barycenter();
-    float bc2 = hit->stereoCluster().barycenter();
-
-    GlobalPoint pos_1 = geometry->idToDetUnit(hit->monoHit().geographicalId())->surface().toGlobal(topology->localPosition(bc1));
-    GlobalPoint pos_2 = geometry->idToDetUnit(hit->stereoHit().geographicalId())->surface().toGlobal(topology->localPosition(bc2));
-    
-    GlobalPoint average((pos_1.x()+pos_2.x())/2,
-                        (pos_1.y()+pos_2.y())/2,
-                        (pos_1.z()+pos_2.z())/2);
-      
-    return geometry->idToDet(rechit->geographicalId())->surface().toLocal(average);
+  case PIXEL:
+    {
+      const SiPixelCluster& cluster = static_cast<const TrackerSingleRecHit*>(rechit)->pixelCluster();
+      const PixelTopology* topology =
+        static_cast<const PixelTopology*>(cached(rechit->geographicalId()).topology);
+      assert(topology);
+
+      return LocalPoint(topology->localX(cluster.x()), topology->localY(cluster.y()), 0);
+    }
+  case STRIP:
+    {
+      float bc = static_cast<const TrackerSingleRecHit*>(rechit)->stripCluster().barycenter();
+      const StripTopology* topology =
+        static_cast<const StripTopology*>(cached(rechit->geographicalId()).topology);
+      assert(topology);
+
+      return topology->localPosition(bc);
+    }
+  case MATCHED:
+    {
+      const SiStripMatchedRecHit2D* hit = static_cast<const SiStripMatchedRecHit2D*>(rechit);
+
+      const CachedDet& mono = cached(hit->monoId());
+      const CachedDet& stereo = cached(hit->stereoId());
+      assert(mono.topology && stereo.topology);
+
+      float bc1 = hit->monoCluster().barycenter();
+      float bc2 = hit->stereoCluster().barycenter();
+
+      GlobalPoint pos_1 = mono.det->surface().toGlobal(static_cast<const StripTopology*>(mono.topology)->localPosition(bc1));
+      GlobalPoint pos_2 = stereo.det->surface().toGlobal(static_cast<const StripTopology*>(stereo.topology)->localPosition(bc2));
+
+      GlobalPoint average((pos_1.x()+pos_2.x())/2,
+                          (pos_1.y()+pos_2.y())/2,
+                          (pos_1.z()+pos_2.z())/2);
+
+      return cached(rechit->geographicalId()).det->surface().toLocal(average);
+    }
+  default:
+    return rechit->localPosition();
   }
-
-  return rechit->localPosition();
 }
 
+GlobalPoint
+ISpyLocalPosition::globalPosition(const TrackingRecHit* rechit)
+{
+  return cached(rechit->geographicalId()).det->surface().toGlobal(localPosition(rechit));
+}
 
+void
+ISpyLocalPosition::globalPositions(const std::vector<const TrackingRecHit*>& rechits,
+                                   std::vector<GlobalPoint>& points)
+{
+  // Classify the whole batch first, then dispatch
+  std::vector<HitKind> kinds;
+  kinds.reserve(rechits.size());
 
+  for ( std::vector<const TrackingRecHit*>::const_iterator it = rechits.begin(), itEnd = rechits.end();
+        it != itEnd; ++it )
+    kinds.push_back(hitKind(*it));
 
+  points.reserve(points.size() + rechits.size());
 
+  for ( size_t i = 0, n = rechits.size(); i < n; ++i )
+  {
+    const TrackingRecHit* rechit = rechits[i];
+    points.push_back(cached(rechit->geographicalId()).det->surface().toGlobal(localPosition(rechit, kinds[i])));
+  }
+}
@@ -0,0 +1,174 @@
+#include "ISpy/Analyzers/interface/ISpyLocalPositionBenchmark.h"
+#include "ISpy/Analyzers/interface/ISpyLocalPosition.h"
+
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit1D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiStripRecHit2D.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiStripMatchedRecHit2D.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "Geometry/CommonDetUnit/interface/GeomDet.h"
+#include "Geometry/CommonDetUnit/interface/GlobalTrackingGeometry.h"
+#include "Geometry/CommonTopologies/interface/StripTopology.h"
+#include "Geometry/CommonTopologies/interface/PixelTopology.h"
+#include "Geometry/Records/interface/GlobalTrackingGeometryRecord.h"
+
+#include <chrono>
+
+namespace
+{
+  // The dynamic_cast lookup as it was before the batched
+  // ISpyLocalPosition, kept here as the reference to time and compare
+  // against. Matched hits take the topology of the mono and stereo
+  // dets, as ISpyLocalPosition now does.
+  LocalPoint legacyLocalPosition(const TrackingRecHit* rechit, const TrackingGeometry* geometry)
+  {
+    DetId detid = rechit->geographicalId(); 
+  
+    if ( const SiPixelRecHit* hit = dynamic_cast<const SiPixelRecHit*>(rechit) ) 
+    {                
+      const PixelTopology* topology =
+        dynamic_cast<const PixelTopology*>(&(geometry->idToDetUnit(detid)->topology()));
+
+      return LocalPoint(topology->localX(hit->cluster().get()->x()), 
+                        topology->localY(hit->cluster().get()->y()), 0);
+    }
+  
+    if ( const SiStripRecHit1D* hit = dynamic_cast<const SiStripRecHit1D*>(rechit) )
+    {         
+      const StripTopology* topology =
+        dynamic_cast<const StripTopology*>(&(geometry->idToDetUnit(detid)->topology()));
+
+      return topology->localPosition(hit->cluster().get()->barycenter());
+    }
+  
+    if ( const SiStripRecHit2D* hit = dynamic_cast<const SiStripRecHit2D*>(rechit) )
+    {
+      const StripTopology* topology = 
+        dynamic_cast<const StripTopology*>(&(geometry->idToDetUnit(detid)->topology()));
+
+      return topology->localPosition(hit->cluster().get()->barycenter());
+    }
+          
+    if ( const SiStripMatchedRecHit2D* hit = dynamic_cast<const SiStripMatchedRecHit2D*>(rechit) )
+    {
+      const GeomDet* mono = geometry->idToDetUnit(hit->monoHit().geographicalId());
+      const GeomDet* stereo = geometry->idToDetUnit(hit->stereoHit().geographicalId());
+
+      GlobalPoint pos_1 = mono->surface().toGlobal(
+        dynamic_cast<const StripTopology*>(&(mono->topology()))->localPosition(hit->monoCluster().barycenter()));
+      GlobalPoint pos_2 = stereo->surface().toGlobal(
+        dynamic_cast<const StripTopology*>(&(stereo->topology()))->localPosition(hit->stereoCluster().barycenter()));
+    
+      GlobalPoint average((pos_1.x()+pos_2.x())/2,
+                          (pos_1.y()+pos_2.y())/2,
+                          (pos_1.z()+pos_2.z())/2);
+      
+      return geometry->idToDet(detid)->surface().toLocal(average);
+    }
+
+    return rechit->localPosition();
+  }
+}
+
+ISpyLocalPositionBenchmark::ISpyLocalPositionBenchmark(const edm::ParameterSet& iConfig)
+  : inputTag_(iConfig.getParameter<edm::InputTag>("iSpyTrackTag")),
+    repeat_(iConfig.getUntrackedParameter<int>("repeat", 10)),
+    hits_(0),
+    mismatches_(0),
+    legacyTime_(0.0),
+    batchedTime_(0.0)
+{
+  trackToken_ = consumes<reco::TrackCollection>(inputTag_);
+}
+
+void
+ISpyLocalPositionBenchmark::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+{
+  edm::ESHandle<GlobalTrackingGeometry> geometry;
+  eventSetup.get<GlobalTrackingGeometryRecord>().get(geometry);
+
+  edm::Handle<reco::TrackCollection> collection;
+  event.getByToken(trackToken_, collection);
+
+  if ( ! geometry.isValid() || ! collection.isValid() )
+    return;
+
+  std::vector<const TrackingRecHit*> rechits;
+
+  for ( reco::TrackCollection::const_iterator track = collection->begin(), trackEnd = collection->end();
+        track != trackEnd; ++track )
+  {
+    if ( track->extra().isNull() )
+      continue;
+
+    for ( trackingRecHit_iterator it = track->recHitsBegin(); it != track->recHitsEnd(); ++it )
+    {
+      if ( (*it)->isValid() && ! (*it)->geographicalId().null() )
+        rechits.push_back(&(**it));
+    }
+  }
+
+  std::vector<GlobalPoint> legacy;
+  std::vector<GlobalPoint> batched;
+
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+  for ( int r = 0; r < repeat_; ++r )
+  {
+    legacy.clear();
+
+    // As ISpyTrack did it: the position, then a det lookup per coordinate
+    for ( std::vector<const TrackingRecHit*>::const_iterator it = rechits.begin(), itEnd = rechits.end();
+          it != itEnd; ++it )
+    {
+      LocalPoint point = legacyLocalPosition(*it, geometry.product());
+      legacy.push_back(GlobalPoint(geometry->idToDet((*it)->geographicalId())->surface().toGlobal(point).x(),
+                                   geometry->idToDet((*it)->geographicalId())->surface().toGlobal(point).y(),
+                                   geometry->idToDet((*it)->geographicalId())->surface().toGlobal(point).z()));
+    }
+  }
+
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+  for ( int r = 0; r < repeat_; ++r )
+  {
+    batched.clear();
+
+    ISpyLocalPosition positions(geometry.product());
+    positions.globalPositions(rechits, batched);
+  }
+
+  std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+  legacyTime_ += std::chrono::duration<double>(t1 - t0).count();
+  batchedTime_ += std::chrono::duration<double>(t2 - t1).count();
+  hits_ += rechits.size()*repeat_;
+
+  for ( size_t i = 0; i < rechits.size(); ++i )
+  {
+    if ( (legacy[i] - batched[i]).mag() > 1e-4 )
+      ++mismatches_;
+  }
+}
+
+void
+ISpyLocalPositionBenchmark::endJob(void)
+{
+  double perHit = hits_ ? 1e9/hits_ : 0.0;
+
+  edm::LogVerbatim("ISpyLocalPositionBenchmark")
+    << "ISpyLocalPositionBenchmark: " << hits_ << " hits\n"
+    << "  legacy:  " << legacyTime_ << " s (" << legacyTime_*perHit << " ns/hit)\n"
+    << "  batched: " << batchedTime_ << " s (" << batchedTime_*perHit << " ns/hit)\n"
+    << "  positions differing by more than 1 um: " << mismatches_;
+}
+
+DEFINE_FWK_MODULE(ISpyLocalPositionBenchmark);
@@ -21,7 +21,7 @@ ISpyMET::ISpyMET (const edm::ParameterSet& iConfig)
 }
 
 void
-ISpyMET::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyMET::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   if (! config.isAvailable ()) 
@@ -32,13 +32,16 @@ ISpyMET::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
       "You must add the service in the configuration file\n"
       "or remove the module that requires it";
   }
+
+  if ( config->pruned(moduleDescription().id()) )
+    return;
     
   edm::Handle<METCollection> collection;
   event.getByToken(metToken_, collection);
 
   if (collection.isValid ())
   {	
-    IgDataStorage *storage = config->storage ();
+    IgDataStorage *storage = config->storage(sid);
 
     std::string product = "MET "
 			  + edm::TypeID (typeid (METCollection)).friendlyClassName () + ":" 
@@ -46,10 +49,7 @@ ISpyMET::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 	
     IgCollection &mets = storage->getCollection ("METs_V1");
 
@@ -74,12 +74,13 @@ ISpyMET::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
   }    
   else 
   {
-    std::string error = "### Error: MET "
-			+ edm::TypeID (typeid (METCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: MET "
+             + edm::TypeID (typeid (METCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -1,4 +1,5 @@
 #include "ISpy/Analyzers/interface/ISpyMuon.h"
+#include "ISpy/Analyzers/interface/ISpyAssociations.h"
 #include "ISpy/Analyzers/interface/ISpyService.h"
 #include "ISpy/Analyzers/interface/ISpyTrackRefitter.h"
 #include "ISpy/Services/interface/IgCollection.h"
@@ -17,11 +18,7 @@
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/Exception.h"
 
-#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
-
-#include "Geometry/Records/interface/MuonGeometryRecord.h"
-#include "DataFormats/GeometrySurface/interface/RectangularPlaneBounds.h"
-#include "DataFormats/GeometrySurface/interface/TrapezoidalPlaneBounds.h"
+#include "tbb/parallel_for.h"
 
 #include <iostream>
 #include <sstream>
@@ -33,12 +30,14 @@ ISpyMuon::ISpyMuon(const edm::ParameterSet& iConfig)
     in_(iConfig.getUntrackedParameter<double>("propagatorIn", 0.0)),
     out_(iConfig.getUntrackedParameter<double>("propagatorOut", 0.0)),
     step_(iConfig.getUntrackedParameter<double>("propagatorStep", 0.05)),
-    dtGeomValid_(false), cscGeomValid_(false)
+    maxSagitta_(iConfig.getUntrackedParameter<double>("propagatorMaxSagitta", 0.0)),
+    maxFailed_(iConfig.getUntrackedParameter<int>("propagatorMaxFailed", 5)),
+    helixSegments_(iConfig.getUntrackedParameter<bool>("helixSegments", false))
 {
   muonToken_ = consumes<reco::MuonCollection>(inputTag_);
 }      
 
-void ISpyMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyMuon::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   
@@ -51,50 +50,47 @@ void ISpyMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
       "or remove the module that requires it";
   }
 
-  storage_ = config->storage();
-  edm::ESHandle<MagneticField> field; 
-  eventSetup.get<IdealMagneticFieldRecord>().get(field);
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage* storage = config->storage(sid);
+  ISpyESContext& es = config->esContext(sid, eventSetup);
+  const MagneticField* field = es.magneticField();
   
-  if ( ! field.isValid() )
+  if ( ! field )
   {
     std::string error = 
             "### Error: ISpyMuon::analyze: Invalid Magnetic field ";
     
-    config->error (error);
+    config->error (sid, error);
     return;
   }
   
-  eventSetup.get<MuonGeometryRecord>().get(gemGeometry_);
-  eventSetup.get<MuonGeometryRecord>().get(dtGeometry_);
-  eventSetup.get<MuonGeometryRecord>().get(cscGeometry_);
-
-  if ( gemGeometry_.isValid() )
-    gemGeomValid_ = true;
-  else
-    config->error("### Error: Muons  GEM Geometry not valid");
-
-  if ( dtGeometry_.isValid() )
-    dtGeomValid_ = true;
-  else 
-    config->error("### Error: Muons  DT Geometry not valid");    
+  const GEMGeometry* gemGeometry = es.gemGeometry();
+  const DTGeometry*  dtGeometry = es.dtGeometry();
+  const CSCGeometry* cscGeometry = es.cscGeometry();
+
+  if ( ! gemGeometry )
+    config->error (sid, "### Error: Muons  GEM Geometry not valid");
+
+  if ( ! dtGeometry )
+    config->error (sid, "### Error: Muons  DT Geometry not valid");    
            
-  if ( cscGeometry_.isValid() )
-    cscGeomValid_ = true;
-  else
-    config->error("### Error: Muons  CSC Geometry not valid");
+  if ( ! cscGeometry )
+    config->error (sid, "### Error: Muons  CSC Geometry not valid");
 
   edm::Handle<reco::MuonCollection> collection;
   event.getByToken(muonToken_, collection);
 
   if ( ! collection.isValid() )
   {
-    std::string error = "### Error: Muons "
-                        + edm::TypeID (typeid (reco::MuonCollection)).friendlyClassName() + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: Muons "
+             + edm::TypeID (typeid (reco::MuonCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
     return;
   }
          
@@ -104,12 +100,9 @@ void ISpyMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
                         + inputTag_.instance() + ":" 
                         + inputTag_.process();
 
-  IgCollection& products = storage_->getCollection("Products_V1");
-  IgProperty PROD = products.addProperty("Product", std::string ());
-  IgCollectionItem item = products.create();
-  item[PROD] = product;
+  config->product(sid, product);
 
-  IgCollection& trackerMuonCollection = storage_->getCollection("TrackerMuons_V1");
+  IgCollection& trackerMuonCollection = storage->getCollection("TrackerMuons_V1");
   IgProperty T_PT = trackerMuonCollection.addProperty("pt", 0.0);
   IgProperty T_CHARGE = trackerMuonCollection.addProperty("charge", int(0));
   IgProperty T_RP = trackerMuonCollection.addProperty("rp", IgV3d());
@@ -117,7 +110,7 @@ void ISpyMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
   IgProperty T_ETA = trackerMuonCollection.addProperty("eta", 0.0);
   IgProperty T_CALO_E = trackerMuonCollection.addProperty("calo_energy", 0.0);
   
-  IgCollection& standAloneMuonCollection = storage_->getCollection("StandaloneMuons_V2");
+  IgCollection& standAloneMuonCollection = storage->getCollection("StandaloneMuons_V2");
   IgProperty S_PT = standAloneMuonCollection.addProperty("pt", 0.0);
   IgProperty S_CHARGE = standAloneMuonCollection.addProperty("charge", int(0));
   IgProperty S_RP = standAloneMuonCollection.addProperty("pos", IgV3d());
@@ -125,7 +118,7 @@ void ISpyMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
   IgProperty S_ETA = standAloneMuonCollection.addProperty("eta", 0.0);
   IgProperty S_CALO_E = standAloneMuonCollection.addProperty("calo_energy", 0.0);
 
-  IgCollection& globalMuonCollection = storage_->getCollection("GlobalMuons_V1");
+  IgCollection& globalMuonCollection = storage->getCollection("GlobalMuons_V1");
   IgProperty G_PT = globalMuonCollection.addProperty("pt", 0.0);
   IgProperty G_CHARGE = globalMuonCollection.addProperty("charge", int(0));
   IgProperty G_RP = globalMuonCollection.addProperty("rp", IgV3d ());
@@ -133,17 +126,66 @@ void ISpyMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
   IgProperty G_ETA = globalMuonCollection.addProperty("eta", 0.0);
   IgProperty G_CALO_E = globalMuonCollection.addProperty("calo_energy", 0.0);
 
-  IgCollection& extras = storage_->getCollection("Extras_V1");
+  IgCollection& extras = storage->getCollection("Extras_V1");
   IgProperty IPOS = extras.addProperty("pos_1", IgV3d());
   IgProperty IP   = extras.addProperty("dir_1", IgV3d());
   IgProperty OPOS = extras.addProperty("pos_2", IgV3d());
   IgProperty OP   = extras.addProperty("dir_2", IgV3d());
  
-  IgAssociations& trackExtras = storage_->getAssociations("MuonTrackExtras_V1");
+  IgAssociations& trackExtras = storage->getAssociations("MuonTrackExtras_V1");
+
+  ISpyAssociations muonTrackerPoints(storage, "MuonTrackerPoints_V1", "MuonTrackerPointRanges_V1",
+                                     config->rangeAssociations());
+  ISpyAssociations muonTrackerHelices(storage, "MuonTrackerHelices_V1", "MuonTrackerHelixRanges_V1",
+                                      config->rangeAssociations());
+  ISpyAssociations muonGlobalPoints(storage, "MuonGlobalPoints_V1", "MuonGlobalPointRanges_V1",
+                                    config->rangeAssociations());
+
+  ISpyMuonChambers chambers(storage, "MuonGlobalChambers_V1", es.muonChamberCache(),
+                            es.muonGeometryCacheIdentifier(),
+                            dtGeometry, cscGeometry, gemGeometry);
+
+  // The tracker and global tracks of all the muons (at 2i and 2i+1
+  // for muon i) are refitted first, concurrently, each into its own
+  // buffer. Everything is then written in order below.
+  const size_t nMuons = collection->size();
+  std::vector<ISpyTrackRefitter::Refit> refits(2*nMuons);
+
+  tbb::parallel_for(size_t(0), refits.size(), [&](size_t j) {
+    const reco::Muon& muon = (*collection)[j/2];
+    const bool tracker = (j % 2 == 0);
+    reco::TrackRef track = tracker ? muon.track() : muon.combinedMuon();
+
+    if ( track.isNull() )
+      return;
+
+    ISpyTrackRefitter::Refit& refit = refits[j];
+
+    if ( tracker && helixSegments_ && ISpyTrackRefitter::helix(refit.helix, track, field, in_, out_) )
+    {
+      refit.isHelix = true;
+      return;
+    }
+
+    try
+    {
+      ISpyTrackRefitter::propagate(refit.points, track, field,
+                                   in_, out_, step_, maxSagitta_, maxFailed_);
+    }
+
+    catch (cms::Exception& e)
+    {
+      refit.points.clear();
+      refit.failed = true;
+      refit.error = e.explainSelf();
+    }
+  });
 
   for (reco::MuonCollection::const_iterator it = collection->begin(), end = collection->end(); 
        it != end; ++it) 
   {
+    const size_t index = it - collection->begin();
+
     int charge = (*it).charge();
 
 
@@ -162,22 +204,14 @@ void ISpyMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
       if ((*it).isEnergyValid ()) // CaloTower
         addCaloEnergy(it, imuon, T_CALO_E);
       
-      IgAssociations& muonTrackerPoints = storage_->getAssociations("MuonTrackerPoints_V1");
-
-      try
-      {
-        ISpyTrackRefitter::refitTrack(imuon, muonTrackerPoints, storage_,
-                                     (*it).track (), &*field, 
-                                     in_, out_, step_);
-      }       
-            
-      catch (cms::Exception& e)
-      {
-        std::string error = 
-          "### Error: ISpyMuon::refitTrack exception caught for TrackerMuon:";
-        //error += e.explainSelf();
-	config->error (error);
-      }
+      const ISpyTrackRefitter::Refit& refit = refits[2*index];
+
+      if ( refit.failed )
+        ISpyTrackRefitter::reportError(*config, sid, "### Error: ISpyMuon::refitTrack exception caught for TrackerMuon", refit);
+      else if ( refit.isHelix )
+        ISpyTrackRefitter::writeHelix(imuon, muonTrackerHelices, storage, refit.helix);
+      else
+        ISpyTrackRefitter::writePoints(imuon, muonTrackerPoints, storage, refit.points);
     }
   
     if ( (*it).standAloneMuon().isNonnull() ) // Standalone
@@ -223,8 +257,8 @@ void ISpyMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
     {
       IgCollectionItem imuon = globalMuonCollection.create();
 
-      if ((*it).isMatchesValid () && (dtGeomValid_ || cscGeomValid_)) 
-        addChambers(it);
+      if ((*it).isMatchesValid () && (dtGeometry || cscGeometry)) 
+        chambers.add(imuon, (*it).matches());
 
       imuon[G_PT] = (*it).combinedMuon()->pt();
       imuon[G_CHARGE] = charge;
@@ -237,132 +271,18 @@ void ISpyMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
       if ((*it).isEnergyValid ()) // CaloTower
         addCaloEnergy(it, imuon, G_CALO_E);
 
-      IgAssociations& muonGlobalPoints = storage_->getAssociations("MuonGlobalPoints_V1");	
- 
-      try
-      {
-        ISpyTrackRefitter::refitTrack(imuon, muonGlobalPoints, storage_,
-                                     (*it).combinedMuon(), &*field, 
-                                     in_, out_, step_);
-      }
-            
-      catch (cms::Exception& e)
-      {
-        std::string error = 
-          "### Error: ISpyMuon::refitTrack exception caught for GlobalMuon:";
-        //error += e.explainSelf();
-	config->error (error);
-      }
-    }
-  }
-}
+      const ISpyTrackRefitter::Refit& refit = refits[2*index + 1];
 
-void
-ISpyMuon::addChambers(reco::MuonCollection::const_iterator it)
-{ 
-  // Do not add if not a global muon
-  if ( ! (*it).combinedMuon().isNonnull() )
-     return;
-		    
-  IgCollection& chambers = storage_->getCollection("MuonChambers_V1");
-  IgProperty DETID = chambers.addProperty("detid", int(0));
-  IgProperty FRONT_1 = chambers.addProperty("front_1", IgV3d());
-  IgProperty FRONT_2 = chambers.addProperty("front_2", IgV3d());
-  IgProperty FRONT_3 = chambers.addProperty("front_3", IgV3d());
-  IgProperty FRONT_4 = chambers.addProperty("front_4", IgV3d());
-  IgProperty BACK_1 = chambers.addProperty("back_1", IgV3d());
-  IgProperty BACK_2 = chambers.addProperty("back_2", IgV3d());
-  IgProperty BACK_3 = chambers.addProperty("back_3", IgV3d());
-  IgProperty BACK_4 = chambers.addProperty("back_4", IgV3d());
-
-  const std::vector<reco::MuonChamberMatch> &dets = (*it).matches();
-  const GeomDet* geomDet;
-  float length, width, thickness;
-
-  for ( std::vector<reco::MuonChamberMatch>::const_iterator dit = dets.begin(), 
-                                                         ditEnd = dets.end(); 
-        dit != ditEnd; ++dit )
-  {
-    if ( dit->detector() == MuonSubdetId::GEM )
-    {
-      geomDet = gemGeometry_->idToDet((*dit).id);
+      if ( refit.failed )
+        ISpyTrackRefitter::reportError(*config, sid, "### Error: ISpyMuon::refitTrack exception caught for GlobalMuon", refit);
+      else
+        ISpyTrackRefitter::writePoints(imuon, muonGlobalPoints, storage, refit.points);
     }
-    else if ( dit->detector() == MuonSubdetId::CSC )
-    {
-      geomDet = cscGeometry_->idToDet((*dit).id);
-    }
-    
-    else if ( dit->detector() == MuonSubdetId::DT )
-    {
-      geomDet = dtGeometry_->idToDet((*dit).id);
-    }
-    
-    else
-      continue;
-
-    GlobalPoint p[8];
-    const Bounds* b = &(geomDet->surface().bounds());
-    IgCollectionItem chamber = chambers.create();
-    chamber[DETID] = static_cast<int>((*dit).id.rawId());
-
-    if ( const TrapezoidalPlaneBounds* b2 = dynamic_cast<const TrapezoidalPlaneBounds*>(b) )
-    {
-      //std::vector<float> parameters = b2->parameters();
-      float parameters[4] = {
-        b2->parameters()[0],
-        b2->parameters()[1],
-        b2->parameters()[2],
-        b2->parameters()[3] 
-      };
-
-      p[0] = geomDet->surface().toGlobal(LocalPoint(parameters[0],-parameters[3],parameters[2])); 
-      p[1] = geomDet->surface().toGlobal(LocalPoint(-parameters[0],-parameters[3],parameters[2])); 
-      p[2] = geomDet->surface().toGlobal(LocalPoint(parameters[1],parameters[3],parameters[2])); 
-      p[3] = geomDet->surface().toGlobal(LocalPoint(-parameters[1],parameters[3],parameters[2])); 
-      p[4] = geomDet->surface().toGlobal(LocalPoint(parameters[0],-parameters[3],-parameters[2])); 
-      p[5] = geomDet->surface().toGlobal(LocalPoint(-parameters[0],-parameters[3],-parameters[2])); 
-      p[6] = geomDet->surface().toGlobal(LocalPoint(parameters[1],parameters[3],-parameters[2])); 
-      p[7] = geomDet->surface().toGlobal(LocalPoint(-parameters[1],parameters[3],-parameters[2]));
-    }  
-    
-    if ( dynamic_cast<const RectangularPlaneBounds*>(b) )
-    {            
-      length = geomDet->surface().bounds().length();
-      width = geomDet->surface().bounds().width();
-      thickness = geomDet->surface().bounds().thickness();
-
-      p[0] = geomDet->surface().toGlobal(LocalPoint(width/2,length/2,thickness/2)); 
-      p[1] = geomDet->surface().toGlobal(LocalPoint(width/2,-length/2,thickness/2)); 
-      p[2] = geomDet->surface().toGlobal(LocalPoint(-width/2,length/2,thickness/2)); 
-      p[3] = geomDet->surface().toGlobal(LocalPoint(-width/2,-length/2,thickness/2)); 
-      p[4] = geomDet->surface().toGlobal(LocalPoint(width/2,length/2,-thickness/2)); 
-      p[5] = geomDet->surface().toGlobal(LocalPoint(width/2,-length/2,-thickness/2)); 
-      p[6] = geomDet->surface().toGlobal(LocalPoint(-width/2,length/2,-thickness/2)); 
-      p[7] = geomDet->surface().toGlobal(LocalPoint(-width/2,-length/2,-thickness/2));    
-    }
-
-    chamber[FRONT_1] =        
-      IgV3d(static_cast<double>(p[0].x()/100.0), static_cast<double>(p[0].y()/100.0), static_cast<double>(p[0].z()/100.0));
-    chamber[FRONT_2] = 
-      IgV3d(static_cast<double>(p[1].x()/100.0), static_cast<double>(p[1].y()/100.0), static_cast<double>(p[1].z()/100.0));
-    chamber[FRONT_4] = 
-      IgV3d(static_cast<double>(p[2].x()/100.0), static_cast<double>(p[2].y()/100.0), static_cast<double>(p[2].z()/100.0));
-    chamber[FRONT_3] = 
-      IgV3d(static_cast<double>(p[3].x()/100.0), static_cast<double>(p[3].y()/100.0), static_cast<double>(p[3].z()/100.0));
-    chamber[BACK_1] = 
-      IgV3d(static_cast<double>(p[4].x()/100.0), static_cast<double>(p[4].y()/100.0), static_cast<double>(p[4].z()/100.0));
-    chamber[BACK_2] = 
-      IgV3d(static_cast<double>(p[5].x()/100.0), static_cast<double>(p[5].y()/100.0), static_cast<double>(p[5].z()/100.0));
-    chamber[BACK_4] = 
-      IgV3d(static_cast<double>(p[6].x()/100.0), static_cast<double>(p[6].y()/100.0), static_cast<double>(p[6].z()/100.0));
-    chamber[BACK_3] = 
-      IgV3d(static_cast<double>(p[7].x()/100.0), static_cast<double>(p[7].y()/100.0), static_cast<double>(p[7].z()/100.0));
-
   }
 }
 
 void ISpyMuon::addCaloEnergy(reco::MuonCollection::const_iterator it, IgCollectionItem& imuon,
-                            IgProperty& property)
+                            IgProperty& property) const
 {
   float e = (*it).calEnergy ().tower;
   imuon[property] = e;		
@@ -0,0 +1,154 @@
+#include "ISpy/Analyzers/interface/ISpyMuonChambers.h"
+
+#include "DataFormats/GeometrySurface/interface/RectangularPlaneBounds.h"
+#include "DataFormats/GeometrySurface/interface/TrapezoidalPlaneBounds.h"
+#include "DataFormats/MuonDetId/interface/MuonSubdetId.h"
+
+#include "Geometry/CSCGeometry/interface/CSCGeometry.h"
+#include "Geometry/DTGeometry/interface/DTGeometry.h"
+#include "Geometry/GEMGeometry/interface/GEMGeometry.h"
+
+bool
+ISpyMuonChamberCache::corners(DetId id,
+                              unsigned long long cacheIdentifier,
+                              const DTGeometry* dtGeometry,
+                              const CSCGeometry* cscGeometry,
+                              const GEMGeometry* gemGeometry,
+                              Corners& c)
+{
+  const GeomDet* geomDet;
+
+  if ( id.subdetId() == MuonSubdetId::GEM && gemGeometry )
+    geomDet = gemGeometry->idToDet(id);
+  else if ( id.subdetId() == MuonSubdetId::CSC && cscGeometry )
+    geomDet = cscGeometry->idToDet(id);
+  else if ( id.subdetId() == MuonSubdetId::DT && dtGeometry )
+    geomDet = dtGeometry->idToDet(id);
+  else
+    return false;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if ( cacheIdentifier != cacheIdentifier_ )
+  {
+    corners_.clear();
+    cacheIdentifier_ = cacheIdentifier;
+  }
+
+  std::unordered_map<unsigned int, Corners>::const_iterator it = corners_.find(id.rawId());
+
+  if ( it != corners_.end() )
+  {
+    c = it->second;
+    return true;
+  }
+
+  GlobalPoint p[8];
+  const Bounds* b = &(geomDet->surface().bounds());
+
+  if ( const TrapezoidalPlaneBounds* b2 = dynamic_cast<const TrapezoidalPlaneBounds*>(b) )
+  {
+    float parameters[4] = {
+      b2->parameters()[0],
+      b2->parameters()[1],
+      b2->parameters()[2],
+      b2->parameters()[3]
+    };
+
+    p[0] = geomDet->surface().toGlobal(LocalPoint(parameters[0],-parameters[3],parameters[2]));
+    p[1] = geomDet->surface().toGlobal(LocalPoint(-parameters[0],-parameters[3],parameters[2]));
+    p[2] = geomDet->surface().toGlobal(LocalPoint(parameters[1],parameters[3],parameters[2]));
+    p[3] = geomDet->surface().toGlobal(LocalPoint(-parameters[1],parameters[3],parameters[2]));
+    p[4] = geomDet->surface().toGlobal(LocalPoint(parameters[0],-parameters[3],-parameters[2]));
+    p[5] = geomDet->surface().toGlobal(LocalPoint(-parameters[0],-parameters[3],-parameters[2]));
+    p[6] = geomDet->surface().toGlobal(LocalPoint(parameters[1],parameters[3],-parameters[2]));
+    p[7] = geomDet->surface().toGlobal(LocalPoint(-parameters[1],parameters[3],-parameters[2]));
+  }
+
+  if ( dynamic_cast<const RectangularPlaneBounds*>(b) )
+  {
+    float length = b->length();
+    float width = b->width();
+    float thickness = b->thickness();
+
+    p[0] = geomDet->surface().toGlobal(LocalPoint(width/2,length/2,thickness/2));
+    p[1] = geomDet->surface().toGlobal(LocalPoint(width/2,-length/2,thickness/2));
+    p[2] = geomDet->surface().toGlobal(LocalPoint(-width/2,length/2,thickness/2));
+    p[3] = geomDet->surface().toGlobal(LocalPoint(-width/2,-length/2,thickness/2));
+    p[4] = geomDet->surface().toGlobal(LocalPoint(width/2,length/2,-thickness/2));
+    p[5] = geomDet->surface().toGlobal(LocalPoint(width/2,-length/2,-thickness/2));
+    p[6] = geomDet->surface().toGlobal(LocalPoint(-width/2,length/2,-thickness/2));
+    p[7] = geomDet->surface().toGlobal(LocalPoint(-width/2,-length/2,-thickness/2));
+  }
+
+  // The third and fourth corners of each face are swapped with
+  // respect to p so that they go round the face.
+  static const int order[8] = {0, 1, 3, 2, 4, 5, 7, 6};
+
+  for ( int i = 0; i < 8; ++i )
+  {
+    const GlobalPoint& q = p[order[i]];
+    c.p[i] = IgV3d(static_cast<double>(q.x()/100.0),
+                   static_cast<double>(q.y()/100.0),
+                   static_cast<double>(q.z()/100.0));
+  }
+
+  corners_.insert(std::make_pair(id.rawId(), c));
+  return true;
+}
+
+ISpyMuonChambers::ISpyMuonChambers(IgDataStorage* storage,
+                                   const char* associations,
+                                   ISpyMuonChamberCache& cache,
+                                   unsigned long long cacheIdentifier,
+                                   const DTGeometry* dtGeometry,
+                                   const CSCGeometry* cscGeometry,
+                                   const GEMGeometry* gemGeometry)
+  : chambers_(storage->getCollection("MuonChambers_V1")),
+    associations_(storage->getAssociations(associations)),
+    cache_(cache),
+    cacheIdentifier_(cacheIdentifier),
+    dtGeometry_(dtGeometry),
+    cscGeometry_(cscGeometry),
+    gemGeometry_(gemGeometry)
+{
+  properties_.push_back(chambers_.addProperty("detid", int(0)));
+  properties_.push_back(chambers_.addProperty("front_1", IgV3d()));
+  properties_.push_back(chambers_.addProperty("front_2", IgV3d()));
+  properties_.push_back(chambers_.addProperty("front_3", IgV3d()));
+  properties_.push_back(chambers_.addProperty("front_4", IgV3d()));
+  properties_.push_back(chambers_.addProperty("back_1", IgV3d()));
+  properties_.push_back(chambers_.addProperty("back_2", IgV3d()));
+  properties_.push_back(chambers_.addProperty("back_3", IgV3d()));
+  properties_.push_back(chambers_.addProperty("back_4", IgV3d()));
+}
+
+void
+ISpyMuonChambers::add(IgCollectionItem& muon, const std::vector<reco::MuonChamberMatch>& matches)
+{
+  for ( std::vector<reco::MuonChamberMatch>::const_iterator dit = matches.begin(),
+                                                         ditEnd = matches.end();
+        dit != ditEnd; ++dit )
+  {
+    unsigned int rawId = dit->id.rawId();
+    std::unordered_map<unsigned int, IgCollectionItem>::iterator it = written_.find(rawId);
+
+    if ( it == written_.end() )
+    {
+      ISpyMuonChamberCache::Corners c;
+
+      if ( ! cache_.corners(dit->id, cacheIdentifier_, dtGeometry_, cscGeometry_, gemGeometry_, c) )
+        continue;
+
+      IgCollectionItem chamber = chambers_.create();
+      chamber[properties_[0]] = static_cast<int>(rawId);
+
+      for ( int i = 0; i < 8; ++i )
+        chamber[properties_[i+1]] = c.p[i];
+
+      it = written_.insert(std::make_pair(rawId, chamber)).first;
+    }
+
+    associations_.associate(muon, it->second);
+  }
+}
@@ -24,10 +24,18 @@
 using namespace edm::service;
 
 ISpyMuonGeometry::ISpyMuonGeometry(const edm::ParameterSet& iPSet)
+  : cacheIdentifier_(0),
+    timer_(iPSet.getUntrackedParameter<unsigned int>("benchmarkRepeat", 0))
 {}
 
 void
-ISpyMuonGeometry::analyze(const edm::Event& event, const edm::EventSetup& eventSetup) 
+ISpyMuonGeometry::endJob(void)
+{
+  timer_.report("ISpyMuonGeometry");
+}
+
+void
+ISpyMuonGeometry::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {    
   edm::Service<ISpyService> config;
 
@@ -40,47 +48,52 @@ ISpyMuonGeometry::analyze(const edm::Event& event, const edm::EventSetup& eventS
       "or remove the module that requires it";
   }
 
-  eventSetup.get<MuonGeometryRecord>().get(cscGeom_);
-  eventSetup.get<MuonGeometryRecord>().get(dtGeom_);
-  eventSetup.get<MuonGeometryRecord>().get(rpcGeom_);
-  eventSetup.get<MuonGeometryRecord>().get(gemGeom_);
+  const MuonGeometryRecord& record = eventSetup.get<MuonGeometryRecord>();
 
-  IgDataStorage *storage  = config->esStorage();
-    
-  if ( watch_muonGeom_.check(eventSetup) ) {
-    
-    if ( dtGeom_.isValid() ) {
-      buildDriftTubes3D(storage);
-      buildDriftTubesRPhi(storage);
-      buildDriftTubesRZ(storage);
-    }
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if ( record.cacheIdentifier() == cacheIdentifier_ )
+    return;
+
+  cacheIdentifier_ = record.cacheIdentifier();
+
+  record.get(cscGeom_);
+  record.get(dtGeom_);
+  record.get(rpcGeom_);
+  record.get(gemGeom_);
+
+  IgDataStorage *storage  = config->esStorage(sid);
+
+  if ( dtGeom_.isValid() ) {
+    timer_.run("buildDriftTubes3D", storage, [&](IgDataStorage *s) { buildDriftTubes3D (s); });
+    timer_.run("buildDriftTubesRPhi", storage, [&](IgDataStorage *s) { buildDriftTubesRPhi (s); });
+    timer_.run("buildDriftTubesRZ", storage, [&](IgDataStorage *s) { buildDriftTubesRZ (s); });
+  }
 	
-    if ( cscGeom_.isValid() ) {
-      buildCSC3D(storage, "CSCMinus3D_V1", 2);
-      buildCSC3D(storage, "CSCPlus3D_V1", 1);
-      buildCSCRZ(storage);
-    }
+  if ( cscGeom_.isValid() ) {
+    timer_.run("buildCSC3D CSCMinus3D_V1", storage, [&](IgDataStorage *s) { buildCSC3D (s, "CSCMinus3D_V1", 2); });
+    timer_.run("buildCSC3D CSCPlus3D_V1", storage, [&](IgDataStorage *s) { buildCSC3D (s, "CSCPlus3D_V1", 1); });
+    timer_.run("buildCSCRZ", storage, [&](IgDataStorage *s) { buildCSCRZ (s); });
+  }
 	
-    if ( rpcGeom_.isValid() ) {
-      buildRPCBarrel3D(storage);
-      buildRPCPlusEndcap3D(storage);
-      buildRPCMinusEndcap3D(storage);
-      buildRPCRPhi(storage);
-      buildRPCRZ(storage);
-    }
-
-    if ( gemGeom_.isValid() ) {
-      buildGEM3D(storage, "GEMMinus3D_V1", -1);
-      buildGEM3D(storage, "GEMPlus3D_V1", 1);
-      buildGEMRZ(storage);
-    }
+  if ( rpcGeom_.isValid() ) {
+    timer_.run("buildRPCBarrel3D", storage, [&](IgDataStorage *s) { buildRPCBarrel3D (s); });
+    timer_.run("buildRPCPlusEndcap3D", storage, [&](IgDataStorage *s) { buildRPCPlusEndcap3D (s); });
+    timer_.run("buildRPCMinusEndcap3D", storage, [&](IgDataStorage *s) { buildRPCMinusEndcap3D (s); });
+    timer_.run("buildRPCRPhi", storage, [&](IgDataStorage *s) { buildRPCRPhi (s); });
+    timer_.run("buildRPCRZ", storage, [&](IgDataStorage *s) { buildRPCRZ (s); });
+  }
 
+  if ( gemGeom_.isValid() ) {
+    timer_.run("buildGEM3D GEMMinus3D_V1", storage, [&](IgDataStorage *s) { buildGEM3D (s, "GEMMinus3D_V1", -1); });
+    timer_.run("buildGEM3D GEMPlus3D_V1", storage, [&](IgDataStorage *s) { buildGEM3D (s, "GEMPlus3D_V1", 1); });
+    timer_.run("buildGEMRZ", storage, [&](IgDataStorage *s) { buildGEMRZ (s); });
   }
 
 }
 
 void
-ISpyMuonGeometry::buildDriftTubes3D(IgDataStorage *storage)
+ISpyMuonGeometry::buildDriftTubes3D(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("DTs3D_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -133,7 +146,7 @@ ISpyMuonGeometry::buildDriftTubes3D(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildDriftTubesRPhi(IgDataStorage *storage)
+ISpyMuonGeometry::buildDriftTubesRPhi(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("DTsRPhi_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -189,7 +202,7 @@ ISpyMuonGeometry::buildDriftTubesRPhi(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildDriftTubesRZ(IgDataStorage *storage)
+ISpyMuonGeometry::buildDriftTubesRZ(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("DTsRZ_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -254,7 +267,7 @@ ISpyMuonGeometry::buildDriftTubesRZ(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildCSC3D(IgDataStorage *storage, const std::string &name, int side)
+ISpyMuonGeometry::buildCSC3D(IgDataStorage *storage, const std::string &name, int side) const
 {
   IgCollection &geometry = storage->getCollection (name.c_str());
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -340,7 +353,7 @@ ISpyMuonGeometry::buildCSC3D(IgDataStorage *storage, const std::string &name, in
 }
 
 void
-ISpyMuonGeometry::buildCSCRZ(IgDataStorage *storage)
+ISpyMuonGeometry::buildCSCRZ(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("CSCRZ_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -435,7 +448,7 @@ ISpyMuonGeometry::buildCSCRZ(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildRPC3D(IgDataStorage *storage)
+ISpyMuonGeometry::buildRPC3D(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("RPC3D_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -520,7 +533,7 @@ ISpyMuonGeometry::buildRPC3D(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildRPCBarrel3D(IgDataStorage *storage)
+ISpyMuonGeometry::buildRPCBarrel3D(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("RPCBarrel3D_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -607,7 +620,7 @@ ISpyMuonGeometry::buildRPCBarrel3D(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildRPCPlusEndcap3D(IgDataStorage *storage)
+ISpyMuonGeometry::buildRPCPlusEndcap3D(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("RPCPlusEndcap3D_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -694,7 +707,7 @@ ISpyMuonGeometry::buildRPCPlusEndcap3D(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildRPCMinusEndcap3D(IgDataStorage *storage)
+ISpyMuonGeometry::buildRPCMinusEndcap3D(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("RPCMinusEndcap3D_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -781,7 +794,7 @@ ISpyMuonGeometry::buildRPCMinusEndcap3D(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildRPCRPhi(IgDataStorage *storage)
+ISpyMuonGeometry::buildRPCRPhi(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("RPCRPhi_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -871,7 +884,7 @@ ISpyMuonGeometry::buildRPCRPhi(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildRPCRZ(IgDataStorage *storage)
+ISpyMuonGeometry::buildRPCRZ(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("RPCRZ_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -969,7 +982,7 @@ ISpyMuonGeometry::buildRPCRZ(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildGEMRZ(IgDataStorage *storage)
+ISpyMuonGeometry::buildGEMRZ(IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("GEMRZ_V1");
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
@@ -1065,7 +1078,7 @@ ISpyMuonGeometry::buildGEMRZ(IgDataStorage *storage)
 }
 
 void
-ISpyMuonGeometry::buildGEM3D(IgDataStorage *storage, const std::string &name, int side)
+ISpyMuonGeometry::buildGEM3D(IgDataStorage *storage, const std::string &name, int side) const
 {
   IgCollection &geometry = storage->getCollection (name.c_str());
   IgProperty DET_ID  = geometry.addProperty("detid", int (0)); 
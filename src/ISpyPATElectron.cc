@@ -26,7 +26,7 @@ ISpyPATElectron::ISpyPATElectron(const edm::ParameterSet& iConfig)
   electronToken_ = consumes<std::vector<pat::Electron> >(inputTag_);
 }
 
-void ISpyPATElectron::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPATElectron::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -39,7 +39,10 @@ void ISpyPATElectron::analyze(const edm::Event& event, const edm::EventSetup& ev
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage(); 
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid); 
 
   edm::Handle<std::vector<pat::Electron> > collection;
   event.getByToken(electronToken_, collection);
@@ -52,10 +55,7 @@ void ISpyPATElectron::analyze(const edm::Event& event, const edm::EventSetup& ev
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
     
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& electrons = storage->getCollection("PATElectrons_V1");
     IgProperty PT = electrons.addProperty("pt", 0.0);
@@ -73,7 +73,7 @@ void ISpyPATElectron::analyze(const edm::Event& event, const edm::EventSetup& ev
     IgProperty OP   = extras.addProperty("dir_2", IgV3d());
  
     IgAssociations& trackExtras = storage->getAssociations("PATElectronExtras_V1");
-   
+
     for ( std::vector<pat::Electron>::const_iterator t = collection->begin(), tEnd = collection->end(); 
           t != tEnd; ++t )
     {
@@ -154,12 +154,13 @@ void ISpyPATElectron::analyze(const edm::Event& event, const edm::EventSetup& ev
   }
   else
   {
-    std::string error = "### Error: pat::Electrons "
-                        + edm::TypeID (typeid (std::vector<pat::Electron>)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: pat::Electrons "
+             + edm::TypeID (typeid (std::vector<pat::Electron>)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   } 
 }
 
@@ -20,7 +20,7 @@ ISpyPATJet::ISpyPATJet(const edm::ParameterSet& iConfig)
   jetToken_ = consumes<std::vector<pat::Jet> >(inputTag_);
 }
 
-void ISpyPATJet::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPATJet::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -33,7 +33,10 @@ void ISpyPATJet::analyze(const edm::Event& event, const edm::EventSetup& eventSe
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<std::vector<pat::Jet> > collection;
   event.getByToken(jetToken_, collection);
@@ -46,10 +49,7 @@ void ISpyPATJet::analyze(const edm::Event& event, const edm::EventSetup& eventSe
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& jets = storage->getCollection("PATJets_V1");
 
@@ -79,12 +79,13 @@ void ISpyPATJet::analyze(const edm::Event& event, const edm::EventSetup& eventSe
 
    else
    {
-     std::string error = "### Error: pat::Jets "
-                         + edm::TypeID (typeid (std::vector<pat::Jet>)).friendlyClassName() + ":"
-                         + inputTag_.label() + ":"
-                         + inputTag_.instance() + ":"
-                         + inputTag_.process() + " are not found.";
-     config->error(error);
+     config->error (sid, &inputTag_, [&] {
+       return "### Error: pat::Jets "
+              + edm::TypeID (typeid (std::vector<pat::Jet>)).friendlyClassName() + ":"
+              + inputTag_.label() + ":"
+              + inputTag_.instance() + ":"
+              + inputTag_.process() + " are not found.";
+     });
   }
 
 }
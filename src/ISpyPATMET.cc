@@ -20,7 +20,7 @@ ISpyPATMET::ISpyPATMET(const edm::ParameterSet& iConfig)
   metToken_ = consumes<std::vector<pat::MET> >(inputTag_);
 }
 
-void ISpyPATMET::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPATMET::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -33,7 +33,10 @@ void ISpyPATMET::analyze(const edm::Event& event, const edm::EventSetup& eventSe
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<std::vector<pat::MET> > collection;
   event.getByToken(metToken_, collection);
@@ -46,10 +49,7 @@ void ISpyPATMET::analyze(const edm::Event& event, const edm::EventSetup& eventSe
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
  
     IgCollection& mets = storage->getCollection("PATMETs_V1");
 
@@ -74,13 +74,13 @@ void ISpyPATMET::analyze(const edm::Event& event, const edm::EventSetup& eventSe
 
    else
    {
-     std::string error = "### Error: pat::METs "
-                          + edm::TypeID (typeid (std::vector<pat::MET>)).friendlyClassName() + ":"
-                          + inputTag_.label() + ":"
-                          + inputTag_.instance() + ":"
-                          + inputTag_.process() + " are not found.";
-
-     config->error(error);
+     config->error (sid, &inputTag_, [&] {
+       return "### Error: pat::METs "
+              + edm::TypeID (typeid (std::vector<pat::MET>)).friendlyClassName() + ":"
+              + inputTag_.label() + ":"
+              + inputTag_.instance() + ":"
+              + inputTag_.process() + " are not found.";
+     });
   }
 
 }
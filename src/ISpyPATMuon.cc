@@ -1,4 +1,5 @@
 #include "ISpy/Analyzers/interface/ISpyPATMuon.h"
+#include "ISpy/Analyzers/interface/ISpyAssociations.h"
 #include "ISpy/Analyzers/interface/ISpyService.h"
 #include "ISpy/Analyzers/interface/ISpyTrackRefitter.h"
 #include "ISpy/Analyzers/interface/ISpyVector.h"
@@ -16,7 +17,6 @@
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/Exception.h"
 
-#include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
 
 #include "TrackingTools/GeomPropagators/interface/Propagator.h"
 #include "TrackingTools/TrajectoryParametrization/interface/GlobalTrajectoryParameters.h"
@@ -27,6 +27,7 @@
 #include "TrackingTools/Records/interface/DetIdAssociatorRecord.h"
 
 #include "TrackPropagation/SteppingHelixPropagator/interface/SteppingHelixPropagator.h"
+#include "tbb/parallel_for.h"
 #include "DataFormats/GeometrySurface/interface/PlaneBuilder.h"
 
 #include "DataFormats/GeometrySurface/interface/RectangularPlaneBounds.h"
@@ -43,13 +44,9 @@ ISpyPATMuon::ISpyPATMuon(const edm::ParameterSet& iConfig)
   in_ = 0.0;
   out_ = 0.0;
   step_ = 0.05;
-
-  dtGeomValid_ = false;
-  cscGeomValid_ = false;
-  gemGeomValid_ = false;
 }
 
-void ISpyPATMuon::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPATMuon::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   
@@ -62,52 +59,48 @@ void ISpyPATMuon::analyze(const edm::Event& event, const edm::EventSetup& eventS
       "or remove the module that requires it";
   }
 
-  storage_ = config->storage();
-  edm::ESHandle<MagneticField> field; 
-  eventSetup.get<IdealMagneticFieldRecord>().get(field);
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage* storage = config->storage(sid);
+  ISpyESContext& es = config->esContext(sid, eventSetup);
+  const MagneticField* field = es.magneticField();
   
-  if ( ! field.isValid() )
+  if ( ! field )
   {
     std::string error = 
             "### Error: ISpyPATMuon::analyze: Invalid Magnetic field ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
-  eventSetup.get<MuonGeometryRecord>().get(gemGeometry_);
-  eventSetup.get<MuonGeometryRecord>().get(dtGeometry_);
-  eventSetup.get<MuonGeometryRecord>().get(cscGeometry_);
+  const DTGeometry* dtGeom = es.dtGeometry();
+  const CSCGeometry* cscGeom = es.cscGeometry();
+  const GEMGeometry* gemGeom = es.gemGeometry();
 
-  if ( gemGeometry_.isValid() )
-    gemGeomValid_ = true;
-  else
-    config->error("### Error: Muons  GEM Geometry not valid");
+  if ( ! gemGeom )
+    config->error (sid, "### Error: Muons  GEM Geometry not valid");
 
-  if ( dtGeometry_.isValid() )
-    dtGeomValid_ = true;
-  else 
-    config->error("### Error: Muons  DT Geometry not valid");    
+  if ( ! dtGeom )
+    config->error (sid, "### Error: Muons  DT Geometry not valid");    
            
-  if ( cscGeometry_.isValid() )
-    cscGeomValid_ = true;
-  else
-    config->error("### Error: Muons  CSC Geometry not valid");
+  if ( ! cscGeom )
+    config->error (sid, "### Error: Muons  CSC Geometry not valid");
 
-  SteppingHelixPropagator propagator(&(*field), alongMomentum);
-  SteppingHelixPropagator reversePropagator(&(*field), oppositeToMomentum);
+  SteppingHelixPropagator propagator(field, alongMomentum);
 
   edm::Handle<std::vector<pat::Muon> > collection;
   event.getByToken(muonToken_, collection);
 
   if ( ! collection.isValid() )
   {
-    std::string error = "### Error: pat::Muons "
-                        + edm::TypeID (typeid (std::vector<pat::Muon>)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: pat::Muons "
+             + edm::TypeID (typeid (std::vector<pat::Muon>)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
     return;
   }
     
@@ -117,32 +110,63 @@ void ISpyPATMuon::analyze(const edm::Event& event, const edm::EventSetup& eventS
                         + inputTag_.instance() + ":"
                         + inputTag_.process();
     
-  IgCollection& products = storage_->getCollection("Products_V1");
-  IgProperty PROD = products.addProperty("Product", std::string());
-  IgCollectionItem item = products.create();
-  item[PROD] = product;
+  config->product(sid, product);
 
-  IgCollection& trackerMuonCollection = storage_->getCollection("PATTrackerMuons_V2");
+  IgCollection& trackerMuonCollection = storage->getCollection("PATTrackerMuons_V2");
   IgProperty T_PT = trackerMuonCollection.addProperty ("pt", 0.0);
   IgProperty T_CHARGE = trackerMuonCollection.addProperty ("charge", int(0));
   IgProperty T_RP = trackerMuonCollection.addProperty ("rp", IgV3d ());
   IgProperty T_PHI = trackerMuonCollection.addProperty ("phi", 0.0);
   IgProperty T_ETA = trackerMuonCollection.addProperty ("eta", 0.0);
  
-  IgCollection& globalMuonCollection = storage_->getCollection("PATGlobalMuons_V1");
+  IgCollection& globalMuonCollection = storage->getCollection("PATGlobalMuons_V1");
   IgProperty G_PT = globalMuonCollection.addProperty ("pt", 0.0);
   IgProperty G_CHARGE = globalMuonCollection.addProperty ("charge", int(0));
   IgProperty G_RP = globalMuonCollection.addProperty ("rp", IgV3d ());
   IgProperty G_PHI = globalMuonCollection.addProperty ("phi", 0.0);
   IgProperty G_ETA = globalMuonCollection.addProperty ("eta", 0.0);
 
-  IgCollection& extras = storage_->getCollection("Extras_V1");
+  IgCollection& extras = storage->getCollection("Extras_V1");
   IgProperty IPOS = extras.addProperty("pos_1", IgV3d());
   IgProperty IP   = extras.addProperty("dir_1", IgV3d());
   IgProperty OPOS = extras.addProperty("pos_2", IgV3d());
   IgProperty OP   = extras.addProperty("dir_2", IgV3d());
 
-  IgAssociations& trackExtras = storage_->getAssociations("PATMuonTrackExtras_V1");
+  IgAssociations& trackExtras = storage->getAssociations("PATMuonTrackExtras_V1");
+
+  ISpyAssociations muonGlobalPoints(storage, "PATMuonGlobalPoints_V1", "PATMuonGlobalPointRanges_V1",
+                                    config->rangeAssociations());
+
+  ISpyMuonChambers chambers(storage, "PATMuonGlobalChambers_V1", es.muonChamberCache(),
+                            es.muonGeometryCacheIdentifier(),
+                            dtGeom, cscGeom, gemGeom);
+
+  // The global muons are refitted first, concurrently, each into its
+  // own buffer. Everything is then written in order below.
+  std::vector<ISpyTrackRefitter::Refit> refits(collection->size());
+
+  if ( dtGeom || cscGeom || gemGeom )
+  {
+    tbb::parallel_for(size_t(0), refits.size(), [&](size_t i) {
+      std::vector<pat::Muon>::const_iterator t = collection->begin() + i;
+
+      if ( ! (t->isGlobalMuon() && t->globalTrack().isAvailable() && t->isMatchesValid()) )
+        return;
+
+      GlobalPoint outerPoint = getOuterPoint(t, dtGeom, cscGeom, gemGeom);
+
+      try
+      {
+        globalPoints(refits[i].points, t->innerTrack(), outerPoint, field);
+      }
+      catch (cms::Exception& e)
+      {
+        refits[i].points.clear();
+        refits[i].failed = true;
+        refits[i].error = e.explainSelf();
+      }
+    });
+  }
 
   for ( std::vector<pat::Muon>::const_iterator t = collection->begin(), tEnd = collection->end(); 
         t != tEnd; ++t )
@@ -167,7 +191,7 @@ void ISpyPATMuon::analyze(const edm::Event& event, const edm::EventSetup& eventS
       GlobalPoint trackP((*track).vx(), (*track).vy(), (*track).vz());
       GlobalVector trackM((*track).px(), (*track).py(), (*track).pz());
       
-      GlobalTrajectoryParameters trackParams(trackP, trackM, (*track).charge(), &(*field));
+      GlobalTrajectoryParameters trackParams(trackP, trackM, (*track).charge(), field);
       FreeTrajectoryState trackState(trackParams);
 
       // Normally would get this from FiducialVolume but not working for some reason.
@@ -218,14 +242,7 @@ void ISpyPATMuon::analyze(const edm::Event& event, const edm::EventSetup& eventS
       
     if (t->isGlobalMuon() && t->globalTrack().isAvailable() && t->isMatchesValid() ) // Global
     { 
-      GlobalPoint outerPoint;
-
-      if ( dtGeomValid_ || cscGeomValid_ || gemGeomValid_ ) 
-      {
-        addChambers(t);
-        outerPoint = getOuterPoint(t);
-      } 
-      else
+      if ( ! (dtGeom || cscGeom || gemGeom) ) 
       {
         continue;
       }
@@ -242,158 +259,166 @@ void ISpyPATMuon::analyze(const edm::Event& event, const edm::EventSetup& eventS
       imuon[G_PHI] = (*gMuon).phi();
       imuon[G_ETA] = (*gMuon).eta();
 
-      IgAssociations& muonGlobalPoints = storage_->getAssociations("PATMuonGlobalPoints_V1");	
-      IgCollection &points = storage_->getCollection("Points_V1");
-      IgProperty POS = points.addProperty("pos", IgV3d());
+      chambers.add(imuon, t->matches());
 
-      try
-      {
-        // Propagate from the vertex to a surface defined by the outerPoint
-        // (according to the matching chambers)
-        // Use the outerMomentum from this later for the full propagation in which 
-        // we record all the steps. A bit convoluted and complicated perhaps but
-        // good-enough.
-        
-        double minR = sqrt(
-          outerPoint.x()*outerPoint.x() + 
-          outerPoint.y()*outerPoint.y()
-          );
-        
-        double minZ = outerPoint.z();
-        
-        GlobalPoint trackP((*gMuon).vx(), (*gMuon).vy(), (*gMuon).vz());
-        GlobalVector trackM((*gMuon).px(), (*gMuon).py(), (*gMuon).pz());
-        
-        GlobalTrajectoryParameters trackParams(trackP, trackM, (*gMuon).charge(), &(*field));
-        FreeTrajectoryState trackState(trackParams);
+      const ISpyTrackRefitter::Refit& refit = refits[t - collection->begin()];
+
+      if ( refit.failed )
+        ISpyTrackRefitter::reportError(*config, sid, "### Error: ISpyPATMuon::refitTrack exception caught for GlobalMuon", refit);
+      else
+        ISpyTrackRefitter::writePoints(imuon, muonGlobalPoints, storage, refit.points);
+    } // Global
+  } 
+}
+
+// Points of the global muon from the vertex to the outer point given
+// by its matched chambers. Has its own propagators so that it can be
+// run for several muons at once.
+void
+ISpyPATMuon::globalPoints(std::vector<IgV3d>& points,
+                          reco::TrackRef gMuon,
+                          const GlobalPoint& outerPoint,
+                          const MagneticField* field) const
+{
+  SteppingHelixPropagator propagator(field, alongMomentum);
+  SteppingHelixPropagator reversePropagator(field, oppositeToMomentum);
+
+  // Propagate from the vertex to a surface defined by the outerPoint
+  // (according to the matching chambers)
+  // Use the outerMomentum from this later for the full propagation in which 
+  // we record all the steps. A bit convoluted and complicated perhaps but
+  // good-enough.
+
+  double minR = sqrt(
+    outerPoint.x()*outerPoint.x() + 
+    outerPoint.y()*outerPoint.y()
+    );
+  
+  double minZ = outerPoint.z();
+  
+  GlobalPoint trackP((*gMuon).vx(), (*gMuon).vy(), (*gMuon).vz());
+  GlobalVector trackM((*gMuon).px(), (*gMuon).py(), (*gMuon).pz());
+  
+  GlobalTrajectoryParameters trackParams(trackP, trackM, (*gMuon).charge(), field);
+  FreeTrajectoryState trackState(trackParams);
+
+  TrajectoryStateOnSurface tsos = propagator.propagate(
+    trackState, *Cylinder::build(minR, Surface::PositionType(0,0,0), Surface::RotationType())
+    );
+
+  if ( tsos.isValid() && tsos.globalPosition().z() > minZ )
+  {          
+    tsos = propagator.propagate(trackState, *Plane::build(Surface::PositionType(0, 0, minZ), Surface::RotationType()));
+  }
+  else if ( tsos.isValid() && tsos.globalPosition().z() < -minZ )
+  {
+    tsos = propagator.propagate(trackState, *Plane::build(Surface::PositionType(0, 0, -minZ), Surface::RotationType()));
+  }
+
+  GlobalVector mVout;
+
+  if ( tsos.isValid() )
+  {     
+    mVout = GlobalVector(tsos.globalMomentum().x(),
+                         tsos.globalMomentum().y(),
+                         tsos.globalMomentum().z());
+
+  } else 
+  {
+    return;
+  }
+              
+  GlobalPoint mPin((*gMuon).vx(),
+                   (*gMuon).vy(),
+                   (*gMuon).vz());
+
+  GlobalPoint mPout = outerPoint;
+ 
+  GlobalVector InOutVector = (mPout - mPin);
+  GlobalVector zAxis = InOutVector.unit();
+
+  GlobalVector xAxis;
+
+  if (zAxis.x() != 0 || zAxis.y() != 0) 
+  {
+    xAxis = GlobalVector (-zAxis.y(), zAxis.x(), 0).unit();
+  }
+  else 
+  {
+    xAxis = GlobalVector(1, 0, 0);
+  }
+  
+  GlobalVector yAxis(zAxis.cross( xAxis));
+    
+  Surface::RotationType rot(xAxis.x(), xAxis.y(), xAxis.z(),
+                            yAxis.x(), yAxis.y(), yAxis.z(),
+                            zAxis.x(), zAxis.y(), zAxis.z());
+
+  int nSteps = 0;
+  GlobalVector StepVector;
+
+  if( step_ > 0.01 ) 
+  {
+    StepVector = InOutVector * step_;
+    nSteps = int (0.5 + 1.0/step_);
+  }
+  else 
+  {
+    StepVector = InOutVector * 0.01;
+    nSteps = 100;
+  }
+   
+  GlobalVector mVin((*gMuon).px(),
+                    (*gMuon).py(),
+                    (*gMuon).pz());
+    
+  GlobalTrajectoryParameters GTPin(mPin, mVin, (*gMuon).charge(), field);
+  FreeTrajectoryState FTSin(GTPin);
+
+  GlobalTrajectoryParameters GTPout(mPout, mVout, (*gMuon).charge(), field);
+  FreeTrajectoryState FTSout(GTPout);
+  
+  GlobalPoint GP = mPin - StepVector;
+  float w = 0;
+
+  for (int istep = 0; istep < nSteps+1 ; ++istep) 
+  {
+    GP += StepVector;
+    Surface::PositionType pos(GP.x(), GP.y(), GP.z());
+    PlaneBuilder::ReturnType SteppingPlane = PlaneBuilder().plane(pos, rot);
+    TrajectoryStateOnSurface trj_in = propagator.propagate(FTSin, *SteppingPlane);
+    TrajectoryStateOnSurface trj_out = reversePropagator.propagate(FTSout, *SteppingPlane);
+    
+    if (trj_in.isValid() && trj_out.isValid()) 
+    {
+      float x1 = trj_in.globalPosition().x() / 100.0;
+      float y1 = trj_in.globalPosition().y() / 100.0;
+      float z1 = trj_in.globalPosition().z() / 100.0;              
       
-        TrajectoryStateOnSurface tsos = propagator.propagate(
-          trackState, *Cylinder::build(minR, Surface::PositionType(0,0,0), Surface::RotationType())
-          );
+      float x2 = trj_out.globalPosition().x() / 100.0;
+      float y2 = trj_out.globalPosition().y() / 100.0;
+      float z2 = trj_out.globalPosition().z() / 100.0;             
       
-        if ( tsos.isValid() && tsos.globalPosition().z() > minZ )
-        {          
-          tsos = propagator.propagate(trackState, *Plane::build(Surface::PositionType(0, 0, minZ), Surface::RotationType()));
-        }
-        else if ( tsos.isValid() && tsos.globalPosition().z() < -minZ )
-        {
-          tsos = propagator.propagate(trackState, *Plane::build(Surface::PositionType(0, 0, -minZ), Surface::RotationType()));
-        }
-
-        GlobalVector mVout;
-
-        if ( tsos.isValid() )
-        {     
-          mVout = GlobalVector(tsos.globalMomentum().x(),
-                               tsos.globalMomentum().y(),
-                               tsos.globalMomentum().z());
-
-        } else 
-        {
-          continue;
-        }
-                    
-        GlobalPoint mPin((*gMuon).vx(),
-                         (*gMuon).vy(),
-                         (*gMuon).vz());
-
-        GlobalPoint mPout = outerPoint;
-       
-        GlobalVector InOutVector = (mPout - mPin);
-        GlobalVector zAxis = InOutVector.unit();
-
-        GlobalVector xAxis;
-
-        if (zAxis.x() != 0 || zAxis.y() != 0) 
-        {
-          xAxis = GlobalVector (-zAxis.y(), zAxis.x(), 0).unit();
-        }
-        else 
-        {
-          xAxis = GlobalVector(1, 0, 0);
-        }
-        
-        GlobalVector yAxis(zAxis.cross( xAxis));
-          
-        Surface::RotationType rot(xAxis.x(), xAxis.y(), xAxis.z(),
-                                  yAxis.x(), yAxis.y(), yAxis.z(),
-                                  zAxis.x(), zAxis.y(), zAxis.z());
-
-        int nSteps = 0;
-        GlobalVector StepVector;
+      float ww = 0.;
+      (w < 0.4999) ? ww = w : ww=1.0-w;
+      float w2 = 0.5*ww*ww/((1.0-ww)*(1.0-ww));
+      if(w>0.4999) w2=1.0-w2;  
+      
+      float x = (1.0-w2)*x1 + w2*x2;
+      float y = (1.0-w2)*y1 + w2*y2;
+      float z = (1.0-w2)*z1 + w2*z2;
+      
+      points.push_back(IgV3d(x,y,z));
+    }
     
-        if( step_ > 0.01 ) 
-        {
-          StepVector = InOutVector * step_;
-          nSteps = int (0.5 + 1.0/step_);
-        }
-        else 
-        {
-          StepVector = InOutVector * 0.01;
-          nSteps = 100;
-        }
-         
-        GlobalVector mVin((*gMuon).px(),
-                          (*gMuon).py(),
-                          (*gMuon).pz());
-          
-        GlobalTrajectoryParameters GTPin(mPin, mVin, (*gMuon).charge(), &(*field));
-        FreeTrajectoryState FTSin(GTPin);
-
-        GlobalTrajectoryParameters GTPout(mPout, mVout, (*gMuon).charge(), &(*field));
-        FreeTrajectoryState FTSout(GTPout);
-        
-        GlobalPoint GP = mPin - StepVector;
-        float w = 0;
-
-        for (int istep = 0; istep < nSteps+1 ; ++istep) 
-        {
-          GP += StepVector;
-          Surface::PositionType pos(GP.x(), GP.y(), GP.z());
-          PlaneBuilder::ReturnType SteppingPlane = PlaneBuilder().plane(pos, rot);
-          TrajectoryStateOnSurface trj_in = propagator.propagate(FTSin, *SteppingPlane);
-          TrajectoryStateOnSurface trj_out = reversePropagator.propagate(FTSout, *SteppingPlane);
-          
-          if (trj_in.isValid() && trj_out.isValid()) 
-          {
-            float x1 = trj_in.globalPosition().x() / 100.0;
-            float y1 = trj_in.globalPosition().y() / 100.0;
-            float z1 = trj_in.globalPosition().z() / 100.0;              
-            
-            float x2 = trj_out.globalPosition().x() / 100.0;
-            float y2 = trj_out.globalPosition().y() / 100.0;
-            float z2 = trj_out.globalPosition().z() / 100.0;             
-            
-            float ww = 0.;
-            (w < 0.4999) ? ww = w : ww=1.0-w;
-            float w2 = 0.5*ww*ww/((1.0-ww)*(1.0-ww));
-            if(w>0.4999) w2=1.0-w2;  
-            
-            float x = (1.0-w2)*x1 + w2*x2;
-            float y = (1.0-w2)*y1 + w2*y2;
-            float z = (1.0-w2)*z1 + w2*z2;
-            
-            IgCollectionItem ipoint = points.create();
-            ipoint[POS] = IgV3d(x,y,z);
-            muonGlobalPoints.associate(imuon, ipoint);               
-          }
-          
-          w += 1.0/float(nSteps);
-        }
-        
-      }    
-      catch (cms::Exception& e)
-      {
-        std::string error = 
-          "### Error: ISpyPATMuon::refitTrack exception caught for GlobalMuon:";
-        error += e.explainSelf();
-        config->error (error);
-      }  
-    } // Global
-  } 
+    w += 1.0/float(nSteps);
+  }
 }
 
-GlobalPoint& ISpyPATMuon::getOuterPoint(std::vector<pat::Muon>::const_iterator it) 
+GlobalPoint ISpyPATMuon::getOuterPoint(std::vector<pat::Muon>::const_iterator it,
+                                       const DTGeometry* dtGeometry,
+                                       const CSCGeometry* cscGeometry,
+                                       const GEMGeometry* gemGeometry) const
 {  
   const std::vector<reco::MuonChamberMatch> &dets = it->matches();
   const GeomDet* geomDet;
@@ -404,17 +429,17 @@ GlobalPoint& ISpyPATMuon::getOuterPoint(std::vector<pat::Muon>::const_iterator i
                                                                ditEnd = dets.end(); 
         dit != ditEnd; ++dit )
   {
-    if ( dit->detector() == MuonSubdetId::GEM )
+    if ( dit->detector() == MuonSubdetId::GEM && gemGeometry )
     { 
-      geomDet = gemGeometry_->idToDet((*dit).id);
+      geomDet = gemGeometry->idToDet((*dit).id);
     } 
-    else if ( dit->detector() == MuonSubdetId::CSC )
+    else if ( dit->detector() == MuonSubdetId::CSC && cscGeometry )
     {  
-      geomDet = cscGeometry_->idToDet((*dit).id);
+      geomDet = cscGeometry->idToDet((*dit).id);
     }
-    else if ( dit->detector() == MuonSubdetId::DT )
+    else if ( dit->detector() == MuonSubdetId::DT && dtGeometry )
     { 
-      geomDet = dtGeometry_->idToDet((*dit).id);
+      geomDet = dtGeometry->idToDet((*dit).id);
     }
     else
       continue;
@@ -424,103 +449,11 @@ GlobalPoint& ISpyPATMuon::getOuterPoint(std::vector<pat::Muon>::const_iterator i
     
   }
   
-  return gps.back();
-
-}
+  if ( gps.empty() )
+    return GlobalPoint();
 
-void ISpyPATMuon::addChambers(std::vector<pat::Muon>::const_iterator it)
-{      
-  IgCollection& chambers = storage_->getCollection("MuonChambers_V1");
-  IgProperty DETID = chambers.addProperty("detid", int(0));
-  IgProperty FRONT_1 = chambers.addProperty("front_1", IgV3d());
-  IgProperty FRONT_2 = chambers.addProperty("front_2", IgV3d());
-  IgProperty FRONT_3 = chambers.addProperty("front_3", IgV3d());
-  IgProperty FRONT_4 = chambers.addProperty("front_4", IgV3d());
-  IgProperty BACK_1 = chambers.addProperty("back_1", IgV3d());
-  IgProperty BACK_2 = chambers.addProperty("back_2", IgV3d());
-  IgProperty BACK_3 = chambers.addProperty("back_3", IgV3d());
-  IgProperty BACK_4 = chambers.addProperty("back_4", IgV3d());
-
-  const std::vector<reco::MuonChamberMatch> &dets = (*it).matches();
-  const GeomDet* geomDet;
-  float length, width, thickness;
-
-  for ( std::vector<reco::MuonChamberMatch>::const_iterator dit = dets.begin(), 
-                                                         ditEnd = dets.end(); 
-        dit != ditEnd; ++dit )
-  {
-    if ( dit->detector() == MuonSubdetId::GEM )
-    {  
-      geomDet = gemGeometry_->idToDet((*dit).id);
-    }
-    else if ( dit->detector() == MuonSubdetId::CSC )
-    {
-      geomDet = cscGeometry_->idToDet((*dit).id);
-    }
-    else if ( dit->detector() == MuonSubdetId::DT )
-    { 
-      geomDet = dtGeometry_->idToDet((*dit).id);
-    }
-    else
-      continue;
-
-    GlobalPoint p[8];
-    const Bounds* b = &(geomDet->surface().bounds());
-    IgCollectionItem chamber = chambers.create();
-    chamber[DETID] = static_cast<int>((*dit).id.rawId());
+  return gps.back();
 
-    if ( const TrapezoidalPlaneBounds* b2 = dynamic_cast<const TrapezoidalPlaneBounds*>(b) )
-    {  
-      float parameters[4] = {  
-        b2->parameters()[0],
-        b2->parameters()[1],
-        b2->parameters()[2],
-        b2->parameters()[3] 
-      };
-
-      p[0] = geomDet->surface().toGlobal(LocalPoint(parameters[0],-parameters[3],parameters[2])); 
-      p[1] = geomDet->surface().toGlobal(LocalPoint(-parameters[0],-parameters[3],parameters[2])); 
-      p[2] = geomDet->surface().toGlobal(LocalPoint(parameters[1],parameters[3],parameters[2])); 
-      p[3] = geomDet->surface().toGlobal(LocalPoint(-parameters[1],parameters[3],parameters[2])); 
-      p[4] = geomDet->surface().toGlobal(LocalPoint(parameters[0],-parameters[3],-parameters[2])); 
-      p[5] = geomDet->surface().toGlobal(LocalPoint(-parameters[0],-parameters[3],-parameters[2])); 
-      p[6] = geomDet->surface().toGlobal(LocalPoint(parameters[1],parameters[3],-parameters[2])); 
-      p[7] = geomDet->surface().toGlobal(LocalPoint(-parameters[1],parameters[3],-parameters[2]));
-    }
-      
-    if ( dynamic_cast<const RectangularPlaneBounds*>(b) )
-    {            
-      length = geomDet->surface().bounds().length();
-      width = geomDet->surface().bounds().width();
-      thickness = geomDet->surface().bounds().thickness();
-
-      p[0] = geomDet->surface().toGlobal(LocalPoint(width/2,length/2,thickness/2)); 
-      p[1] = geomDet->surface().toGlobal(LocalPoint(width/2,-length/2,thickness/2)); 
-      p[2] = geomDet->surface().toGlobal(LocalPoint(-width/2,length/2,thickness/2)); 
-      p[3] = geomDet->surface().toGlobal(LocalPoint(-width/2,-length/2,thickness/2)); 
-      p[4] = geomDet->surface().toGlobal(LocalPoint(width/2,length/2,-thickness/2)); 
-      p[5] = geomDet->surface().toGlobal(LocalPoint(width/2,-length/2,-thickness/2)); 
-      p[6] = geomDet->surface().toGlobal(LocalPoint(-width/2,length/2,-thickness/2)); 
-      p[7] = geomDet->surface().toGlobal(LocalPoint(-width/2,-length/2,-thickness/2));    
-    }
-    
-    chamber[FRONT_1] =        
-      IgV3d(static_cast<double>(p[0].x()/100.0), static_cast<double>(p[0].y()/100.0), static_cast<double>(p[0].z()/100.0));
-    chamber[FRONT_2] = 
-      IgV3d(static_cast<double>(p[1].x()/100.0), static_cast<double>(p[1].y()/100.0), static_cast<double>(p[1].z()/100.0));
-    chamber[FRONT_4] = 
-      IgV3d(static_cast<double>(p[2].x()/100.0), static_cast<double>(p[2].y()/100.0), static_cast<double>(p[2].z()/100.0));
-    chamber[FRONT_3] = 
-      IgV3d(static_cast<double>(p[3].x()/100.0), static_cast<double>(p[3].y()/100.0), static_cast<double>(p[3].z()/100.0));
-    chamber[BACK_1] = 
-      IgV3d(static_cast<double>(p[4].x()/100.0), static_cast<double>(p[4].y()/100.0), static_cast<double>(p[4].z()/100.0));
-    chamber[BACK_2] = 
-      IgV3d(static_cast<double>(p[5].x()/100.0), static_cast<double>(p[5].y()/100.0), static_cast<double>(p[5].z()/100.0));
-    chamber[BACK_4] = 
-      IgV3d(static_cast<double>(p[6].x()/100.0), static_cast<double>(p[6].y()/100.0), static_cast<double>(p[6].z()/100.0));
-    chamber[BACK_3] = 
-      IgV3d(static_cast<double>(p[7].x()/100.0), static_cast<double>(p[7].y()/100.0), static_cast<double>(p[7].z()/100.0));
-  }
 }
 
 DEFINE_FWK_MODULE(ISpyPATMuon);
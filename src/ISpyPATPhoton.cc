@@ -20,7 +20,7 @@ ISpyPATPhoton::ISpyPATPhoton(const edm::ParameterSet& iConfig)
   photonToken_ = consumes<std::vector<pat::Photon> >(inputTag_);
 }
 
-void ISpyPATPhoton::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPATPhoton::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -33,7 +33,10 @@ void ISpyPATPhoton::analyze(const edm::Event& event, const edm::EventSetup& even
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<std::vector<pat::Photon> > collection;
   event.getByToken(photonToken_, collection);
@@ -46,10 +49,7 @@ void ISpyPATPhoton::analyze(const edm::Event& event, const edm::EventSetup& even
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& photons = storage->getCollection("PATPhotons_V1");
 
@@ -75,12 +75,13 @@ void ISpyPATPhoton::analyze(const edm::Event& event, const edm::EventSetup& even
   }
   else
   {
-    std::string error = "### Error: pat::Photons "
-                        + edm::TypeID (typeid (std::vector<pat::Photon>)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: pat::Photons "
+             + edm::TypeID (typeid (std::vector<pat::Photon>)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
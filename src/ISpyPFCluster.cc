@@ -1,4 +1,5 @@
 #include "ISpy/Analyzers/interface/ISpyPFCluster.h"
+#include "ISpy/Analyzers/interface/ISpyAssociations.h"
 #include "ISpy/Analyzers/interface/ISpyService.h"
 #include "ISpy/Services/interface/IgCollection.h"
 
@@ -29,10 +30,12 @@ using namespace reco;
 
 ISpyPFCluster::ISpyPFCluster(const edm::ParameterSet& iConfig)
     : inputTag_ (iConfig.getParameter<edm::InputTag>("iSpyPFClusterTag"))
-{}
+{
+  clusterToken_ = consumes<reco::PFClusterCollection>(inputTag_);
+}
 
 void 
-ISpyPFCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyPFCluster::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
     
@@ -45,21 +48,23 @@ ISpyPFCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
  
-  edm::ESHandle<CaloGeometry> caloGeometry;
-  eventSetup.get<CaloGeometryRecord>().get(caloGeometry);
+  const CaloGeometry* caloGeometry = config->esContext(sid, eventSetup).caloGeometry();
    
-  if ( ! caloGeometry.isValid() )
+  if ( ! caloGeometry )
   {
     std::string error = 
       "### Error: ISpyPFCluster::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
   edm::Handle<PFClusterCollection> collection;
-  event.getByLabel (inputTag_, collection);
+  event.getByToken (clusterToken_, collection);
 
   if ( collection.isValid() )
   {	     
@@ -69,10 +74,7 @@ ISpyPFCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
                           + inputTag_.instance() + ":" 
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& ebclusters = storage->getCollection("PFEBClusters_V1");
     IgProperty EB_ENERGY = ebclusters.addProperty("energy", 0.0); 
@@ -102,7 +104,12 @@ ISpyPFCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
     IgProperty B3 = rechits.addProperty("back_3", IgV3d());
     IgProperty B4 = rechits.addProperty("back_4", IgV3d());
 	
-    IgAssociations& clusterRecHits = storage->getAssociations("PFClusterPFRecHitFractions_V1");
+    // The EB and EE clusters share the association set, but ranges
+    // are by row and so need one collection each
+    ISpyAssociations ebRecHits(storage, "PFClusterPFRecHitFractions_V1", "PFEBClusterRecHitRanges_V1",
+                               config->rangeAssociations());
+    ISpyAssociations eeRecHits(storage, "PFClusterPFRecHitFractions_V1", "PFEEClusterRecHitRanges_V1",
+                               config->rangeAssociations());
 
     for ( std::vector<PFCluster>::const_iterator cluster = collection->begin(), clusterEnd = collection->end();
           cluster != clusterEnd; ++cluster )
@@ -124,7 +131,7 @@ ISpyPFCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
           IgCollectionItem rh = rechits.create();
 
           const CaloCellGeometry::CornersVec& corners 
-            = (*caloGeometry).getGeometry((*iR).recHitRef()->detId())->getCorners();
+            = caloGeometry->getGeometry((*iR).recHitRef()->detId())->getCorners();
 		
           assert(corners.size() == 8);
 
@@ -139,7 +146,7 @@ ISpyPFCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
           rh[B3] = IgV3d(corners[5].x()/100.0, corners[5].y()/100.0, corners[5].z()/100.0);
           rh[B4] = IgV3d(corners[4].x()/100.0, corners[4].y()/100.0, corners[4].z()/100.0);
         
-          clusterRecHits.associate(cl,rh);
+          ebRecHits.associate(cl,rh);
         }
       }
       
@@ -160,7 +167,7 @@ ISpyPFCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
           IgCollectionItem rh = rechits.create();
 
           const CaloCellGeometry::CornersVec& corners 
-            = (*caloGeometry).getGeometry((*iR).recHitRef()->detId())->getCorners();
+            = caloGeometry->getGeometry((*iR).recHitRef()->detId())->getCorners();
 		
           assert(corners.size() == 8);
 
@@ -175,7 +182,7 @@ ISpyPFCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
           rh[B3] = IgV3d(corners[5].x()/100.0, corners[5].y()/100.0, corners[5].z()/100.0);
           rh[B4] = IgV3d(corners[4].x()/100.0, corners[4].y()/100.0, corners[4].z()/100.0);
             
-          clusterRecHits.associate(cl,rh);
+          eeRecHits.associate(cl,rh);
         }
       }
       
@@ -187,12 +194,13 @@ ISpyPFCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetu
   }
   else 
   {
-    std::string error = "### Error: PFClusters "
-                        + edm::TypeID (typeid (PFClusterCollection)).friendlyClassName () + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: PFClusters "
+             + edm::TypeID (typeid (PFClusterCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -29,7 +29,7 @@ ISpyPFEcalRecHit::ISpyPFEcalRecHit(const edm::ParameterSet& iConfig)
   rechitToken_ = consumes<reco::PFRecHitCollection>(inputTag_);
 }
 
-void ISpyPFEcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPFEcalRecHit::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
     
@@ -42,16 +42,18 @@ void ISpyPFEcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<CaloGeometry> caloGeometry;
-  eventSetup.get<CaloGeometryRecord>().get(caloGeometry);
+  const CaloGeometry* caloGeometry = config->esContext(sid, eventSetup).caloGeometry();
      
-  if ( ! caloGeometry.isValid() )
+  if ( ! caloGeometry )
   {
     std::string error = 
       "### Error: ISpyPFEcalRecHit::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -66,10 +68,7 @@ void ISpyPFEcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
                           + inputTag_.instance() + ":" 
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     // EB
     IgCollection& ebrechits = storage->getCollection("PFEBRecHits_V2");
@@ -118,7 +117,7 @@ void ISpyPFEcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
 
         
         const CaloCellGeometry::CornersVec& corners 
-          = (*caloGeometry).getGeometry((*rechit).detId())->getCorners();
+          = caloGeometry->getGeometry((*rechit).detId())->getCorners();
 		
         assert(corners.size() == 8);
 
@@ -141,7 +140,7 @@ void ISpyPFEcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
         rh[EE_DETID] = (*rechit).detId();
 
         const CaloCellGeometry::CornersVec& corners 
-          = (*caloGeometry).getGeometry((*rechit).detId())->getCorners();
+          = caloGeometry->getGeometry((*rechit).detId())->getCorners();
 		
         assert(corners.size() == 8);
 
@@ -163,12 +162,13 @@ void ISpyPFEcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
   }  
   else 
   {	
-    std::string error = "### Error: PFRecHits "
-                        + edm::TypeID (typeid (reco::PFRecHitCollection)).friendlyClassName() + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: PFRecHits "
+             + edm::TypeID (typeid (reco::PFRecHitCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -33,7 +33,7 @@ ISpyPFHcalRecHit::ISpyPFHcalRecHit(const edm::ParameterSet& iConfig)
   hoToken_ = consumes<reco::PFRecHitCollection>(hoInputTag_);
 }
 
-void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPFHcalRecHit::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
     
@@ -46,16 +46,18 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<CaloGeometry> caloGeometry;
-  eventSetup.get<CaloGeometryRecord>().get(caloGeometry);
+  const CaloGeometry* caloGeometry = config->esContext(sid, eventSetup).caloGeometry();
      
-  if ( ! caloGeometry.isValid() )
+  if ( ! caloGeometry )
   {
     std::string error = 
       "### Error: ISpyPFHcalRecHit::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -70,10 +72,7 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
                           + hbheInputTag_.instance() + ":" 
                           + hbheInputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     // HB
     IgCollection& hbrechits = storage->getCollection("PFHBRecHits_V1");
@@ -123,7 +122,7 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
 
         
         const CaloCellGeometry::CornersVec& corners 
-          = (*caloGeometry).getGeometry((*rechit).detId())->getCorners();
+          = caloGeometry->getGeometry((*rechit).detId())->getCorners();
 		
         assert(corners.size() == 8);
 
@@ -146,7 +145,7 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
         rh[HE_DETID] = (*rechit).detId();
 
         const CaloCellGeometry::CornersVec& corners 
-          = (*caloGeometry).getGeometry((*rechit).detId())->getCorners();
+          = caloGeometry->getGeometry((*rechit).detId())->getCorners();
 		
         assert(corners.size() == 8);
 
@@ -166,12 +165,13 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
   }  
   else 
   {	
-    std::string error = "### Error: PFRecHits "
-                        + edm::TypeID (typeid (reco::PFRecHitCollection)).friendlyClassName() + ":" 
-                        + hbheInputTag_.label() + ":"
-                        + hbheInputTag_.instance() + ":" 
-                        + hbheInputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &hbheInputTag_, [&] {
+      return "### Error: PFRecHits "
+             + edm::TypeID (typeid (reco::PFRecHitCollection)).friendlyClassName() + ":"
+             + hbheInputTag_.label() + ":"
+             + hbheInputTag_.instance() + ":"
+             + hbheInputTag_.process() + " are not found.";
+    });
   }
 
   edm::Handle<reco::PFRecHitCollection> hf_collection;
@@ -185,10 +185,7 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
                           + hfInputTag_.instance() + ":" 
                           + hfInputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& hfrechits = storage->getCollection("PFHFRecHits_V1");
  
@@ -204,7 +201,7 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
     IgProperty HF_B2 = hfrechits.addProperty("back_2", IgV3d());
     IgProperty HF_B3 = hfrechits.addProperty("back_3", IgV3d());
     IgProperty HF_B4 = hfrechits.addProperty("back_4", IgV3d());
-    
+
     for ( std::vector<reco::PFRecHit>::const_iterator rechit = hf_collection->begin();
           rechit != hf_collection->end(); ++rechit )
     {
@@ -216,7 +213,7 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
       rh[HF_DETID] = (*rechit).detId();
 
       const CaloCellGeometry::CornersVec& corners 
-        = (*caloGeometry).getGeometry((*rechit).detId())->getCorners();
+        = caloGeometry->getGeometry((*rechit).detId())->getCorners();
 		
       assert(corners.size() == 8);
 
@@ -234,12 +231,13 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
   }  
   else 
   {	
-    std::string error = "### Error: PFRecHits "
-                        + edm::TypeID (typeid (reco::PFRecHitCollection)).friendlyClassName() + ":" 
-                        + hfInputTag_.label() + ":"
-                        + hfInputTag_.instance() + ":" 
-                        + hfInputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &hfInputTag_, [&] {
+      return "### Error: PFRecHits "
+             + edm::TypeID (typeid (reco::PFRecHitCollection)).friendlyClassName() + ":"
+             + hfInputTag_.label() + ":"
+             + hfInputTag_.instance() + ":"
+             + hfInputTag_.process() + " are not found.";
+    });
   }
 
   
@@ -254,10 +252,7 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
                           + hoInputTag_.instance() + ":" 
                           + hoInputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& horechits = storage->getCollection("PFHORecHits_V1");
  
@@ -273,7 +268,7 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
     IgProperty HO_B2 = horechits.addProperty("back_2", IgV3d());
     IgProperty HO_B3 = horechits.addProperty("back_3", IgV3d());
     IgProperty HO_B4 = horechits.addProperty("back_4", IgV3d());
-    
+
     for ( std::vector<reco::PFRecHit>::const_iterator rechit = ho_collection->begin();
           rechit != ho_collection->end(); ++rechit )
     {
@@ -285,7 +280,7 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
       rh[HO_DETID] = (*rechit).detId();
 
       const CaloCellGeometry::CornersVec& corners 
-        = (*caloGeometry).getGeometry((*rechit).detId())->getCorners();
+        = caloGeometry->getGeometry((*rechit).detId())->getCorners();
 		
       assert(corners.size() == 8);
 
@@ -303,12 +298,13 @@ void ISpyPFHcalRecHit::analyze(const edm::Event& event, const edm::EventSetup& e
   }  
   else 
   {	
-    std::string error = "### Error: PFRecHits "
-                        + edm::TypeID (typeid (reco::PFRecHitCollection)).friendlyClassName() + ":" 
-                        + hoInputTag_.label() + ":"
-                        + hoInputTag_.instance() + ":" 
-                        + hoInputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &hoInputTag_, [&] {
+      return "### Error: PFRecHits "
+             + edm::TypeID (typeid (reco::PFRecHitCollection)).friendlyClassName() + ":"
+             + hoInputTag_.label() + ":"
+             + hoInputTag_.instance() + ":"
+             + hoInputTag_.process() + " are not found.";
+    });
   }
 
 
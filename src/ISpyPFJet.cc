@@ -25,7 +25,7 @@ ISpyPFJet::ISpyPFJet(const edm::ParameterSet& iConfig)
   jetToken_ = consumes<PFJetCollection>(inputTag_);
 }
 
-void ISpyPFJet::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPFJet::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -38,7 +38,10 @@ void ISpyPFJet::analyze(const edm::Event& event, const edm::EventSetup& eventSet
      "or remove the module that requires it"; 
  }
 
-  IgDataStorage *storage = config->storage();
+ if ( config->pruned(moduleDescription().id()) )
+   return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<PFJetCollection> collection;
   event.getByToken(jetToken_, collection);
@@ -51,10 +54,7 @@ void ISpyPFJet::analyze(const edm::Event& event, const edm::EventSetup& eventSet
                            + inputTag_.instance() + ":"
                            + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& jets = storage->getCollection("PFJets_V2");
 
@@ -92,13 +92,13 @@ void ISpyPFJet::analyze(const edm::Event& event, const edm::EventSetup& eventSet
 
   else
   {
-    std::string error = "### Error: PFJets "
-                        + edm::TypeID (typeid (PFJetCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-
-    config->error(error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: PFJets "
+             + edm::TypeID (typeid (PFJetCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
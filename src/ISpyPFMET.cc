@@ -23,7 +23,7 @@ ISpyPFMET::ISpyPFMET(const edm::ParameterSet& iConfig)
   metToken_ = consumes<PFMETCollection>(inputTag_);
 }
 
-void ISpyPFMET::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPFMET::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -36,7 +36,10 @@ void ISpyPFMET::analyze(const edm::Event& event, const edm::EventSetup& eventSet
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<PFMETCollection> collection;
   event.getByToken(metToken_, collection);
@@ -49,10 +52,7 @@ void ISpyPFMET::analyze(const edm::Event& event, const edm::EventSetup& eventSet
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& mets = storage->getCollection("PFMETs_V1");
    
@@ -61,7 +61,7 @@ void ISpyPFMET::analyze(const edm::Event& event, const edm::EventSetup& eventSet
     IgProperty PX  = mets.addProperty("px",  0.0);
     IgProperty PY  = mets.addProperty("py",  0.0);
     IgProperty PZ  = mets.addProperty("pz",  0.0);
- 
+
     for ( PFMETCollection::const_iterator it = collection->begin(), itEnd = collection->end(); it != itEnd; ++it)
     {   
       IgCollectionItem m = mets.create();
@@ -77,13 +77,13 @@ void ISpyPFMET::analyze(const edm::Event& event, const edm::EventSetup& eventSet
 
    else
    {
-     std::string error = "### Error: PFMETs "
-                          + edm::TypeID (typeid (PFMETCollection)).friendlyClassName() + ":"
-                          + inputTag_.label() + ":"
-                          + inputTag_.instance() + ":"
-                          + inputTag_.process() + " are not found.";
-
-     config->error(error);
+     config->error (sid, &inputTag_, [&] {
+       return "### Error: PFMETs "
+              + edm::TypeID (typeid (PFMETCollection)).friendlyClassName() + ":"
+              + inputTag_.label() + ":"
+              + inputTag_.instance() + ":"
+              + inputTag_.process() + " are not found.";
+     });
   }
 
 }
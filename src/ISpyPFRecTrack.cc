@@ -23,9 +23,11 @@ using namespace edm::service;
 
 ISpyPFRecTrack::ISpyPFRecTrack(const edm::ParameterSet& iConfig)
     : inputTag_(iConfig.getParameter<edm::InputTag>("iSpyPFRecTrackTag"))
-{}
+{
+  trackToken_ = consumes<reco::PFRecTrackCollection>(inputTag_);
+}
 
-void ISpyPFRecTrack::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPFRecTrack::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
     
@@ -38,12 +40,15 @@ void ISpyPFRecTrack::analyze(const edm::Event& event, const edm::EventSetup& eve
       "or remove the module that requires it";
   }
 
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
   edm::Handle<reco::PFRecTrackCollection> collection;
-  event.getByLabel(inputTag_, collection);
+  event.getByToken(trackToken_, collection);
 
   if ( collection.isValid() )
   {
-    IgDataStorage *storage = config->storage();
+    IgDataStorage *storage = config->storage(sid);
     
     std::string product = "PFRecTracks "
                           + edm::TypeID (typeid (reco::PFRecTrackCollection)).friendlyClassName () + ":" 
@@ -51,10 +56,7 @@ void ISpyPFRecTrack::analyze(const edm::Event& event, const edm::EventSetup& eve
                           + inputTag_.instance() + ":" 
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& rectracks = storage->getCollection("PFRecTracks_V1");
 
@@ -70,7 +72,7 @@ void ISpyPFRecTrack::analyze(const edm::Event& event, const edm::EventSetup& eve
     //IgProperty DIR = trajpts.addProperty("dir", IgV3d());
 	
     IgAssociations& tracktrajs = storage->getAssociations("PFRecTrackTrajectoryPoints_V1");
-    
+
     for ( std::vector<reco::PFRecTrack>::const_iterator rectrack = collection->begin();
           rectrack != collection->end(); ++rectrack )
     {
@@ -123,12 +125,13 @@ void ISpyPFRecTrack::analyze(const edm::Event& event, const edm::EventSetup& eve
   }    
   else 
   {
-    std::string error = "### Error: PFRecTracks "
-                        + edm::TypeID (typeid (reco::PFRecTrackCollection)).friendlyClassName() + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: PFRecTracks "
+             + edm::TypeID (typeid (reco::PFRecTrackCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
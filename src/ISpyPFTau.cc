@@ -18,9 +18,12 @@ using namespace edm;
 using namespace reco;
 
 ISpyPFTau::ISpyPFTau(const edm::ParameterSet& iConfig)
-: inputTag_(iConfig.getParameter<edm::InputTag>("iSpyPFTauTag")){}
+: inputTag_(iConfig.getParameter<edm::InputTag>("iSpyPFTauTag"))
+{
+  tauToken_ = consumes<reco::PFTauCollection>(inputTag_);
+}
 
-void ISpyPFTau::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPFTau::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -33,10 +36,13 @@ void ISpyPFTau::analyze(const edm::Event& event, const edm::EventSetup& eventSet
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<PFTauCollection> collection;
-  event.getByLabel(inputTag_, collection);
+  event.getByToken(tauToken_, collection);
 
   if ( collection.isValid() )
   {
@@ -46,10 +52,7 @@ void ISpyPFTau::analyze(const edm::Event& event, const edm::EventSetup& eventSet
                            + inputTag_.instance() + ":"
                            + inputTag_.process();
 
-     IgCollection& products = storage->getCollection("Products_V1");
-     IgProperty PROD = products.addProperty("Product", std::string ());
-     IgCollectionItem item = products.create();
-     item[PROD] = product;
+     config->product(sid, product);
 
      IgCollection& taus = storage->getCollection("PFTaus_V1");
 
@@ -111,11 +114,12 @@ void ISpyPFTau::analyze(const edm::Event& event, const edm::EventSetup& eventSet
 
    else
    {
-     std::string error = "### Error: PFTaus "
-                          + edm::TypeID (typeid (PFTauCollection)).friendlyClassName() + ":"
-                          + inputTag_.label() + ":"
-                          + inputTag_.instance() + " are not found";
-      config->error(error);
+     config->error (sid, &inputTag_, [&] {
+       return "### Error: PFTaus "
+              + edm::TypeID (typeid (PFTauCollection)).friendlyClassName() + ":"
+              + inputTag_.label() + ":"
+              + inputTag_.instance() + " are not found";
+     });
   }
 
 }
@@ -1,6 +1,7 @@
 #include "ISpy/Analyzers/interface/ISpyPackedCandidate.h"
 #include "ISpy/Analyzers/interface/ISpyService.h"
 #include "ISpy/Analyzers/interface/ISpyVector.h"
+#include "ISpy/Analyzers/interface/ISpyVertexSelector.h"
 
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/EventSetup.h"
@@ -28,14 +29,23 @@ using namespace edm::service;
 using namespace edm;
 
 #include <iostream>
+#include <memory>
 
 ISpyPackedCandidate::ISpyPackedCandidate(const ParameterSet& iConfig)
-: inputTag_(iConfig.getParameter<InputTag>("iSpyPackedCandidateTag"))
+: inputTag_(iConfig.getParameter<InputTag>("iSpyPackedCandidateTag")),
+  primaryVertexOnly_(iConfig.getUntrackedParameter<bool>("primaryVertexOnly", false)),
+  vertexInputTag_(iConfig.getUntrackedParameter<InputTag>("iSpyPriVertexTag", InputTag("offlineSlimmedPrimaryVertices"))),
+  maxVertices_(iConfig.getUntrackedParameter<unsigned int>("maxVertices", 1)),
+  maxDz_(iConfig.getUntrackedParameter<double>("maxDz", 0.2)),
+  maxDxy_(iConfig.getUntrackedParameter<double>("maxDxy", 0.5))
 {
   candidateToken_ = consumes<pat::PackedCandidateCollection>(inputTag_);
+
+  if ( primaryVertexOnly_ )
+    vertexToken_ = consumes<reco::VertexCollection>(vertexInputTag_);
 }
 
-void ISpyPackedCandidate::analyze(const Event& event, const EventSetup& eventSetup)
+void ISpyPackedCandidate::analyze(edm::StreamID sid, const Event& event, const EventSetup& eventSetup) const
 {
   Service<ISpyService> config;
 
@@ -48,24 +58,33 @@ void ISpyPackedCandidate::analyze(const Event& event, const EventSetup& eventSet
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   Handle<pat::PackedCandidateCollection> collection;
   event.getByToken(candidateToken_, collection);
 
-  ESHandle<MagneticField> field;
-  eventSetup.get<IdealMagneticFieldRecord>().get(field);
+  const MagneticField* field = config->esContext(sid, eventSetup).magneticField();
 
-  if ( ! field.isValid() )
+  if ( ! field )
   {
     std::string error = 
       "### Error: ISpyMuon::analyze: Invalid Magnetic field ";
     
-    config->error (error);
+    config->error (sid, error);
     return;
   }
   
-  SteppingHelixPropagator propagator(&(*field), alongMomentum);
+  SteppingHelixPropagator propagator(field, alongMomentum);
+
+  // With primaryVertexOnly only the tracks from the leading vertices are shown
+  std::unique_ptr<ISpyVertexSelector> vertices;
+
+  if ( primaryVertexOnly_ )
+    vertices = ISpyVertexSelector::fromEvent(*config, sid, event, vertexToken_, vertexInputTag_,
+                                             maxVertices_, maxDz_, maxDxy_);
  
   if ( collection.isValid() )
   {
@@ -75,10 +94,7 @@ void ISpyPackedCandidate::analyze(const Event& event, const EventSetup& eventSet
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &tracks = storage->getCollection("Tracks_V4");
     IgProperty VTX = tracks.addProperty("pos", IgV3d());
@@ -104,6 +120,9 @@ void ISpyPackedCandidate::analyze(const Event& event, const EventSetup& eventSet
       if ( ! (*c).hasTrackDetails() )
         continue;
 
+      if ( vertices && ! vertices->compatible(*c) )
+        continue;
+
       IgCollectionItem track = tracks.create();
 
       track[VTX] = IgV3d((*c).vx()/100.,
@@ -129,7 +148,7 @@ void ISpyPackedCandidate::analyze(const Event& event, const EventSetup& eventSet
       GlobalPoint trackP((*c).vx(), (*c).vy(), (*c).vz());
       GlobalVector trackM((*c).px(), (*c).py(), (*c).pz());  
 
-      GlobalTrajectoryParameters trackParams(trackP, trackM, (*c).charge(), &(*field));
+      GlobalTrajectoryParameters trackParams(trackP, trackM, (*c).charge(), field);
       FreeTrajectoryState trackState(trackParams);
 
       // NOTE: Ideally would get this from FiducicalVolume
@@ -180,11 +199,12 @@ void ISpyPackedCandidate::analyze(const Event& event, const EventSetup& eventSet
 
   else
   {
-    std::string error = "### Error: PackedCandidates "
-                        + TypeID (typeid (pat::PackedCandidateCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + " are not found";
-    config->error(error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: PackedCandidates "
+             + TypeID (typeid (pat::PackedCandidateCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + " are not found";
+    });
   }
 }
 
@@ -23,7 +23,7 @@ ISpyPhoton::ISpyPhoton(const edm::ParameterSet& iConfig)
   photonToken_ = consumes<PhotonCollection>(inputTag_);
 }
 
-void ISpyPhoton::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPhoton::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   
@@ -36,7 +36,10 @@ void ISpyPhoton::analyze(const edm::Event& event, const edm::EventSetup& eventSe
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<PhotonCollection> collection;
   event.getByToken(photonToken_, collection);
@@ -49,10 +52,7 @@ void ISpyPhoton::analyze(const edm::Event& event, const edm::EventSetup& eventSe
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& photons = storage->getCollection("Photons_V1");
       
@@ -144,12 +144,13 @@ void ISpyPhoton::analyze(const edm::Event& event, const edm::EventSetup& eventSe
   }
   else
   {
-    std::string error = "### Error: Photons "
-                        + edm::TypeID (typeid (PhotonCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: Photons "
+             + edm::TypeID (typeid (PhotonCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -18,14 +18,27 @@
 #include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
 #include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
 
+#include <string>
+
 using namespace edm::service;
 
 ISpyPixelDigi::ISpyPixelDigi (const edm::ParameterSet& iConfig)
-  : inputTag_ (iConfig.getParameter<edm::InputTag>("iSpyPixelDigiTag"))
-{}
+  : inputTag_ (iConfig.getParameter<edm::InputTag>("iSpyPixelDigiTag")),
+    occupancy_ (iConfig.getUntrackedParameter<bool>("occupancy", false)),
+    packed_ (iConfig.getUntrackedParameter<bool>("packed", false))
+{
+  if ( occupancy_ && packed_ )
+  {
+    throw cms::Exception ("Configuration")
+      << "ISpyPixelDigi: occupancy and packed are two different outputs,\n"
+      "set at most one of them";
+  }
+
+  digiToken_ = consumes<edm::DetSetVector<PixelDigi> >(inputTag_);
+}
 
 void 
-ISpyPixelDigi::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyPixelDigi::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -38,7 +51,10 @@ ISpyPixelDigi::analyze (const edm::Event& event, const edm::EventSetup& eventSet
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
     
   edm::ESHandle<TrackerGeometry> geom;
   eventSetup.get<TrackerDigiGeometryRecord> ().get (geom);
@@ -47,12 +63,12 @@ ISpyPixelDigi::analyze (const edm::Event& event, const edm::EventSetup& eventSet
   {
     std::string error = 
       "### Error: ISpyPixelDigi::analyze: Invalid TrackerDigiGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
   edm::Handle<edm::DetSetVector<PixelDigi> > collection;
-  event.getByLabel (inputTag_, collection);
+  event.getByToken (digiToken_, collection);
 
   if (collection.isValid ())
   {	    
@@ -62,10 +78,85 @@ ISpyPixelDigi::analyze (const edm::Event& event, const edm::EventSetup& eventSet
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 	
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
+
+    edm::DetSetVector<PixelDigi>::const_iterator it = collection->begin();
+    edm::DetSetVector<PixelDigi>::const_iterator end = collection->end();
+
+    if ( occupancy_ )
+    {
+      IgCollection &modules = storage->getCollection ("PixelOccupancy_V1");
+      IgProperty M_DET_ID = modules.addProperty ("detid", int (0));
+      IgProperty M_POS    = modules.addProperty ("pos", IgV3d());
+      IgProperty M_DIGIS  = modules.addProperty ("digis", int (0));
+      IgProperty M_ADC    = modules.addProperty ("adc", int (0));
+
+      for (; it != end; ++it )
+      {
+	const edm::DetSet<PixelDigi>& ds = *it;
+
+	if ( ds.data.empty() )
+	  continue;
+
+	int adc = 0;
+
+	for ( edm::DetSet<PixelDigi>::const_iterator idigi = ds.data.begin(), idigiEnd = ds.data.end();
+	      idigi != idigiEnd; ++idigi )
+	  adc += (*idigi).adc();
+
+	GlobalPoint pos = geom->idToDet (DetId (ds.id))->surface ().position ();
+
+	IgCollectionItem module = modules.create ();
+	module[M_DET_ID] = static_cast<int> (ds.id);
+	module[M_POS] = IgV3d(static_cast<double>(pos.x()/100.0),
+			      static_cast<double>(pos.y()/100.0),
+			      static_cast<double>(pos.z()/100.0));
+	module[M_DIGIS] = static_cast<int> (ds.data.size());
+	module[M_ADC] = adc;
+      }
+
+      return;
+    }
+
+    if ( packed_ )
+    {
+      // One row per module with the row, column and adc of each digi
+      // in turn, comma separated. The positions are left to the
+      // viewer, from the geometry file.
+      IgCollection &modules = storage->getCollection ("PixelDigis_V2");
+      IgProperty M_DET_ID = modules.addProperty ("detid", int (0));
+      IgProperty M_DIGIS  = modules.addProperty ("digis", std::string ());
+
+      std::string digis;
+
+      for (; it != end; ++it )
+      {
+	const edm::DetSet<PixelDigi>& ds = *it;
+
+	if ( ds.data.empty() )
+	  continue;
+
+	digis.clear();
+
+	for ( edm::DetSet<PixelDigi>::const_iterator idigi = ds.data.begin(), idigiEnd = ds.data.end();
+	      idigi != idigiEnd; ++idigi )
+	{
+	  if ( ! digis.empty() )
+	    digis += ',';
+	  digis += std::to_string((*idigi).row());
+	  digis += ',';
+	  digis += std::to_string((*idigi).column());
+	  digis += ',';
+	  digis += std::to_string((*idigi).adc());
+	}
+
+	IgCollectionItem module = modules.create ();
+	module[M_DET_ID] = static_cast<int> (ds.id);
+	module[M_DIGIS] = digis;
+      }
+
+      return;
+    }
 
     IgCollection &digis = storage->getCollection ("PixelDigis_V1");
     IgProperty DET_ID   = digis.addProperty ("detid", int (0)); 
@@ -76,32 +167,29 @@ ISpyPixelDigi::analyze (const edm::Event& event, const edm::EventSetup& eventSet
     IgProperty COL = digis.addProperty("column", int(0));
     IgProperty CH = digis.addProperty("channel", int(0));
 
-    edm::DetSetVector<PixelDigi>::const_iterator it = collection->begin();
-    edm::DetSetVector<PixelDigi>::const_iterator end = collection->end();
-	
     for (; it != end; ++it )
     {
-      edm::DetSet<PixelDigi> ds = *it;
+      const edm::DetSet<PixelDigi>& ds = *it;
 
       if ( ds.data.size() )
       {
-	const uint32_t& detID = ds.id;
-	DetId detid (detID);
-		
+	DetId detid (ds.id);
+
+	// The position is that of the module, the same for all its digis
+	GlobalPoint pos = (geom->idToDet (detid))->surface ().position ();
+	IgV3d modulePos (static_cast<double>(pos.x()/100.0), 
+			 static_cast<double>(pos.y()/100.0), 
+			 static_cast<double>(pos.z()/100.0));
+
 	edm::DetSet<PixelDigi>::const_iterator idigi = ds.data.begin();
 	edm::DetSet<PixelDigi>::const_iterator idigiEnd = ds.data.end();
-	
+
 	for(; idigi != idigiEnd; ++idigi)
 	{ 
-	  GlobalPoint pos = (geom->idToDet (detid))->surface ().position ();
-		    
 	  IgCollectionItem item = digis.create ();
 		    
 	  item[DET_ID] = static_cast<int> (detid);
-
-	  item[POS] = IgV3d(static_cast<double>(pos.x()/100.0), 
-			    static_cast<double>(pos.y()/100.0), 
-			    static_cast<double>(pos.z()/100.0));
+	  item[POS] = modulePos;
 
 	  item[ADC] = static_cast<int>((*idigi).adc());
 	  item[ROW] = static_cast<int>((*idigi).row());
@@ -113,12 +201,13 @@ ISpyPixelDigi::analyze (const edm::Event& event, const edm::EventSetup& eventSet
   }
   else 
   {
-    std::string error = "### Error: PixelDigis "
-			+ edm::TypeID (typeid (edm::DetSetVector<PixelDigi>)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: PixelDigis "
+             + edm::TypeID (typeid (edm::DetSetVector<PixelDigi>)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -21,9 +21,13 @@ using namespace edm::service;
 using namespace edm;
 
 ISpyPreshowerCluster::ISpyPreshowerCluster(const edm::ParameterSet& iConfig)
-: inputTags_(iConfig.getParameter<std::vector<edm::InputTag> >("iSpyPreshowerClusterTags")){}
+: inputTags_(iConfig.getParameter<std::vector<edm::InputTag> >("iSpyPreshowerClusterTags"))
+{
+  for ( VInputTag::const_iterator ti = inputTags_.begin(); ti != inputTags_.end(); ++ti )
+    clusterTokens_.push_back(consumes<reco::PreshowerClusterCollection>(*ti));
+}
 
-void ISpyPreshowerCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyPreshowerCluster::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -36,16 +40,18 @@ void ISpyPreshowerCluster::analyze(const edm::Event& event, const edm::EventSetu
       "or remove the module that requires it";
   }
 
-  IgDataStorage* storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage* storage = config->storage(sid);
 
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord> ().get (geom);
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyPreshowerCluster::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -53,7 +59,7 @@ void ISpyPreshowerCluster::analyze(const edm::Event& event, const edm::EventSetu
 	ti != inputTags_.end(); ++ti )
   {
     edm::Handle<reco::PreshowerClusterCollection> collection;
-    event.getByLabel(*ti, collection);
+    event.getByToken(clusterTokens_[ti - inputTags_.begin()], collection);
 
     if ( collection.isValid() )
     {
@@ -63,10 +69,7 @@ void ISpyPreshowerCluster::analyze(const edm::Event& event, const edm::EventSetu
                             + (*ti).instance() + ":"
                             + (*ti).process();
 
-      IgCollection& products = storage->getCollection("Products_V1");
-      IgProperty PROD = products.addProperty("Product", std::string ());
-      IgCollectionItem item = products.create();
-      item[PROD] = product;
+      config->product(sid, product);
 
       IgCollection& clusters = storage->getCollection("PreshowerClusters_V1");
       IgProperty E    = clusters.addProperty("energy", 0.0);
@@ -107,7 +110,8 @@ void ISpyPreshowerCluster::analyze(const edm::Event& event, const edm::EventSetu
         c[ET] = (*ci).et();
 
         std::vector<std::pair<DetId, float> > hitsAndFractions = (*ci).hitsAndFractions();
-      
+
+
         for ( std::vector<std::pair<DetId, float> >::iterator hi = 
                 hitsAndFractions.begin(), hie = hitsAndFractions.end(); hi != hie; ++hi )
         {
@@ -115,7 +119,7 @@ void ISpyPreshowerCluster::analyze(const edm::Event& event, const edm::EventSetu
           rhf[DETID] = (*hi).first;
           rhf[FRACT] = static_cast<double>((*hi).second);
 
-          auto cell = (*geom).getGeometry((*hi).first);
+          auto cell = geom->getGeometry((*hi).first);
           const CaloCellGeometry::CornersVec& corners = cell->getCorners();
         
           assert(corners.size() == 8);
@@ -136,12 +140,13 @@ void ISpyPreshowerCluster::analyze(const edm::Event& event, const edm::EventSetu
     }
     else
     {
-      std::string error = "### Error: PreshowerClusters "
-                          + edm::TypeID (typeid (reco::PreshowerClusterCollection)).friendlyClassName() + ":"
-                          + (*ti).label() + ":"
-                          + (*ti).instance() + ":"
-                          + (*ti).process() + " are not found.";
-      config->error (error);
+      config->error (sid, &(*ti), [&] {
+        return "### Error: PreshowerClusters "
+               + edm::TypeID (typeid (reco::PreshowerClusterCollection)).friendlyClassName() + ":"
+               + (*ti).label() + ":"
+               + (*ti).instance() + ":"
+               + (*ti).process() + " are not found.";
+      });
     }
   }
 }
@@ -29,7 +29,7 @@ ISpyRPCRecHit::ISpyRPCRecHit (const edm::ParameterSet& iConfig)
 }
 
 void
-ISpyRPCRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyRPCRecHit::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
   
@@ -42,23 +42,25 @@ ISpyRPCRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSet
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
-  edm::ESHandle<RPCGeometry> geom;
-  eventSetup.get<MuonGeometryRecord>().get(geom);
+  const RPCGeometry* geom = config->esContext(sid, eventSetup).rpcGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyRPCRecHit::analyze: Invalid MuonGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
     
   edm::Handle<RPCRecHitCollection> collection;
   event.getByToken(rechitToken_, collection);
 
-  if ( collection.isValid() && geom.isValid() )
+  if ( collection.isValid() && geom )
   {	    
     std::string product = "RPCRecHits "
                           + edm::TypeID (typeid (RPCRecHitCollection)).friendlyClassName() + ":" 
@@ -66,10 +68,7 @@ ISpyRPCRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSet
                           + inputTag_.instance() + ":" 
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &recHits = storage->getCollection("RPCRecHits_V1");
     IgProperty U1 = recHits.addProperty("u1", IgV3d());
@@ -100,7 +99,7 @@ ISpyRPCRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSet
         std::stringstream ss;
         ss << (*it).rpcId();
         error += ss.str();
-        config->error(error);
+        config->error (sid, error);
         continue;
       }
 
@@ -112,7 +111,11 @@ ISpyRPCRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSet
       float dx = sqrt(it->localPositionError ().xx ());
       float dy = sqrt(it->localPositionError ().yy ());
 
-      GlobalPoint gp;
+      GlobalPoint gp = det->surface().toGlobal(xyzLocal);
+
+      if ( ! config->inRegionOfInterest(sid, gp.eta(), gp.phi()) )
+        continue;
+
       IgCollectionItem irechit = recHits.create();
     
       gp = det->surface().toGlobal(LocalPoint((x - dx), y, z));
@@ -142,12 +145,13 @@ ISpyRPCRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSet
   }
   else 
   {
-    std::string error = "### Error: RPCRecHits "
-                        + edm::TypeID (typeid (RPCRecHitCollection)).friendlyClassName () + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: RPCRecHits "
+             + edm::TypeID (typeid (RPCRecHitCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -0,0 +1,92 @@
+#include "ISpy/Analyzers/interface/ISpyRegionOfInterest.h"
+#include "ISpy/Analyzers/interface/ISpyService.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+
+using namespace edm::service;
+
+namespace
+{
+  bool byPt(const reco::Candidate* a, const reco::Candidate* b)
+  {
+    return a->pt() > b->pt();
+  }
+}
+
+ISpyRegionOfInterest::ISpyRegionOfInterest(const edm::ParameterSet& iConfig)
+{
+  std::vector<edm::ParameterSet> sources = iConfig.getParameter<std::vector<edm::ParameterSet> >("sources");
+
+  for ( std::vector<edm::ParameterSet>::const_iterator si = sources.begin(), siEnd = sources.end();
+        si != siEnd; ++si )
+  {
+    Source source;
+    source.tag = si->getParameter<edm::InputTag>("src");
+    source.token = consumes<edm::View<reco::Candidate> >(source.tag);
+    source.maxObjects = si->getParameter<unsigned int>("maxObjects");
+    source.minPt = si->getParameter<double>("minPt");
+    source.deltaR = si->getParameter<double>("deltaR");
+
+    sources_.push_back(source);
+  }
+}
+
+void
+ISpyRegionOfInterest::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup&) const
+{
+  edm::Service<ISpyService> config;
+
+  if ( ! config.isAvailable() ) 
+  {
+    throw cms::Exception ("Configuration")
+      << "ISpyRegionOfInterest requires the ISpyService\n"
+      "which is not present in the configuration file.\n"
+      "You must add the service in the configuration file\n"
+      "or remove the module that requires it";
+  }
+
+  config->beginRegionOfInterest(sid);
+
+  std::vector<const reco::Candidate*> leading;
+
+  for ( std::vector<Source>::const_iterator source = sources_.begin(), sourceEnd = sources_.end();
+        source != sourceEnd; ++source )
+  {
+    edm::Handle<edm::View<reco::Candidate> > collection;
+    event.getByToken(source->token, collection);
+
+    if ( ! collection.isValid() )
+    {
+      config->error (sid, &source->tag, [&] {
+        return "### Error: RegionOfInterest "
+               + source->tag.label() + ":"
+               + source->tag.instance() + ":"
+               + source->tag.process() + " are not found.";
+      });
+      continue;
+    }
+
+    leading.clear();
+
+    for ( edm::View<reco::Candidate>::const_iterator ci = collection->begin(), ciEnd = collection->end();
+          ci != ciEnd; ++ci )
+    {
+      if ( ci->pt() >= source->minPt )
+        leading.push_back(&(*ci));
+    }
+
+    size_t n = std::min(leading.size(), static_cast<size_t>(source->maxObjects));
+    std::partial_sort(leading.begin(), leading.begin() + n, leading.end(), byPt);
+
+    for ( size_t i = 0; i < n; ++i )
+      config->addRegionOfInterest(sid, leading[i]->eta(), leading[i]->phi(), source->deltaR);
+  }
+}
+
+DEFINE_FWK_MODULE(ISpyRegionOfInterest);
@@ -2,27 +2,72 @@
 #include "ISpy/Services/interface/IgCollection.h"
 #include "ISpy/Services/interface/IgArchive.h"
 
+#include "DataFormats/Math/interface/deltaPhi.h"
+#include "DataFormats/Provenance/interface/BranchDescription.h"
+#include "DataFormats/Provenance/interface/BranchType.h"
 #include "DataFormats/Provenance/interface/EventID.h"
+#include "DataFormats/Provenance/interface/ModuleDescription.h"
+#include "DataFormats/Provenance/interface/ProductRegistry.h"
 #include "DataFormats/Provenance/interface/Provenance.h"
 #include "DataFormats/Provenance/interface/Timestamp.h"
 
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/ConstProductRegistry.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ServiceRegistry/interface/ServiceMaker.h"
 #include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/ServiceRegistry/interface/ConsumesInfo.h"
+#include "FWCore/ServiceRegistry/interface/ModuleCallingContext.h"
+#include "FWCore/ServiceRegistry/interface/PathsAndConsumesOfModulesBase.h"
 #include "FWCore/ServiceRegistry/interface/StreamContext.h"
+#include "FWCore/ServiceRegistry/interface/SystemBounds.h"
+#include "FWCore/Utilities/interface/ProductKindOfType.h"
 #include "FWCore/Version/interface/GetReleaseVersion.h"
 
+#include <algorithm>
 #include <iostream>
 #include <cstdio>
 #include <sstream>
 
+#include <sys/resource.h>
+
+#include <zlib.h>
+
 #include "boost/date_time/posix_time/posix_time.hpp"
 
 using namespace edm::service;
 
+namespace
+{
+  bool registered(const edm::ProductRegistry::ProductList& products, const edm::ConsumesInfo& info)
+  {
+    std::string label(info.label());
+    std::string instance(info.instance());
+    std::string process(info.process());
+
+    // "@skipCurrentProcess" and the like: any process will do
+    if ( ! process.empty() && process[0] == '@' )
+      process.clear();
+
+    for ( edm::ProductRegistry::ProductList::const_iterator pi = products.begin(), piEnd = products.end();
+          pi != piEnd; ++pi )
+    {
+      const edm::BranchDescription& bd = pi->second;
+
+      if ( bd.branchType() == edm::InEvent
+           && bd.unwrappedTypeID() == info.type()
+           && bd.moduleLabel() == label
+           && bd.productInstanceName() == instance
+           && (process.empty() || bd.processName() == process) )
+        return true;
+    }
+
+    return false;
+  }
+}
+
 ISpyService::ISpyService (const ParameterSet& iPSet, ActivityRegistry& iRegistry)
   : outputFileName_(iPSet.getUntrackedParameter<std::string>( "outputFileName", std::string("default.ig"))),
     outputESFileName_(iPSet.getUntrackedParameter<std::string>( "outputESFileName", std::string("defaultES.ig"))),
@@ -30,26 +75,139 @@ ISpyService::ISpyService (const ParameterSet& iPSet, ActivityRegistry& iRegistry
     fileExt_(std::string(".ig")),
     currentExt_(std::string("")),
     outputMaxEvents_(iPSet.getUntrackedParameter<int>( "outputMaxEvents", -1)),
+    compressionLevel_(iPSet.getUntrackedParameter<int>("compressionLevel", 9)),
+    timing_(iPSet.getUntrackedParameter<bool>("timing", false)),
+    rangeAssociations_(iPSet.getUntrackedParameter<bool>("rangeAssociations", false)),
+    stringTable_(iPSet.getUntrackedParameter<bool>("stringTable", false)),
+    traceSerialize_(0),
+    traceDeflate_(0),
+    traceZipWrite_(0),
+    traceRollover_(0),
     eventCounter_(0),
     fileCounter_(0),
-    currentRun_(-1),
-    currentEvent_(-1)
+    zipFile0_(0),
+    zipFile1_(0),
+    topEvents_(iPSet.getUntrackedParameter<unsigned int>("topEvents", 0)),
+    topEventsMaxBytes_(static_cast<size_t>(iPSet.getUntrackedParameter<unsigned int>("topEventsMemoryMB", 512)) << 20),
+    topEventsBytes_(0),
+    spillFile_(0)
 {
+  iRegistry.watchPreallocate(this,&ISpyService::preallocate);
+
+  if ( iPSet.getUntrackedParameter<bool>("pruneMissingInputs", true) )
+    iRegistry.watchPreBeginJob(this,&ISpyService::preBeginJob);
   iRegistry.watchPostBeginJob(this,&ISpyService::postBeginJob);
   iRegistry.watchPostEndJob(this,&ISpyService::postEndJob);
 
   iRegistry.watchPreEvent(this,&ISpyService::preEvent);
   iRegistry.watchPostEvent(this,&ISpyService::postEvent);
 
+  std::string traceFileName = iPSet.getUntrackedParameter<std::string>("traceFileName", std::string(""));
+
+  if ( ! traceFileName.empty() )
+  {
+    tracer_.reset(new ISpyTracer(traceFileName, iPSet.getUntrackedParameter<unsigned int>("traceBufferSize", 1 << 16)));
+
+    traceSerialize_ = tracer_->name("serialize", "ISpyService");
+    traceDeflate_ = tracer_->name("deflate", "ISpyService");
+    traceZipWrite_ = tracer_->name("zip write", "ISpyService");
+    traceRollover_ = tracer_->name("rollover", "ISpyService");
+
+    iRegistry.watchPreModuleBeginJob(this,&ISpyService::preModuleBeginJob);
+    iRegistry.watchPreModuleEvent(this,&ISpyService::preModuleEvent);
+    iRegistry.watchPostModuleEvent(this,&ISpyService::postModuleEvent);
+  }
+
   outputFileName_ = outputFilePath_ + outputFileName_;
   outputESFileName_ = outputFilePath_ + outputESFileName_;
 
   makeHeader();
 }
 
+void
+ISpyService::preallocate(const edm::service::SystemBounds& bounds)
+{
+  streams_.resize(bounds.maxNumberOfStreams());
+
+  esContexts_.clear();
+  for ( unsigned int i = 0; i < bounds.maxNumberOfStreams(); ++i )
+    esContexts_.push_back(std::unique_ptr<ISpyESContext>(new ISpyESContext(muonChamberCache_)));
+}
+
+void
+ISpyService::preBeginJob(const edm::PathsAndConsumesOfModulesBase& pathsAndConsumes, const edm::ProcessContext&)
+{
+  edm::Service<edm::ConstProductRegistry> registry;
+  const edm::ProductRegistry::ProductList& products = registry->productList();
+
+  std::vector<const edm::ModuleDescription*> modules = pathsAndConsumes.allModules();
+  std::stringstream summary;
+
+  for ( std::vector<const edm::ModuleDescription*>::const_iterator mi = modules.begin(), miEnd = modules.end();
+        mi != miEnd; ++mi )
+  {
+    if ( (*mi)->moduleName().compare(0, 4, "ISpy") != 0 )
+      continue;
+
+    std::vector<edm::ConsumesInfo> consumes = pathsAndConsumes.consumesInfo((*mi)->id());
+    std::vector<std::string> missing;
+    size_t inputs = 0;
+
+    for ( std::vector<edm::ConsumesInfo>::const_iterator ci = consumes.begin(), ciEnd = consumes.end();
+          ci != ciEnd; ++ci )
+    {
+      if ( ci->branchType() != edm::InEvent )
+        continue;
+
+      ++inputs;
+
+      // Views are matched on the element type, leave those be
+      if ( ci->kindOfType() != edm::PRODUCT_TYPE || registered(products, *ci) )
+        continue;
+
+      missing.push_back(ci->type().friendlyClassName() + ":"
+                        + std::string(ci->label()) + ":"
+                        + std::string(ci->instance()) + ":"
+                        + std::string(ci->process()));
+    }
+
+    if ( inputs == 0 || missing.size() != inputs )
+      continue;
+
+    if ( pruned_.size() <= (*mi)->id() )
+      pruned_.resize((*mi)->id() + 1, false);
+
+    pruned_[(*mi)->id()] = true;
+
+    summary << "\n  " << (*mi)->moduleLabel() << ":";
+
+    for ( std::vector<std::string>::const_iterator si = missing.begin(), siEnd = missing.end();
+          si != siEnd; ++si )
+      summary << " " << *si;
+  }
+
+  if ( summary.str().empty() )
+    return;
+
+  ErrorEntry entry;
+  entry.message = "### Error: ISpy modules disabled, their inputs are not in the job:" + summary.str();
+  entry.run = 0;
+  entry.event = 0;
+  entry.count = 1;
+
+  edm::LogWarning("ISpyService") << entry.message;
+
+  // Straight into the table: the first event stays as it is
+  std::lock_guard<std::mutex> lock(errorsMutex_);
+  errorIds_.insert(std::make_pair(entry.message, static_cast<int>(errors_.size())));
+  errors_.push_back(entry);
+}
+
 void
 ISpyService::postBeginJob (void)
 {
+  beginTime_ = std::chrono::steady_clock::now();
+
   // If the input file has an .ig file extension (and it should)
   // then add 0 counter (replacing bare .ig). 
   // If not, then add counter and extension anyway.     
@@ -87,35 +245,7 @@ void
 ISpyService::writeHeader(zipFile& zfile)
 {
   std::string hs("Header");
-  
-  zip_fileinfo zi;
-
-  time_t now = time(0);
-  boost::posix_time::ptime bt = boost::posix_time::from_time_t(now);
-  tm tt = boost::posix_time::to_tm(bt);
-                                                                                                         
-  zi.tmz_date.tm_sec  = tt.tm_sec;
-  zi.tmz_date.tm_min  = tt.tm_min;
-  zi.tmz_date.tm_hour = tt.tm_hour;
-  zi.tmz_date.tm_mday = tt.tm_mday;
-  zi.tmz_date.tm_mon  = tt.tm_mon;
-  zi.tmz_date.tm_year = tt.tm_year;
-  zi.dosDate = 0;
-  zi.internal_fa = 0;
-  zi.external_fa = 0;
-
-  ziperr_ = zipOpenNewFileInZip(zfile, (outputFilePath_ + hs).c_str(), &zi,
-				0, 0, 0, 0, 0, // other stuff                                                                         
-				Z_DEFLATED, // method                                                                                 
-				9);
-  assert(ziperr_ == ZIP_OK);
-
-  std::stringstream doss;
-  doss << header_; 
-  write(doss, zfile);
-
-  ziperr_ = zipCloseFileInZip(zfile);
-  assert(ziperr_ == ZIP_OK);
+  writeEntry(outputFilePath_ + hs, header_, zfile);
 }
 
 void
@@ -135,158 +265,629 @@ ISpyService::close(zipFile& zf)
 void
 ISpyService::postEndJob(void)
 {
+  if ( topEvents_ )
+    writeTopEvents();
+
   // If we haven't yet reached the max number of events
   // for each ig file but are at the end of the root input
   // OR we are writing all events to the file 
   // (i.e. no max number set), close zip file which contains events
 
-  if ( (eventCounter_ > 0 && eventCounter_ < outputMaxEvents_) || 
-       outputMaxEvents_ == -1 ) 
+  if ( zipFile0_ )
+  {
+    writeStrings(zipFile0_);
+    writeErrors(zipFile0_);
     close(zipFile0_);
+  }
         
   close(zipFile1_);
+
+  if ( timing_ )
+    reportTiming();
+
+  if ( tracer_ )
+    tracer_->write();
 }
 
 void
-ISpyService::preEvent(const edm::StreamContext& sc)
+ISpyService::preModuleBeginJob(const edm::ModuleDescription& md)
+{
+  // Only the ISpy modules are traced
+  if ( md.moduleName().compare(0, 4, "ISpy") != 0 )
+    return;
+
+  if ( traceModules_.size() <= md.id() )
+    traceModules_.resize(md.id() + 1, -1);
+
+  traceModules_[md.id()] = tracer_->name(md.moduleLabel(), md.moduleName());
+}
+
+void
+ISpyService::preModuleEvent(const edm::StreamContext& sc, const edm::ModuleCallingContext& mcc)
 {
-  currentRun_   = sc.eventID().run();
-  currentEvent_ = sc.eventID().event();
+  unsigned int id = mcc.moduleDescription()->id();
 
-  storages_[0] = new IgDataStorage;
-  storages_[1] = new IgDataStorage;
+  if ( id < traceModules_.size() && traceModules_[id] >= 0 )
+    tracer_->begin(traceModules_[id], sc.streamID().value());
+}
 
-  // If an ig file has already been written but we have yet to
-  // process an event for the next bunch, then open a new zip file
-  if ( fileCounter_ > 0 && eventCounter_ == 0 )
+void
+ISpyService::postModuleEvent(const edm::StreamContext& sc, const edm::ModuleCallingContext& mcc)
+{
+  unsigned int id = mcc.moduleDescription()->id();
+
+  if ( id < traceModules_.size() && traceModules_[id] >= 0 )
+    tracer_->end(traceModules_[id], sc.streamID().value());
+}
+
+void
+ISpyService::reportTiming(void)
+{
+  unsigned long events = 0;
+  unsigned long long rawBytes = 0;
+  double serializeTime = 0.0;
+  double writeTime = 0.0;
+
+  for ( std::vector<StreamStorage>::const_iterator ss = streams_.begin(), ssEnd = streams_.end();
+        ss != ssEnd; ++ss )
   {
-    std::stringstream foss;
-    foss << fileCounter_;
+    events += ss->events;
+    rawBytes += ss->rawBytes;
+    serializeTime += ss->serializeTime;
+    writeTime += ss->writeTime;
+  }
+
+  double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - beginTime_).count();
+  double mb = rawBytes/double(1 << 20);
+
+  // ru_maxrss is in kB on Linux
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  edm::LogVerbatim("ISpyService")
+    << "ISpyService: " << events << " events, " << mb << " MB serialized, "
+    << streams_.size() << " streams, compression level " << compressionLevel_ << "\n"
+    << "  serialize: " << serializeTime << " s (" << (serializeTime > 0 ? mb/serializeTime : 0.0) << " MB/s)\n"
+    << "  write:     " << writeTime << " s (" << (writeTime > 0 ? mb/writeTime : 0.0) << " MB/s)\n"
+    << "  job:       " << wallTime << " s (" << (wallTime > 0 ? events/wallTime : 0.0) << " events/s)\n"
+    << "  peak RSS:  " << usage.ru_maxrss/1024.0 << " MB";
+}
+
+void
+ISpyService::preEvent(const edm::StreamContext& sc)
+{
+  StreamStorage& ss = streams_[sc.streamID().value()];
+
+  ss.run   = sc.eventID().run();
+  ss.event = sc.eventID().event();
+  ss.score = 0.0;
+  ss.roiActive = false;
+  ss.esBound = false;
+  ss.rois.clear();
+  ss.errorIds.clear();
+
+  ss.storages[0] = new IgDataStorage;
+  ss.storages[1] = new IgDataStorage;
+}
+
+void
+ISpyService::nextFile(void)
+{
+  // An ig file has already been written and this is the first 
+  // event for the next bunch, so open a new zip file
+  std::stringstream foss;
+  foss << fileCounter_;
     
-    size_t found = outputFileName_.find(currentExt_);
-    std::string newExt("_"+foss.str()+fileExt_); 
+  size_t found = outputFileName_.find(currentExt_);
+  std::string newExt("_"+foss.str()+fileExt_); 
 
-    if ( found != std::string::npos )
-      outputFileName_.erase(outputFileName_.end() - currentExt_.length(), outputFileName_.end());
+  if ( found != std::string::npos )
+    outputFileName_.erase(outputFileName_.end() - currentExt_.length(), outputFileName_.end());
       
-    outputFileName_.append(newExt);
-    currentExt_ = newExt;
-    open(outputFileName_, zipFile0_);
-  }
+  outputFileName_.append(newExt);
+  currentExt_ = newExt;
+  open(outputFileName_, zipFile0_);
 }
 
 void
 ISpyService::postEvent(const edm::StreamContext& sc)
 {    
-  if ( ! storages_[0]->empty() )
+  StreamStorage& ss = streams_[sc.streamID().value()];
+
+  // Serialize outside of the lock: only the archive is shared
+  // between the streams.
+  if ( ! ss.storages[0]->empty() )
   {
     std::stringstream eoss;
-    eoss << "Events/Run_" << currentRun_ << "/Event_" << currentEvent_;
+    eoss << "Events/Run_" << ss.run << "/Event_" << ss.event;
 
-    zip_fileinfo zi;
+    bool keep = true;
 
-    time_t now = time(0);
-    boost::posix_time::ptime bt = boost::posix_time::from_time_t(now);
-    tm tt = boost::posix_time::to_tm(bt);
-                                                                                                         
-    zi.tmz_date.tm_sec  = tt.tm_sec;
-    zi.tmz_date.tm_min  = tt.tm_min;
-    zi.tmz_date.tm_hour = tt.tm_hour;
-    zi.tmz_date.tm_mday = tt.tm_mday;
-    zi.tmz_date.tm_mon  = tt.tm_mon;
-    zi.tmz_date.tm_year = tt.tm_year;
-    zi.dosDate = 0;
-    zi.internal_fa = 0;
-    zi.external_fa = 0;
-    
-    ziperr_ = zipOpenNewFileInZip(zipFile0_, (outputFilePath_ + eoss.str()).c_str(), &zi,
-                                  0, 0, 0, 0, 0, // other stuff
-                                  Z_DEFLATED, // method
-                                  9);
-    assert(ziperr_ == ZIP_OK);
-
-    if ( outputMaxEvents_ != -1 )       
-      eventCounter_++;
-      
-    std::stringstream doss;
-    doss << *storages_[0];
-    write(doss, zipFile0_);
-    
-    ziperr_ = zipCloseFileInZip(zipFile0_);
-    assert(ziperr_ == ZIP_OK);
+    if ( topEvents_ )
+    {
+      // Don't bother serializing an event that cannot make it
+      std::lock_guard<std::mutex> lock(topEventsMutex_);
+      keep = kept_.size() < topEvents_ || ss.score > kept_.front().score;
+    }
 
-    // If we are at the maximum number of events
-    // for each ig file then we must close the current 
-    // zip file and open another one 
-    if ( eventCounter_ == outputMaxEvents_ )
+    if ( keep )
     {
-      close(zipFile0_);
-      fileCounter_ += 1;
-      eventCounter_ = 0;
+      std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+      std::string data;
+      {
+        ISpyTracer::Scope trace(tracer_.get(), traceSerialize_, sc.streamID().value());
+
+        std::stringstream doss;
+        doss << *ss.storages[0];
+        data = doss.str();
+      }
+
+      std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+      if ( topEvents_ )
+      {
+        ISpyTracer::Scope trace(tracer_.get(), traceDeflate_, sc.streamID().value());
+        keepEvent(ss.score, eoss.str(), data);
+      }
+      else
+      {
+        ISpyTracer::Scope trace(tracer_.get(), traceZipWrite_, sc.streamID().value());
+        writeEvent(eoss.str(), data);
+      }
+
+      if ( timing_ )
+      {
+        ss.events++;
+        ss.rawBytes += data.size();
+        ss.serializeTime += std::chrono::duration<double>(t1 - t0).count();
+        ss.writeTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+      }
     }
   }
 
-  delete storages_[0];    
-  storages_[0] = 0;
+  delete ss.storages[0];    
+  ss.storages[0] = 0;
 
-  if ( ! storages_[1]->empty() )
+  if ( ! ss.storages[1]->empty() )
   {
     std::stringstream goss;
-    goss << "Geometry/Run_"<< currentRun_ <<"/Event_"<< currentEvent_;
+    goss << "Geometry/Run_"<< ss.run <<"/Event_"<< ss.event;
 
-    zip_fileinfo zi;
+    std::string data;
+    {
+      ISpyTracer::Scope trace(tracer_.get(), traceSerialize_, sc.streamID().value());
 
-    time_t now = time(0);
-    boost::posix_time::ptime bt = boost::posix_time::from_time_t(now);
-    tm tt = boost::posix_time::to_tm(bt);
-                                                                                                         
-    zi.tmz_date.tm_sec  = tt.tm_sec;
-    zi.tmz_date.tm_min  = tt.tm_min;
-    zi.tmz_date.tm_hour = tt.tm_hour;
-    zi.tmz_date.tm_mday = tt.tm_mday;
-    zi.tmz_date.tm_mon  = tt.tm_mon;
-    zi.tmz_date.tm_year = tt.tm_year;   
-    zi.dosDate = 0;
-    zi.internal_fa = 0;
-    zi.external_fa = 0;
-    
-    ziperr_ = zipOpenNewFileInZip(zipFile1_, (outputFilePath_ + goss.str()).c_str(), &zi,
-                                  0, 0, 0, 0, 0,      
-                                  Z_DEFLATED, 9);
-    assert(ziperr_ == ZIP_OK);
+      std::stringstream doss;
+      doss << *ss.storages[1];
+      data = doss.str();
+    }
 
-    std::stringstream doss;
-    doss << *storages_[1];
-    write(doss, zipFile1_);
+    ISpyTracer::Scope trace(tracer_.get(), traceZipWrite_, sc.streamID().value());
 
-    ziperr_ = zipCloseFileInZip(zipFile1_);
-    assert(ziperr_ == ZIP_OK);
+    std::lock_guard<std::mutex> lock(mutex_);
+    writeEntry(outputFilePath_ + goss.str(), data, zipFile1_);
   }
   
-  delete storages_[1];
-  storages_[1] = 0;
+  delete ss.storages[1];
+  ss.storages[1] = 0;
+}
+
+void
+ISpyService::writeEvent(const std::string& name, const std::string& data)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if ( ! zipFile0_ )
+    nextFile();
+
+  writeEntry(outputFilePath_ + name, data, zipFile0_);
+
+  if ( outputMaxEvents_ != -1 )       
+    eventCounter_++;
+
+  // If we are at the maximum number of events
+  // for each ig file then we must close the current 
+  // zip file; the next one is opened with the next event
+  if ( eventCounter_ == outputMaxEvents_ )
+  {
+    // Not tied to a stream: it may also happen at the end of the job
+    ISpyTracer::Scope trace(tracer_.get(), traceRollover_, -1);
+
+    writeStrings(zipFile0_);
+    writeErrors(zipFile0_);
+    close(zipFile0_);
+    zipFile0_ = 0;
+    fileCounter_ += 1;
+    eventCounter_ = 0;
+  }
+}
+
+void
+ISpyService::keepEvent(double score, const std::string& name, const std::string& data)
+{
+  TopEvent te;
+  te.score = score;
+  te.name = name;
+  te.offset = -1;
+  te.rawSize = data.size();
+
+  uLongf size = compressBound(data.size());
+  te.data.resize(size);
+  int zerr = compress2(reinterpret_cast<Bytef*>(&te.data[0]), &size,
+                       reinterpret_cast<const Bytef*>(data.data()), data.size(), Z_BEST_SPEED);
+  assert(zerr == Z_OK);
+  te.data.resize(size);
+  te.size = size;
+
+  std::lock_guard<std::mutex> lock(topEventsMutex_);
+
+  if ( kept_.size() == topEvents_ )
+  {
+    if ( score <= kept_.front().score )
+      return;
+
+    std::pop_heap(kept_.begin(), kept_.end(), TopEventOrder());
+
+    if ( kept_.back().offset < 0 )
+      topEventsBytes_ -= kept_.back().size;
+
+    kept_.pop_back();
+  }
+
+  // Over the memory cap the data go to the spill file; dropped
+  // spilled events just leave a hole there.
+  if ( topEventsBytes_ + te.size > topEventsMaxBytes_ )
+  {
+    if ( ! spillFile_ )
+      spillFile_ = std::tmpfile();
+    assert(spillFile_);
+
+    std::fseek(spillFile_, 0, SEEK_END);
+    te.offset = std::ftell(spillFile_);
+    std::fwrite(te.data.data(), 1, te.size, spillFile_);
+    std::string().swap(te.data);
+  }
+  else
+    topEventsBytes_ += te.size;
+
+  kept_.push_back(te);
+  std::push_heap(kept_.begin(), kept_.end(), TopEventOrder());
+}
+
+void
+ISpyService::writeTopEvents(void)
+{
+  // Best first
+  std::sort_heap(kept_.begin(), kept_.end(), TopEventOrder());
+
+  for ( std::vector<TopEvent>::iterator te = kept_.begin(), teEnd = kept_.end(); 
+        te != teEnd; ++te )
+  {
+    if ( te->offset >= 0 )
+    {
+      te->data.resize(te->size);
+      std::fseek(spillFile_, te->offset, SEEK_SET);
+      size_t nread = std::fread(&te->data[0], 1, te->size, spillFile_);
+      assert(nread == te->size);
+    }
+
+    std::string data(te->rawSize, '\0');
+    uLongf size = te->rawSize;
+    int zerr = uncompress(reinterpret_cast<Bytef*>(&data[0]), &size,
+                          reinterpret_cast<const Bytef*>(te->data.data()), te->size);
+    assert(zerr == Z_OK && size == te->rawSize);
+
+    writeEvent(te->name, data);
+    std::string().swap(te->data);
+  }
+
+  kept_.clear();
+  topEventsBytes_ = 0;
+
+  if ( spillFile_ )
+  {
+    std::fclose(spillFile_);
+    spillFile_ = 0;
+  }
+}
+
+void
+ISpyService::writeEntry(const std::string& name, const std::string& data, zipFile& zfile)
+{
+  zip_fileinfo zi;
+
+  time_t now = time(0);
+  boost::posix_time::ptime bt = boost::posix_time::from_time_t(now);
+  tm tt = boost::posix_time::to_tm(bt);
+                                                                                                         
+  zi.tmz_date.tm_sec  = tt.tm_sec;
+  zi.tmz_date.tm_min  = tt.tm_min;
+  zi.tmz_date.tm_hour = tt.tm_hour;
+  zi.tmz_date.tm_mday = tt.tm_mday;
+  zi.tmz_date.tm_mon  = tt.tm_mon;
+  zi.tmz_date.tm_year = tt.tm_year;
+  zi.dosDate = 0;
+  zi.internal_fa = 0;
+  zi.external_fa = 0;
+    
+  ziperr_ = zipOpenNewFileInZip(zfile, name.c_str(), &zi,
+                                0, 0, 0, 0, 0, // other stuff
+                                Z_DEFLATED, // method
+                                compressionLevel_);
+  assert(ziperr_ == ZIP_OK);
+
+  write(data, zfile);
+
+  ziperr_ = zipCloseFileInZip(zfile);
+  assert(ziperr_ == ZIP_OK);
 }
 	
 void 
-ISpyService::write(std::stringstream& soss, zipFile& zfile)
+ISpyService::write(const std::string& data, zipFile& zfile)
 {
-  long int size_buf = soss.str().length();
-  void* buf = (void*) malloc(size_buf);
-  memcpy((void*) buf, soss.str().c_str(), size_buf);
+  ziperr_ = zipWriteInFileInZip(zfile, const_cast<char*>(data.data()), data.length());
+}
 
-  ziperr_ = zipWriteInFileInZip(zfile, buf, size_buf);
-  
-  free(buf);
+ISpyESContext&
+ISpyService::esContext(edm::StreamID sid, const edm::EventSetup& eventSetup)
+{
+  StreamStorage& ss = streams_[sid.value()];
+  ISpyESContext& context = *esContexts_[sid.value()];
+
+  if ( ! ss.esBound )
+  {
+    context.reset(&eventSetup);
+    ss.esBound = true;
+  }
+
+  return context;
+}
+
+void
+ISpyService::beginRegionOfInterest(edm::StreamID sid)
+{
+  StreamStorage& ss = streams_[sid.value()];
+
+  ss.roiActive = true;
+  ss.rois.clear();
+}
+
+void
+ISpyService::addRegionOfInterest(edm::StreamID sid, double eta, double phi, double deltaR)
+{
+  StreamStorage& ss = streams_[sid.value()];
+
+  Cone cone;
+  cone.eta = eta;
+  cone.phi = phi;
+  cone.deltaR = deltaR;
+  cone.deltaR2 = deltaR*deltaR;
+
+  ss.roiActive = true;
+  ss.rois.push_back(cone);
+}
+
+bool
+ISpyService::inRegionOfInterest(edm::StreamID sid, double eta, double phi) const
+{
+  const StreamStorage& ss = streams_[sid.value()];
+
+  if ( ! ss.roiActive )
+    return true;
+
+  for ( std::vector<Cone>::const_iterator ci = ss.rois.begin(), ciEnd = ss.rois.end();
+        ci != ciEnd; ++ci )
+  {
+    // Most hits are far away in eta, so reject on that first
+    double deta = eta - ci->eta;
+
+    if ( deta > ci->deltaR || deta < -ci->deltaR )
+      continue;
+
+    double dphi = reco::deltaPhi(phi, ci->phi);
+
+    if ( deta*deta + dphi*dphi <= ci->deltaR2 )
+      return true;
+  }
+
+  return false;
+}
+
+int
+ISpyService::intern(const std::string& value)
+{
+  std::lock_guard<std::mutex> lock(stringsMutex_);
+
+  std::unordered_map<std::string, int>::const_iterator it = stringIds_.find(value);
+
+  if ( it != stringIds_.end() )
+    return it->second;
+
+  int id = strings_.size();
+  strings_.push_back(value);
+  stringIds_.insert(std::make_pair(value, id));
+
+  return id;
 }
 
 void
-ISpyService::error(const std::string & what)
+ISpyService::product(edm::StreamID sid, const std::string& product)
 {
-  assert (storages_[0]);
-  IgCollection& collection = storages_[0]->getCollection("Errors_V1");
-  IgProperty ERROR_MSG = collection.addProperty("Error", std::string());
+  IgDataStorage *storage = streams_[sid.value()].storages[0];
+  assert (storage);
+
+  if ( stringTable_ )
+  {
+    IgCollection& products = storage->getCollection("Products_V2");
+    IgProperty PROD = products.addProperty("Product", int(0));
+    IgCollectionItem item = products.create();
+    item[PROD] = intern(product);
+  }
+  else
+  {
+    IgCollection& products = storage->getCollection("Products_V1");
+    IgProperty PROD = products.addProperty("Product", std::string ());
+    IgCollectionItem item = products.create();
+    item[PROD] = product;
+  }
+}
+
+void
+ISpyService::writeStrings(zipFile& zfile)
+{
+  IgDataStorage storage;
+
+  {
+    std::lock_guard<std::mutex> lock(stringsMutex_);
+
+    if ( strings_.empty() )
+      return;
+
+    IgCollection& collection = storage.getCollection("Strings_V1");
+    IgProperty ID = collection.addProperty("id", int(0));
+    IgProperty VALUE = collection.addProperty("value", std::string());
+
+    for ( size_t i = 0, n = strings_.size(); i < n; ++i )
+    {
+      IgCollectionItem item = collection.create();
+      item[ID] = static_cast<int>(i);
+      item[VALUE] = strings_[i];
+    }
+  }
+
+  std::stringstream soss;
+  soss << storage;
+
+  writeEntry(outputFilePath_ + "Strings", soss.str(), zfile);
+}
+
+void
+ISpyService::writeErrors(zipFile& zfile)
+{
+  IgDataStorage storage;
+
+  {
+    std::lock_guard<std::mutex> lock(errorsMutex_);
+
+    if ( errors_.empty() )
+      return;
+
+    IgCollection& collection = storage.getCollection("ErrorTable_V1");
+    IgProperty ID = collection.addProperty("id", int(0));
+    IgProperty MESSAGE = collection.addProperty("message", std::string());
+    IgProperty RUN = collection.addProperty("firstRun", int(0));
+    IgProperty EVENT = collection.addProperty("firstEvent", static_cast<long long>(0));
+    IgProperty COUNT = collection.addProperty("count", int(0));
+
+    for ( size_t i = 0, n = errors_.size(); i < n; ++i )
+    {
+      IgCollectionItem item = collection.create();
+      item[ID] = static_cast<int>(i);
+      item[MESSAGE] = errors_[i].message;
+      item[RUN] = errors_[i].run;
+      item[EVENT] = errors_[i].event;
+      item[COUNT] = static_cast<int>(errors_[i].count);
+    }
+  }
+
+  std::stringstream eoss;
+  eoss << storage;
+
+  writeEntry(outputFilePath_ + "Errors", eoss.str(), zfile);
+}
+
+bool
+ISpyService::knownError(edm::StreamID sid, const void* key)
+{
+  int id;
+  {
+    std::lock_guard<std::mutex> lock(errorsMutex_);
+
+    std::unordered_map<const void*, int>::const_iterator it = errorKeys_.find(key);
+
+    if ( it == errorKeys_.end() )
+      return false;
+
+    id = it->second;
+    errors_[id].count++;
+  }
+
+  referenceError(sid, id);
+  return true;
+}
+
+void
+ISpyService::recordError(edm::StreamID sid, const void* key, const std::string& message)
+{
+  const StreamStorage& ss = streams_[sid.value()];
+
+  int id;
+  bool first = false;
+  {
+    std::lock_guard<std::mutex> lock(errorsMutex_);
+
+    std::unordered_map<std::string, int>::const_iterator it = errorIds_.find(message);
+
+    if ( it != errorIds_.end() )
+    {
+      id = it->second;
+      errors_[id].count++;
+    }
+    else
+    {
+      ErrorEntry entry;
+      entry.message = message;
+      entry.run = ss.run;
+      entry.event = ss.event;
+      entry.count = 1;
+
+      id = errors_.size();
+      errors_.push_back(entry);
+      errorIds_.insert(std::make_pair(message, id));
+      first = true;
+    }
+
+    if ( key )
+      errorKeys_.insert(std::make_pair(key, id));
+  }
+
+  if ( first )
+  {
+    IgDataStorage *storage = ss.storages[0];
+    assert (storage);
+    IgCollection& collection = storage->getCollection("Errors_V1");
+    IgProperty ERROR_MSG = collection.addProperty("Error", std::string());
+    IgCollectionItem item = collection.create();
+    item[ERROR_MSG] = message;
+  }
+
+  referenceError(sid, id);
+}
+
+void
+ISpyService::referenceError(edm::StreamID sid, int id)
+{
+  StreamStorage& ss = streams_[sid.value()];
+
+  // Once per event
+  if ( std::find(ss.errorIds.begin(), ss.errorIds.end(), id) != ss.errorIds.end() )
+    return;
+
+  ss.errorIds.push_back(id);
+
+  IgDataStorage *storage = ss.storages[0];
+  assert (storage);
+  IgCollection& collection = storage->getCollection("ErrorIds_V1");
+  IgProperty ID = collection.addProperty("id", int(0));
   IgCollectionItem item = collection.create();
-  item[ERROR_MSG] = what;
+  item[ID] = id;
+}
+
+void
+ISpyService::error(edm::StreamID sid, const std::string & what)
+{
+  recordError(sid, 0, what);
 }
 
 DEFINE_FWK_SERVICE(ISpyService);
@@ -26,7 +26,7 @@ ISpySiPixelCluster::ISpySiPixelCluster (const edm::ParameterSet& iConfig)
 }
 
 void 
-ISpySiPixelCluster::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpySiPixelCluster::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -39,7 +39,10 @@ ISpySiPixelCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::ESHandle<TrackerGeometry> geom;
   eventSetup.get<TrackerDigiGeometryRecord> ().get (geom);
@@ -48,7 +51,7 @@ ISpySiPixelCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
   {
     std::string error = 
       "### Error: ISpySiPixelCluster::analyze: Invalid TrackerDigiGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
     
@@ -63,10 +66,7 @@ ISpySiPixelCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 	
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &clusters = storage->getCollection ("SiPixelClusters_V1");
     IgProperty DET_ID   = clusters.addProperty ("detid", int (0)); 
@@ -93,6 +93,10 @@ ISpySiPixelCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
 	int column = (*icluster).minPixelCol ();
 
 	GlobalPoint pos = (geom->idToDet (detid))->surface().toGlobal (theTopol->localPosition (MeasurementPoint (row, column)));		
+
+	if ( ! config->inRegionOfInterest(sid, pos.eta(), pos.phi()) )
+	  continue;
+
 	IgCollectionItem item = clusters.create ();
 	item[DET_ID] = static_cast<int> (detID);
 	item[POS] = IgV3d(static_cast<double>(pos.x()/100.0), static_cast<double>(pos.y()/100.0), static_cast<double>(pos.z()/100.0));
@@ -101,12 +105,13 @@ ISpySiPixelCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
   }
   else 
   {
-    std::string error = "### Error: SiPixelClusters "
-			+ edm::TypeID (typeid (edm::DetSetVector<SiPixelCluster>)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: SiPixelClusters "
+             + edm::TypeID (typeid (edm::DetSetVector<SiPixelCluster>)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
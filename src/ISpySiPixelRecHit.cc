@@ -22,10 +22,12 @@ using namespace edm::service;
 
 ISpySiPixelRecHit::ISpySiPixelRecHit (const edm::ParameterSet& iConfig)
   : inputTag_ (iConfig.getParameter<edm::InputTag>("iSpySiPixelRecHitTag"))
-{}
+{
+  rechitToken_ = consumes<SiPixelRecHitCollection>(inputTag_);
+}
 
 void 
-ISpySiPixelRecHit::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpySiPixelRecHit::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -38,7 +40,10 @@ ISpySiPixelRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::ESHandle<TrackerGeometry> geom;
   eventSetup.get<TrackerDigiGeometryRecord> ().get (geom);
@@ -47,12 +52,12 @@ ISpySiPixelRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
   {
     std::string error = 
       "### Error: ISpySiPixelRecHit::analyze: Invalid TrackerDigiGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
     
   edm::Handle<SiPixelRecHitCollection> collection;
-  event.getByLabel (inputTag_, collection);
+  event.getByToken (rechitToken_, collection);
 
   if (collection.isValid ())
   {	    
@@ -62,10 +67,7 @@ ISpySiPixelRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process()	;
 		
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &rechits = storage->getCollection ("SiPixelRecHits_V1");
     IgProperty DET_ID   = rechits.addProperty ("detid", int (0)); 
@@ -98,6 +100,7 @@ ISpySiPixelRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
     }
 	
 #else
+
     for (SiPixelRecHitCollection::DataContainer::const_iterator ipixel = collection->data ().begin (), ipixelEnd = collection->data ().end ();
 	 ipixel != ipixelEnd; ++ipixel)
     {
@@ -122,12 +125,13 @@ ISpySiPixelRecHit::analyze (const edm::Event& event, const edm::EventSetup& even
   }
   else 
   {
-    std::string error = "### Error: SiPixelRecHits "
-			+ edm::TypeID (typeid (SiPixelRecHitCollection)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: SiPixelRecHits "
+             + edm::TypeID (typeid (SiPixelRecHitCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
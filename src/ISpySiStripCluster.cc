@@ -28,7 +28,7 @@ ISpySiStripCluster::ISpySiStripCluster (const edm::ParameterSet& iConfig)
 }
 
 void 
-ISpySiStripCluster::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpySiStripCluster::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -41,7 +41,10 @@ ISpySiStripCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::ESHandle<TrackerGeometry> geom;
   eventSetup.get<TrackerDigiGeometryRecord> ().get (geom);
@@ -50,7 +53,7 @@ ISpySiStripCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
   {
     std::string error = 
       "### Error: ISpySiStripCluster::analyze: Invalid TrackerDigiGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -65,10 +68,7 @@ ISpySiStripCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &clusters = storage->getCollection ("SiStripClusters_V1");
     IgProperty DET_ID   = clusters.addProperty ("detid", int (0)); 
@@ -93,6 +93,10 @@ ISpySiStripCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
       { 
 	short firststrip = (*icluster).firstStrip ();
 	GlobalPoint pos =  (geom->idToDet (detid))->surface().toGlobal (theTopol->localPosition (firststrip));
+
+	if ( ! config->inRegionOfInterest(sid, pos.eta(), pos.phi()) )
+	  continue;
+
 	IgCollectionItem item = clusters.create ();
 	item[DET_ID] = static_cast<int> (detID);
 	item[POS] = IgV3d(static_cast<double>(pos.x()/100.0), static_cast<double>(pos.y()/100.0), static_cast<double>(pos.z()/100.0));
@@ -101,12 +105,13 @@ ISpySiStripCluster::analyze (const edm::Event& event, const edm::EventSetup& eve
   }
   else 
   {
-    std::string error = "### Error: SiStripClusters "
-			+ edm::TypeID (typeid (edm::DetSetVector<SiStripCluster>)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: SiStripClusters "
+             + edm::TypeID (typeid (edm::DetSetVector<SiStripCluster>)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -13,19 +13,36 @@
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/Exception.h"
 
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+#include "DataFormats/GeometryVector/interface/LocalPoint.h"
+
 #include "Geometry/CommonTopologies/interface/StripTopology.h"
 #include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
 #include "Geometry/TrackerGeometryBuilder/interface/StripGeomDetUnit.h"
 #include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
 
+#include <string>
+#include <vector>
+
 using namespace edm::service;
 
 ISpySiStripDigi::ISpySiStripDigi (const edm::ParameterSet& iConfig)
-  : inputTag_ (iConfig.getParameter<edm::InputTag>("iSpySiStripDigiTag"))
-{}
+  : inputTag_ (iConfig.getParameter<edm::InputTag>("iSpySiStripDigiTag")),
+    occupancy_ (iConfig.getUntrackedParameter<bool>("occupancy", false)),
+    packed_ (iConfig.getUntrackedParameter<bool>("packed", false))
+{
+  if ( occupancy_ && packed_ )
+  {
+    throw cms::Exception ("Configuration")
+      << "ISpySiStripDigi: occupancy and packed are two different outputs,\n"
+      "set at most one of them";
+  }
+
+  digiToken_ = consumes<edm::DetSetVector<SiStripDigi> >(inputTag_);
+}
 
 void 
-ISpySiStripDigi::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpySiStripDigi::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -38,7 +55,10 @@ ISpySiStripDigi::analyze( const edm::Event& event, const edm::EventSetup& eventS
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
     
   edm::ESHandle<TrackerGeometry> geom;
   eventSetup.get<TrackerDigiGeometryRecord> ().get (geom);
@@ -47,12 +67,12 @@ ISpySiStripDigi::analyze( const edm::Event& event, const edm::EventSetup& eventS
   {
     std::string error = 
       "### Error: ISpySiStripDigi::analyze: Invalid TrackerDigiGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
   edm::Handle<edm::DetSetVector<SiStripDigi> > collection;
-  event.getByLabel (inputTag_, collection);
+  event.getByToken (digiToken_, collection);
 
   if (collection.isValid ())                
   {	    
@@ -62,10 +82,88 @@ ISpySiStripDigi::analyze( const edm::Event& event, const edm::EventSetup& eventS
 			  + inputTag_.instance() + ":" 
 			  + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
+
+    edm::DetSetVector<SiStripDigi>::const_iterator it = collection->begin ();
+    edm::DetSetVector<SiStripDigi>::const_iterator end = collection->end ();
+
+    if ( occupancy_ )
+    {
+      IgCollection &modules = storage->getCollection ("SiStripOccupancy_V1");
+      IgProperty M_DET_ID = modules.addProperty ("detid", int (0));
+      IgProperty M_POS    = modules.addProperty ("pos", IgV3d());
+      IgProperty M_DIGIS  = modules.addProperty ("digis", int (0));
+      IgProperty M_ADC    = modules.addProperty ("adc", int (0));
+
+      for (; it != end; ++it)
+      {
+	const edm::DetSet<SiStripDigi>& ds = *it;
+
+	if ( ds.data.empty() )
+	  continue;
+
+	int adc = 0;
+
+	for ( edm::DetSet<SiStripDigi>::const_iterator idigi = ds.data.begin(), idigiEnd = ds.data.end();
+	      idigi != idigiEnd; ++idigi )
+	  adc += (*idigi).adc();
+
+	GlobalPoint pos = geom->idToDet (DetId (ds.id))->surface ().position ();
+
+	IgCollectionItem module = modules.create ();
+	module[M_DET_ID] = static_cast<int> (ds.id);
+	module[M_POS] = IgV3d(static_cast<double>(pos.x()/100.0),
+			      static_cast<double>(pos.y()/100.0),
+			      static_cast<double>(pos.z()/100.0));
+	module[M_DIGIS] = static_cast<int> (ds.data.size());
+	module[M_ADC] = adc;
+      }
+
+      return;
+    }
+
+    if ( packed_ )
+    {
+      // One row per run of adjacent strips: the first strip and the
+      // comma separated adc values. The positions are left to the
+      // viewer, from the geometry file.
+      IgCollection &runs = storage->getCollection ("SiStripDigis_V2");
+      IgProperty R_DET_ID = runs.addProperty ("detid", int (0));
+      IgProperty R_STRIP  = runs.addProperty ("strip", int (0));
+      IgProperty R_ADC    = runs.addProperty ("adc", std::string ());
+
+      std::string adcs;
+
+      for (; it != end; ++it)
+      {
+	const edm::DetSet<SiStripDigi>& ds = *it;
+
+	edm::DetSet<SiStripDigi>::const_iterator idigi = ds.data.begin ();
+	edm::DetSet<SiStripDigi>::const_iterator idigiEnd = ds.data.end ();
+
+	while ( idigi != idigiEnd )
+	{
+	  int first = (*idigi).strip();
+	  int next = first;
+
+	  adcs.clear();
+
+	  for (; idigi != idigiEnd && (*idigi).strip() == next; ++idigi, ++next )
+	  {
+	    if ( next != first )
+	      adcs += ',';
+	    adcs += std::to_string((*idigi).adc());
+	  }
+
+	  IgCollectionItem run = runs.create ();
+	  run[R_DET_ID] = static_cast<int> (ds.id);
+	  run[R_STRIP] = first;
+	  run[R_ADC] = adcs;
+	}
+      }
+
+      return;
+    }
 
     IgCollection &digis = storage->getCollection ("SiStripDigis_V1");
 	
@@ -73,29 +171,36 @@ ISpySiStripDigi::analyze( const edm::Event& event, const edm::EventSetup& eventS
     IgProperty POS 	    = digis.addProperty ("pos", IgV3d());
     IgProperty STRIP    = digis.addProperty("strip", int(0));
     IgProperty ADC      = digis.addProperty("adc", int(0));
-	
-    edm::DetSetVector<SiStripDigi>::const_iterator it = collection->begin ();
-    edm::DetSetVector<SiStripDigi>::const_iterator end = collection->end ();
+
+    std::vector<LocalPoint> local;
 
     for (; it != end; ++it)
     {
-      edm::DetSet<SiStripDigi> ds = *it;
+      const edm::DetSet<SiStripDigi>& ds = *it;
 
       if (ds.data.size ())
       {
 	const uint32_t& detID = ds.id;
-	DetId detid (detID);
-	edm::DetSet<SiStripDigi>::const_iterator idigi = ds.data.begin ();
-	edm::DetSet<SiStripDigi>::const_iterator idigiEnd = ds.data.end ();
-	for(; idigi != idigiEnd; ++idigi)
-	{ 
-	  const StripGeomDetUnit* stripDet = 
-	    dynamic_cast<const StripGeomDetUnit *>(geom->idToDet (detid));
-	  const StripTopology* stripTopol = 
-	    dynamic_cast<const StripTopology *>( &(stripDet->specificTopology ()));
 
-	  GlobalPoint pos = 
-	    (geom->idToDet (detid))->surface().toGlobal(stripTopol->localPosition((*idigi).strip()));
+	// The det, its topology and surface are the same for all the digis
+	const StripGeomDetUnit* stripDet = 
+	  dynamic_cast<const StripGeomDetUnit *>(geom->idToDet (DetId (detID)));
+	if ( ! stripDet )
+	  continue;
+
+	const StripTopology& stripTopol = stripDet->specificTopology ();
+	const Surface& surface = stripDet->surface ();
+
+	local.clear();
+	local.reserve(ds.data.size());
+
+	for ( edm::DetSet<SiStripDigi>::const_iterator idigi = ds.data.begin (), idigiEnd = ds.data.end ();
+	      idigi != idigiEnd; ++idigi )
+	  local.push_back(stripTopol.localPosition((*idigi).strip()));
+
+	for ( size_t i = 0, n = ds.data.size(); i != n; ++i )
+	{ 
+	  GlobalPoint pos = surface.toGlobal(local[i]);
 		  
 	  IgCollectionItem item = digis.create ();
 		    
@@ -104,20 +209,21 @@ ISpySiStripDigi::analyze( const edm::Event& event, const edm::EventSetup& eventS
 			    static_cast<double>(pos.y()/100.0), 
 			    static_cast<double>(pos.z()/100.0));
 
-	  item[STRIP] = static_cast<int>((*idigi).strip());
-	  item[ADC] = static_cast<int>((*idigi).adc());
+	  item[STRIP] = static_cast<int>(ds.data[i].strip());
+	  item[ADC] = static_cast<int>(ds.data[i].adc());
 	}
       }
     }
   }
   else 
   {
-    std::string error = "### Error: SiStripDigis "
-			+ edm::TypeID (typeid (edm::DetSetVector<SiStripDigi>)).friendlyClassName () + ":" 
-			+ inputTag_.label() + ":"
-			+ inputTag_.instance() + ":" 
-			+ inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: SiStripDigis "
+             + edm::TypeID (typeid (edm::DetSetVector<SiStripDigi>)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -40,9 +40,18 @@ ISpySimTrack::ISpySimTrack(const edm::ParameterSet& iConfig)
   : trackTags_(iConfig.getParameter<VInputTag>("iSpySimTrackTags")),
     vertexTags_(iConfig.getParameter<VInputTag>("iSpySimVertexTags")),
     hitTags_(iConfig.getParameter<VInputTag>("iSpySimHitTags"))
-{}
+{
+  for ( VInputTag::const_iterator i = trackTags_.begin(); i != trackTags_.end(); ++i )
+    trackTokens_.push_back(consumes<SimTrackContainer>(*i));
+
+  for ( VInputTag::const_iterator i = vertexTags_.begin(); i != vertexTags_.end(); ++i )
+    vertexTokens_.push_back(consumes<SimVertexContainer>(*i));
 
-void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& eventSetup)
+  for ( VInputTag::const_iterator i = hitTags_.begin(); i != hitTags_.end(); ++i )
+    hitTokens_.push_back(consumes<PSimHitContainer>(*i));
+}
+
+void ISpySimTrack::analyze (edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
    
@@ -55,16 +64,18 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
       "or remove the module that requires it";
   }
 
-  edm::ESHandle<GlobalTrackingGeometry> geometry;
-  eventSetup.get<GlobalTrackingGeometryRecord>().get(geometry);
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  const GlobalTrackingGeometry* geometry = config->esContext(sid, eventSetup).globalTrackingGeometry();
 
-  IgDataStorage *storage = config->storage();
+  IgDataStorage *storage = config->storage(sid);
 
   for ( VInputTag::const_iterator i = vertexTags_.begin();
 	i != vertexTags_.end(); ++i )
   {
     edm::Handle<SimVertexContainer> collection;
-    event.getByLabel(*i, collection);
+    event.getByToken(vertexTokens_[i - vertexTags_.begin()], collection);
 	
     if ( collection.isValid() )
     {  
@@ -74,10 +85,7 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
 			    + (*i).instance() + ":" 
 			    + (*i).process();
 
-      IgCollection& products = storage->getCollection("Products_V1");
-      IgProperty PROD = products.addProperty("Product", std::string ());
-      IgCollectionItem item = products.create();
-      item[PROD] = product;
+      config->product(sid, product);
 
       IgCollection& vertices = storage->getCollection("SimVertices_V1");
       IgProperty VPOS = vertices.addProperty("position", IgV3d());
@@ -100,22 +108,24 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
 	
     else 
     {
-      std::string error = "### Error: SimVertices "
-			  + edm::TypeID (typeid (SimVertexContainer)).friendlyClassName () + ":" 
-			  + (*i).label() + ":"
-			  + (*i).instance() + ":" 
-			  + (*i).process() + " are not found.";
-      config->error (error);
+      config->error (sid, &(*i), [&] {
+        return "### Error: SimVertices "
+               + edm::TypeID (typeid (SimVertexContainer)).friendlyClassName () + ":"
+               + (*i).label() + ":"
+               + (*i).instance() + ":"
+               + (*i).process() + " are not found.";
+      });
     }
   }
 
-  simHits_.clear();
+  // first: track ID, second: PSimHit
+  SimHits simHits;
     
   for ( VInputTag::const_iterator i = hitTags_.begin();
 	i != hitTags_.end(); ++i )
   {
     edm::Handle<PSimHitContainer> collection;
-    event.getByLabel(*i, collection);
+    event.getByToken(hitTokens_[i - hitTags_.begin()], collection);
 
     if ( collection.isValid() )
     {  
@@ -125,10 +135,7 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
 			    + (*i).instance() + ":" 
 			    + (*i).process();
 	    
-      IgCollection& products = storage->getCollection("Products_V1");
-      IgProperty PROD = products.addProperty("Product", std::string ());
-      IgCollectionItem item = products.create();
-      item[PROD] = product;
+      config->product(sid, product);
 	
       // Sort SimHits by track ID
 	    
@@ -137,35 +144,36 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
       {
 	int tId = (*hi).trackId();
 		
-	SimHits::iterator shi = simHits_.find(tId);
+	SimHits::iterator shi = simHits.find(tId);
 		
-	if ( shi == simHits_.end() )
+	if ( shi == simHits.end() )
 	{
 	  std::vector<PSimHit> pv;
 	  pv.push_back(*hi);
-	  simHits_.insert(std::pair<int, std::vector<PSimHit> >(tId, pv));
+	  simHits.insert(std::pair<int, std::vector<PSimHit> >(tId, pv));
 	}
 		
 	else
-	  simHits_[tId].push_back(*hi);
+	  simHits[tId].push_back(*hi);
       }
     }
 	
     else 
     {
-      std::string error = "### Error: PSimHits "
-			  + edm::TypeID (typeid (PSimHitContainer)).friendlyClassName () + ":" 
-			  + (*i).label() + ":"
-			  + (*i).instance() + ":" 
-			  + (*i).process() + " are not found.";
-      config->error (error);
+      config->error (sid, &(*i), [&] {
+        return "### Error: PSimHits "
+               + edm::TypeID (typeid (PSimHitContainer)).friendlyClassName () + ":"
+               + (*i).label() + ":"
+               + (*i).instance() + ":"
+               + (*i).process() + " are not found.";
+      });
     }
   }    
 
 
   // Now go through SimHits by track ID and sort by time of flight
 
-  if ( ! simHits_.empty() && geometry.isValid() )
+  if ( ! simHits.empty() && geometry )
   {
     IgCollection& hits = storage->getCollection("SimHits_V1");
     
@@ -177,8 +185,8 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
     IgProperty PID = hits.addProperty("particleType", int(0));
     IgProperty HTID = hits.addProperty("trackId", int(0));
 
-    for ( SimHits::iterator him = simHits_.begin();
-	  him != simHits_.end(); ++him )
+    for ( SimHits::iterator him = simHits.begin();
+	  him != simHits.end(); ++him )
     {
       std::sort(him->second.begin(), him->second.end(), sortByTOF);
 	    
@@ -207,7 +215,7 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
 	if ( detId.det() > 5 )
 	  continue;
 			
-	const GeomDet* geomDet = (*geometry).idToDet(detId);
+	const GeomDet* geomDet = geometry->idToDet(detId);
 			
 	if ( geomDet == 0 )
 	  continue;
@@ -242,7 +250,7 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
 	i != trackTags_.end(); ++i )
   {
     edm::Handle<SimTrackContainer> collection;
-    event.getByLabel(*i, collection);
+    event.getByToken(trackTokens_[i - trackTags_.begin()], collection);
 		
     if ( collection.isValid() )
     {
@@ -252,10 +260,7 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
 			    + (*i).instance() + ":" 
 			    + (*i).process();
 
-      IgCollection& products = storage->getCollection("Products_V1");
-      IgProperty PROD = products.addProperty("Product", std::string ());
-      IgCollectionItem item = products.create();
-      item[PROD] = product;
+      config->product(sid, product);
 
       IgCollection& tracks = storage->getCollection("SimTracks_V1");
       IgProperty POS = tracks.addProperty("position", IgV3d());
@@ -291,12 +296,13 @@ void ISpySimTrack::analyze (const edm::Event& event, const edm::EventSetup& even
     }	
     else 
     {
-      std::string error = "### Error: SimTracks "
-			  + edm::TypeID (typeid (SimTrackContainer)).friendlyClassName () + ":" 
-			  + (*i).label() + ":"
-			  + (*i).instance() + ":" 
-			  + (*i).process() + " are not found.";
-      config->error (error);
+      config->error (sid, &(*i), [&] {
+        return "### Error: SimTracks "
+               + edm::TypeID (typeid (SimTrackContainer)).friendlyClassName () + ":"
+               + (*i).label() + ":"
+               + (*i).instance() + ":"
+               + (*i).process() + " are not found.";
+      });
     }
   }    
 }
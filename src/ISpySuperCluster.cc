@@ -1,4 +1,5 @@
 #include "ISpy/Analyzers/interface/ISpySuperCluster.h"
+#include "ISpy/Analyzers/interface/ISpyAssociations.h"
 #include "ISpy/Analyzers/interface/ISpyService.h"
 
 #include "FWCore/Framework/interface/Event.h"
@@ -26,7 +27,7 @@ ISpySuperCluster::ISpySuperCluster(const edm::ParameterSet& iConfig)
   clusterToken_ = consumes<reco::SuperClusterCollection>(inputTag_);
 }
 
-void ISpySuperCluster::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpySuperCluster::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -38,16 +39,19 @@ void ISpySuperCluster::analyze(const edm::Event& event, const edm::EventSetup& e
       "You must add the service in the configuration file\n"
       "or remove the module that requires it";
   }
-  IgDataStorage *storage = config->storage();
 
-  edm::ESHandle<CaloGeometry> geom;
-  eventSetup.get<CaloGeometryRecord>().get(geom);
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
+
+  const CaloGeometry* geom = config->esContext(sid, eventSetup).caloGeometry();
 
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpySuperCluster::analyze: Invalid CaloGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -62,18 +66,17 @@ void ISpySuperCluster::analyze(const edm::Event& event, const edm::EventSetup& e
                           + inputTag_.instance() + ":"
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
-    IgCollection& clusters = storage->getCollection("SuperClusters_V1");
+    // SuperClusters_V2 has the algorithm name as a string id
+    const bool algoIds = config->stringTable();
+    IgCollection& clusters = storage->getCollection(algoIds ? "SuperClusters_V2" : "SuperClusters_V1");
 
     IgProperty E    = clusters.addProperty("energy", 0.0);
     IgProperty POS  = clusters.addProperty("pos", IgV3d());
     IgProperty ETA  = clusters.addProperty("eta", 0.0);
     IgProperty PHI  = clusters.addProperty("phi", 0.0);
-    IgProperty ALGO = clusters.addProperty("algo", std::string());
+    IgProperty ALGO = algoIds ? clusters.addProperty("algo", int(0)) : clusters.addProperty("algo", std::string());
     IgProperty ETAW = clusters.addProperty("etaWidth", 0.0);
     IgProperty PHIW = clusters.addProperty("phiWidth", 0.0);
     IgProperty RAWE = clusters.addProperty("rawEnergy", 0.0);
@@ -92,7 +95,8 @@ void ISpySuperCluster::analyze(const edm::Event& event, const edm::EventSetup& e
     IgProperty BACK_3  = fractions.addProperty("back_3",  IgV3d());
     IgProperty BACK_4  = fractions.addProperty("back_4",  IgV3d());
 
-    IgAssociations& superClustersFracs = storage->getAssociations("SuperClusterRecHitFractions_V1");
+    ISpyAssociations superClustersFracs(storage, "SuperClusterRecHitFractions_V1", "SuperClusterRecHitFractionRanges_V1",
+                                        config->rangeAssociations());
 
     for ( reco::SuperClusterCollection::const_iterator ci = collection->begin(), cie = collection->end();
           ci != cie; ++ci )
@@ -103,14 +107,18 @@ void ISpySuperCluster::analyze(const edm::Event& event, const edm::EventSetup& e
       c[POS] = IgV3d((*ci).x()/100.0, (*ci).y()/100.0, (*ci).z()/100.0);
       c[ETA] = (*ci).eta();
       c[PHI] = (*ci).phi();
-      c[ALGO] = algoName((*ci).algo());
+      if ( algoIds )
+        c[ALGO] = config->intern(algoName((*ci).algo()));
+      else
+        c[ALGO] = algoName((*ci).algo());
       c[ETAW] = (*ci).etaWidth();
       c[PHIW] = (*ci).phiWidth();
       c[RAWE] = (*ci).rawEnergy();
       c[PREE] = (*ci).preshowerEnergy();
 
       std::vector<std::pair<DetId, float> > hitsAndFractions = (*ci).hitsAndFractions();
-      
+
+
       for ( std::vector<std::pair<DetId, float> >::iterator hi = 
               hitsAndFractions.begin(), hie = hitsAndFractions.end(); hi != hie; ++hi )
       {
@@ -118,7 +126,7 @@ void ISpySuperCluster::analyze(const edm::Event& event, const edm::EventSetup& e
         rhf[DETID] = (*hi).first;
         rhf[FRACT] = static_cast<double>((*hi).second);
 
-        auto cell = (*geom).getGeometry((*hi).first);
+        auto cell = geom->getGeometry((*hi).first);
         const CaloCellGeometry::CornersVec& corners = cell->getCorners();
         
         assert(corners.size() == 8);
@@ -139,16 +147,17 @@ void ISpySuperCluster::analyze(const edm::Event& event, const edm::EventSetup& e
   }  
   else
   {
-    std::string error = "### Error: SuperClusters "
-                        + edm::TypeID (typeid (reco::SuperClusterCollection)).friendlyClassName() + ":"
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":"
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: SuperClusters "
+             + edm::TypeID (typeid (reco::SuperClusterCollection)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
-const std::string ISpySuperCluster::algoName (reco::CaloCluster::AlgoId key)
+const std::string ISpySuperCluster::algoName (reco::CaloCluster::AlgoId key) const
 {
   if ( key == reco::CaloCluster::island )
     return "island";
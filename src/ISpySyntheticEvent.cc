@@ -0,0 +1,217 @@
+#include "ISpy/Analyzers/interface/ISpySyntheticEvent.h"
+#include "ISpy/Analyzers/interface/ISpyAssociations.h"
+#include "ISpy/Analyzers/interface/ISpyService.h"
+#include "ISpy/Services/interface/IgCollection.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+
+using namespace edm::service;
+
+// Rough per-event multiplicities: tracks above the analyzers' default
+// cuts, rechits above zero suppression.
+const ISpySyntheticEvent::Profile ISpySyntheticEvent::profiles_[] = {
+  // name           vtx   tracks hits  ecal    hcal   strip    pixel
+  { "minBias",        1,     40,  14,   1500,   800,   6000,    1200 },
+  { "ttbarPU200",   200,   6000,  14,  30000, 12000, 150000,   60000 },
+  { "PbPbCentral",    1,  15000,  14,  40000, 15000, 250000,  100000 },
+  { "splash",         0,      0,   0,  75000,  9000,  20000,    5000 },
+  { 0, 0, 0, 0, 0, 0, 0, 0 }
+};
+
+namespace
+{
+  void fillCaloHits(IgDataStorage* storage, const char* name, unsigned int n,
+                    double etaMax, double depth, std::mt19937& random)
+  {
+    IgCollection& recHits = storage->getCollection(name);
+    IgProperty E = recHits.addProperty("energy", 0.0);
+    IgProperty ETA = recHits.addProperty("eta", 0.0);
+    IgProperty PHI = recHits.addProperty("phi", 0.0);
+    IgProperty TIME = recHits.addProperty("time", 0.0);
+    IgProperty DETID = recHits.addProperty("detid", int (0));
+    IgProperty FRONT_1 = recHits.addProperty("front_1", IgV3d());
+    IgProperty FRONT_2 = recHits.addProperty("front_2", IgV3d());
+    IgProperty FRONT_3 = recHits.addProperty("front_3", IgV3d());
+    IgProperty FRONT_4 = recHits.addProperty("front_4", IgV3d());
+    IgProperty BACK_1  = recHits.addProperty("back_1",  IgV3d());
+    IgProperty BACK_2  = recHits.addProperty("back_2",  IgV3d());
+    IgProperty BACK_3  = recHits.addProperty("back_3",  IgV3d());
+    IgProperty BACK_4  = recHits.addProperty("back_4",  IgV3d());
+
+    std::uniform_real_distribution<double> eta(-etaMax, etaMax);
+    std::uniform_real_distribution<double> phi(-M_PI, M_PI);
+    std::exponential_distribution<double> energy(2.0);
+    std::normal_distribution<double> time(0.0, 2.0);
+
+    for ( unsigned int i = 0; i < n; ++i )
+    {
+      double h = eta(random);
+      double f = phi(random);
+
+      // A cell of 0.0174 x 0.0174 at radius 1.29 m and the given depth
+      double r = 1.29, d = 0.0087;
+      double z = r*std::sinh(h);
+
+      IgCollectionItem irechit = recHits.create();
+      irechit[E] = energy(random);
+      irechit[ETA] = h;
+      irechit[PHI] = f;
+      irechit[TIME] = time(random);
+      irechit[DETID] = static_cast<int>(random());
+      irechit[FRONT_1] = IgV3d(r*std::cos(f - d), r*std::sin(f - d), z - r*d);
+      irechit[FRONT_2] = IgV3d(r*std::cos(f + d), r*std::sin(f + d), z - r*d);
+      irechit[FRONT_3] = IgV3d(r*std::cos(f + d), r*std::sin(f + d), z + r*d);
+      irechit[FRONT_4] = IgV3d(r*std::cos(f - d), r*std::sin(f - d), z + r*d);
+      irechit[BACK_1] = IgV3d((r + depth)*std::cos(f - d), (r + depth)*std::sin(f - d), z - r*d);
+      irechit[BACK_2] = IgV3d((r + depth)*std::cos(f + d), (r + depth)*std::sin(f + d), z - r*d);
+      irechit[BACK_3] = IgV3d((r + depth)*std::cos(f + d), (r + depth)*std::sin(f + d), z + r*d);
+      irechit[BACK_4] = IgV3d((r + depth)*std::cos(f - d), (r + depth)*std::sin(f - d), z + r*d);
+    }
+  }
+
+  void fillClusters(IgDataStorage* storage, const char* name, unsigned int n,
+                    double rMin, double rMax, std::mt19937& random)
+  {
+    IgCollection& clusters = storage->getCollection(name);
+    IgProperty DET_ID = clusters.addProperty("detid", int (0));
+    IgProperty POS    = clusters.addProperty("pos", IgV3d());
+
+    std::uniform_real_distribution<double> radius(rMin, rMax);
+    std::uniform_real_distribution<double> phi(-M_PI, M_PI);
+    std::uniform_real_distribution<double> z(-2.8, 2.8);
+
+    for ( unsigned int i = 0; i < n; ++i )
+    {
+      double r = radius(random);
+      double f = phi(random);
+
+      IgCollectionItem item = clusters.create();
+      item[DET_ID] = static_cast<int>(random());
+      item[POS] = IgV3d(r*std::cos(f), r*std::sin(f), z(random));
+    }
+  }
+}
+
+ISpySyntheticEvent::ISpySyntheticEvent(const edm::ParameterSet& iConfig)
+  : profileName_(iConfig.getUntrackedParameter<std::string>("profile", "minBias")),
+    seed_(iConfig.getUntrackedParameter<unsigned int>("seed", 1))
+{
+  const Profile* p = profiles_;
+
+  while ( p->name && profileName_ != p->name )
+    ++p;
+
+  if ( ! p->name )
+    throw cms::Exception ("Configuration")
+      << "ISpySyntheticEvent: unknown profile \"" << profileName_ << "\",\n"
+      "use minBias, ttbarPU200, PbPbCentral or splash";
+
+  profile_ = *p;
+}
+
+void
+ISpySyntheticEvent::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup&) const
+{
+  edm::Service<ISpyService> config;
+
+  if ( ! config.isAvailable() ) 
+  {
+    throw cms::Exception ("Configuration")
+      << "ISpySyntheticEvent requires the ISpyService\n"
+      "which is not present in the configuration file.\n"
+      "You must add the service in the configuration file\n"
+      "or remove the module that requires it";
+  }
+
+  IgDataStorage *storage = config->storage(sid);
+
+  // Reproducible for a given seed whatever the number of streams
+  std::mt19937 random(seed_ ^ static_cast<unsigned int>(event.id().event()));
+
+  config->product(sid, std::string("Synthetic ") + profileName_);
+
+  std::normal_distribution<double> vz(0.0, 0.05);
+
+  IgCollection& vertices = storage->getCollection("PrimaryVertices_V1");
+  IgProperty VPOS = vertices.addProperty("pos", IgV3d());
+
+  for ( unsigned int i = 0; i < profile_.vertices; ++i )
+  {
+    IgCollectionItem v = vertices.create();
+    v[VPOS] = IgV3d(0.0, 0.0, vz(random));
+  }
+
+  IgCollection &tracks = storage->getCollection ("Tracks_V2");
+  IgProperty VTX = tracks.addProperty ("pos", IgV3d());
+  IgProperty P   = tracks.addProperty ("dir", IgV3d());
+  IgProperty PT  = tracks.addProperty ("pt", 0.0); 
+  IgProperty PHI = tracks.addProperty ("phi", 0.0);
+  IgProperty ETA = tracks.addProperty ("eta", 0.0);
+  IgProperty CHARGE = tracks.addProperty ("charge", int(0));
+  IgProperty CHI2 = tracks.addProperty ("chi2", 0.0);
+  IgProperty NDOF = tracks.addProperty ("ndof", 0.0);
+
+  IgCollection &extras = storage->getCollection ("Extras_V1");
+  IgProperty IPOS = extras.addProperty ("pos_1", IgV3d());
+  IgProperty IP   = extras.addProperty ("dir_1", IgV3d());
+  IgProperty OPOS = extras.addProperty ("pos_2", IgV3d());
+  IgProperty OP   = extras.addProperty ("dir_2", IgV3d());
+  IgAssociations &trackExtras = storage->getAssociations ("TrackExtras_V1");
+    
+  IgCollection &hits = storage->getCollection ("Hits_V1");
+  IgProperty HIT_POS = hits.addProperty ("pos", IgV3d());
+  ISpyAssociations trackHits (storage, "TrackHits_V1", "TrackHitRanges_V1", config->rangeAssociations ());
+
+  std::uniform_real_distribution<double> eta(-2.5, 2.5);
+  std::uniform_real_distribution<double> phi(-M_PI, M_PI);
+  std::exponential_distribution<double> pt(0.5);
+
+  for ( unsigned int i = 0; i < profile_.tracks; ++i )
+  {
+    double h = eta(random);
+    double f = phi(random);
+    double z0 = vz(random);
+    IgV3d dir(std::cos(f)/std::cosh(h), std::sin(f)/std::cosh(h), std::tanh(h));
+
+    IgCollectionItem track = tracks.create();
+    track[VTX] = IgV3d(0.0, 0.0, z0);
+    track[P] = dir;
+    track[PT] = 1.0 + pt(random);
+    track[PHI] = f;
+    track[ETA] = h;
+    track[CHARGE] = (random() & 1) ? 1 : -1;
+    track[CHI2] = 10.0;
+    track[NDOF] = 10.0;
+
+    IgCollectionItem eitem = extras.create();
+    eitem[IPOS] = IgV3d(0.04*dir[0], 0.04*dir[1], z0 + 0.04*dir[2]);
+    eitem[IP] = dir;
+    eitem[OPOS] = IgV3d(1.1*dir[0], 1.1*dir[1], z0 + 1.1*dir[2]);
+    eitem[OP] = dir;
+    trackExtras.associate(track, eitem);
+
+    for ( unsigned int j = 0; j < profile_.hitsPerTrack; ++j )
+    {
+      double s = 0.04 + j*(1.1 - 0.04)/profile_.hitsPerTrack;
+
+      IgCollectionItem hit = hits.create();
+      hit[HIT_POS] = IgV3d(s*dir[0], s*dir[1], z0 + s*dir[2]);
+      trackHits.associate(track, hit);
+    }
+  }
+
+  fillCaloHits(storage, "EBRecHits_V2", profile_.ecalHits, 3.0, 0.22, random);
+  fillCaloHits(storage, "HBRecHits_V2", profile_.hcalHits, 5.0, 1.0, random);
+  fillClusters(storage, "SiStripClusters_V1", profile_.stripClusters, 0.2, 1.1, random);
+  fillClusters(storage, "SiPixelClusters_V1", profile_.pixelClusters, 0.03, 0.16, random);
+}
+
+DEFINE_FWK_MODULE(ISpySyntheticEvent);
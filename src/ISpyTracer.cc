@@ -0,0 +1,116 @@
+#include "ISpy/Analyzers/interface/ISpyTracer.h"
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+  // The buffer of this thread, and the tracer it belongs to
+  thread_local const ISpyTracer *t_owner = 0;
+  thread_local void *t_buffer = 0;
+
+  void escape(std::ostream& os, const std::string& s)
+  {
+    for ( std::string::const_iterator c = s.begin(), cEnd = s.end(); c != cEnd; ++c )
+    {
+      if ( *c == '"' || *c == '\\' )
+        os << '\\';
+      os << *c;
+    }
+  }
+}
+
+ISpyTracer::ISpyTracer(const std::string& fileName, size_t capacity)
+  : fileName_(fileName),
+    capacity_(capacity ? capacity : 1),
+    start_(std::chrono::steady_clock::now())
+{}
+
+int
+ISpyTracer::name(const std::string& name, const std::string& category)
+{
+  // Called before any thread records, see ISpyService
+  for ( size_t i = 0; i < names_.size(); ++i )
+  {
+    if ( names_[i] == name && categories_[i] == category )
+      return i;
+  }
+
+  names_.push_back(name);
+  categories_.push_back(category);
+
+  return names_.size() - 1;
+}
+
+ISpyTracer::Buffer *
+ISpyTracer::buffer(void)
+{
+  if ( t_owner == this )
+    return static_cast<Buffer*>(t_buffer);
+
+  std::unique_ptr<Buffer> b(new Buffer);
+  b->records.resize(capacity_);
+  b->count = 0;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  b->thread = buffers_.size();
+  buffers_.push_back(std::move(b));
+
+  t_owner = this;
+  t_buffer = buffers_.back().get();
+
+  return buffers_.back().get();
+}
+
+void
+ISpyTracer::record(int name, char phase, int stream)
+{
+  Buffer *b = buffer();
+  Record& r = b->records[b->count % capacity_];
+
+  r.time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+  r.name = name;
+  r.stream = stream;
+  r.phase = phase;
+
+  b->count++;
+}
+
+void
+ISpyTracer::write(void) const
+{
+  std::ofstream out(fileName_.c_str());
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+  bool first = true;
+  char ts[32];
+
+  for ( std::vector<std::unique_ptr<Buffer> >::const_iterator bi = buffers_.begin(), biEnd = buffers_.end();
+        bi != biEnd; ++bi )
+  {
+    const Buffer& b = **bi;
+    size_t n = b.count < capacity_ ? b.count : capacity_;
+
+    // Oldest first
+    for ( size_t i = b.count - n; i < b.count; ++i )
+    {
+      const Record& r = b.records[i % capacity_];
+
+      std::snprintf(ts, sizeof(ts), "%.3f", r.time/1000.0);
+
+      out << (first ? "\n" : ",\n") << "{\"name\":\"";
+      escape(out, names_[r.name]);
+      out << "\",\"cat\":\"";
+      escape(out, categories_[r.name]);
+      out << "\",\"ph\":\"" << r.phase << "\",\"ts\":" << ts
+          << ",\"pid\":0,\"tid\":" << b.thread
+          << ",\"args\":{\"stream\":" << r.stream << "}}";
+
+      first = false;
+    }
+  }
+
+  out << "\n]}\n";
+}
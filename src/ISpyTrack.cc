@@ -1,7 +1,9 @@
 #include "ISpy/Analyzers/interface/ISpyTrack.h"
+#include "ISpy/Analyzers/interface/ISpyAssociations.h"
 #include "ISpy/Analyzers/interface/ISpyLocalPosition.h"
 #include "ISpy/Analyzers/interface/ISpyService.h"
 #include "ISpy/Analyzers/interface/ISpyVector.h"
+#include "ISpy/Analyzers/interface/ISpyVertexSelector.h"
 #include "ISpy/Services/interface/IgCollection.h"
 
 #include "DataFormats/TrackReco/interface/Track.h"
@@ -31,17 +33,27 @@
 #include "TrackPropagation/SteppingHelixPropagator/interface/SteppingHelixPropagator.h"
 #include "TrackingTools/TransientTrack/interface/TransientTrack.h"
 
+#include <memory>
+
 using namespace edm::service;
 
 ISpyTrack::ISpyTrack( const edm::ParameterSet& iConfig )
   : inputTag_ (iConfig.getParameter<edm::InputTag>("iSpyTrackTag")),
-    ptMin_(iConfig.getParameter<double>("ptMin"))
+    ptMin_(iConfig.getParameter<double>("ptMin")),
+    primaryVertexOnly_(iConfig.getUntrackedParameter<bool>("primaryVertexOnly", false)),
+    vertexInputTag_(iConfig.getUntrackedParameter<edm::InputTag>("iSpyPriVertexTag", edm::InputTag("offlinePrimaryVertices"))),
+    maxVertices_(iConfig.getUntrackedParameter<unsigned int>("maxVertices", 1)),
+    maxDz_(iConfig.getUntrackedParameter<double>("maxDz", 0.2)),
+    maxDxy_(iConfig.getUntrackedParameter<double>("maxDxy", 0.5))
 {
   trackToken_ = consumes<reco::TrackCollection>(inputTag_);
+
+  if ( primaryVertexOnly_ )
+    vertexToken_ = consumes<reco::VertexCollection>(vertexInputTag_);
 }
 
 void 
-ISpyTrack::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyTrack::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -54,33 +66,41 @@ ISpyTrack::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
 
-  edm::ESHandle<GlobalTrackingGeometry> geometry;
-  eventSetup.get<GlobalTrackingGeometryRecord> ().get (geometry);
+  IgDataStorage *storage = config->storage(sid);
 
-  if ( ! geometry.isValid() )
+  const GlobalTrackingGeometry* geometry = config->esContext(sid, eventSetup).globalTrackingGeometry();
+
+  if ( ! geometry )
   {
     std::string error = 
       "### Error: ISpyTrack::analyze: Invalid GlobalTrackingGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
-  edm::ESHandle<MagneticField> field;    
-  eventSetup.get<IdealMagneticFieldRecord> ().get (field);
+  const MagneticField* field = config->esContext(sid, eventSetup).magneticField();
 
-  if ( ! field.isValid() )
+  if ( ! field )
   {
     std::string error = 
       "### Error: ISpyTrack::analyze: Invalid Magnetic field ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
   
   edm::Handle<reco::TrackCollection> collection;
   event.getByToken (trackToken_, collection);
 
+  // With primaryVertexOnly only the tracks from the leading vertices are shown
+  std::unique_ptr<ISpyVertexSelector> vertices;
+
+  if ( primaryVertexOnly_ )
+    vertices = ISpyVertexSelector::fromEvent(*config, sid, event, vertexToken_, vertexInputTag_,
+                                             maxVertices_, maxDz_, maxDxy_);
+
   if (collection.isValid ())
   {	    	
     std::string product = "Tracks "
@@ -89,10 +109,7 @@ ISpyTrack::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
                           + inputTag_.instance() + ":" 
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection &tracks = storage->getCollection ("Tracks_V2");
     IgProperty VTX = tracks.addProperty ("pos", IgV3d());
@@ -113,7 +130,7 @@ ISpyTrack::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
     
     IgCollection &hits = storage->getCollection ("Hits_V1");
     IgProperty HIT_POS = hits.addProperty ("pos", IgV3d());
-    IgAssociations &trackHits = storage->getAssociations ("TrackHits_V1");
+    ISpyAssociations trackHits (storage, "TrackHits_V1", "TrackHitRanges_V1", config->rangeAssociations ());
 
     IgCollection &dets = storage->getCollection("TrackDets_V1");
     IgProperty DET_ID  = dets.addProperty("detid", int (0)); 
@@ -125,7 +142,9 @@ ISpyTrack::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
     IgProperty BACK_2  = dets.addProperty("back_2",  IgV3d());
     IgProperty BACK_4  = dets.addProperty("back_3",  IgV3d());
     IgProperty BACK_3  = dets.addProperty("back_4",  IgV3d());
-            
+
+    ISpyLocalPosition positions(geometry);
+
     for (reco::TrackCollection::const_iterator track = collection->begin (), trackEnd = collection->end ();
          track != trackEnd; ++track)
     {
@@ -134,6 +153,9 @@ ISpyTrack::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
       if ( pt < ptMin_ )
         continue;
 
+      if ( vertices && ! vertices->compatible(*track) )
+        continue;
+
       IgCollectionItem item = tracks.create ();
 
       item[VTX] = IgV3d((*track).referencePoint().x()/100.,
@@ -183,11 +205,9 @@ ISpyTrack::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
           if ((*it)->isValid () && !(*it)->geographicalId ().null ())
           {
             IgCollectionItem hit = hits.create ();
-            LocalPoint point = ISpyLocalPosition::localPosition(&(**it), geometry.product());
+            GlobalPoint point = positions.globalPosition(&(**it));
 
-            hit[HIT_POS] = IgV3d(geometry->idToDet((*it)->geographicalId())->surface().toGlobal(point).x()/100.0,
-                                 geometry->idToDet((*it)->geographicalId())->surface().toGlobal(point).y()/100.0,
-                                 geometry->idToDet((*it)->geographicalId())->surface().toGlobal(point).z()/100.0);
+            hit[HIT_POS] = IgV3d(point.x()/100.0, point.y()/100.0, point.z()/100.0);
 
             trackHits.associate (item, hit);
               
@@ -196,7 +216,7 @@ ISpyTrack::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
 
             GlobalPoint p[8];
 
-            const GeomDet* detUnit = geometry->idToDet((*it)->geographicalId());
+            const GeomDet* detUnit = positions.det((*it)->geographicalId());
             const Bounds* b = &((detUnit->surface()).bounds());
  
             if(  const TrapezoidalPlaneBounds *b2 = dynamic_cast<const TrapezoidalPlaneBounds *>(b) )
@@ -259,12 +279,13 @@ ISpyTrack::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
   
   else 
   {
-    std::string error = "### Error: Tracks "
-                        + edm::TypeID (typeid (reco::TrackCollection)).friendlyClassName () + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: Tracks "
+             + edm::TypeID (typeid (reco::TrackCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
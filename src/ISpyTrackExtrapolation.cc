@@ -1,6 +1,7 @@
 #include "ISpy/Analyzers/interface/ISpyTrackExtrapolation.h"
 #include "ISpy/Analyzers/interface/ISpyService.h"
 #include "ISpy/Analyzers/interface/ISpyVector.h"
+#include "ISpy/Analyzers/interface/ISpyVertexSelector.h"
 
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/EventSetup.h"
@@ -15,6 +16,7 @@
 #include "DataFormats/EgammaCandidates/interface/GsfElectron.h"
 #include "DataFormats/MuonReco/interface/Muon.h"
 
+#include <memory>
 #include <vector>
 
 using namespace edm::service;
@@ -76,14 +78,22 @@ ISpyTrackExtrapolation::ISpyTrackExtrapolation(const edm::ParameterSet& iConfig)
     muonInputTag_(iConfig.getParameter<edm::InputTag>("iSpyMuonTrackExtrapolationTag")),
     trackPtMin_(iConfig.getParameter<double>("trackPtMin")),
     electronPtMin_(iConfig.getParameter<double>("electronPtMin")),
-    trackerMuonPtMin_(iConfig.getParameter<double>("trackerMuonPtMin"))
+    trackerMuonPtMin_(iConfig.getParameter<double>("trackerMuonPtMin")),
+    primaryVertexOnly_(iConfig.getUntrackedParameter<bool>("primaryVertexOnly", false)),
+    vertexInputTag_(iConfig.getUntrackedParameter<edm::InputTag>("iSpyPriVertexTag", edm::InputTag("offlinePrimaryVertices"))),
+    maxVertices_(iConfig.getUntrackedParameter<unsigned int>("maxVertices", 1)),
+    maxDz_(iConfig.getUntrackedParameter<double>("maxDz", 0.2)),
+    maxDxy_(iConfig.getUntrackedParameter<double>("maxDxy", 0.5))
 {
   trackToken_ = consumes<std::vector<reco::TrackExtrapolation> >(inputTag_);
   electronToken_ = consumes<reco::GsfElectronCollection>(gsfElectronInputTag_);
   muonToken_ = consumes<reco::MuonCollection>(muonInputTag_);
+
+  if ( primaryVertexOnly_ )
+    vertexToken_ = consumes<reco::VertexCollection>(vertexInputTag_);
 }
  
-void ISpyTrackExtrapolation::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyTrackExtrapolation::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -96,20 +106,23 @@ void ISpyTrackExtrapolation::analyze(const edm::Event& event, const edm::EventSe
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<std::vector<reco::TrackExtrapolation> > collection;
   event.getByToken(trackToken_, collection);
 
   if ( ! collection.isValid() ) 
   {
-    std::string error = "### Error: TrackExtrapolation "
-                        + edm::TypeID (typeid (reco::TrackExtrapolation)).friendlyClassName() + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-
-    config->error(error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: TrackExtrapolation "
+             + edm::TypeID (typeid (reco::TrackExtrapolation)).friendlyClassName() + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
     return;
   }
 
@@ -119,10 +132,14 @@ void ISpyTrackExtrapolation::analyze(const edm::Event& event, const edm::EventSe
                         + inputTag_.instance() + ":"
                         + inputTag_.process();
 
-  IgCollection& products = storage->getCollection("Products_V1");
-  IgProperty PROD = products.addProperty("Product", std::string ());
-  IgCollectionItem item = products.create();
-  item[PROD] = product;
+  config->product(sid, product);
+
+  // With primaryVertexOnly only the tracks from the leading vertices are shown
+  std::unique_ptr<ISpyVertexSelector> vertices;
+
+  if ( primaryVertexOnly_ )
+    vertices = ISpyVertexSelector::fromEvent(*config, sid, event, vertexToken_, vertexInputTag_,
+                                             maxVertices_, maxDz_, maxDxy_);
 
   IgCollection &tracks = storage->getCollection("Tracks_V3");
   IgProperty VTX = tracks.addProperty("pos", IgV3d());
@@ -152,6 +169,9 @@ void ISpyTrackExtrapolation::analyze(const edm::Event& event, const edm::EventSe
     if ( pt < trackPtMin_ )
       continue;
 
+    if ( vertices && ! vertices->compatible(*tr) )
+      continue;
+
     IgCollectionItem item = tracks.create();
       
     item[VTX] = IgV3d((*tr).referencePoint().x()/100.,
@@ -214,11 +234,10 @@ void ISpyTrackExtrapolation::analyze(const edm::Event& event, const edm::EventSe
               + inputTag_.instance() + ":"
               + inputTag_.process();
 
-    IgCollectionItem eitem = products.create();
-    eitem[PROD] = product;
+    config->product(sid, product);
 
     //std::vector<reco::TrackExtrapolation>::const_iterator ti = collection->begin();
-    
+
     for ( reco::GsfElectronCollection::const_iterator ei = electron_collection->begin(), eie = electron_collection->end();
           ei != eie; ++ei )
     { 
@@ -296,8 +315,7 @@ void ISpyTrackExtrapolation::analyze(const edm::Event& event, const edm::EventSe
               + inputTag_.instance() + ":" 
               + inputTag_.process();
 
-    IgCollectionItem mitem = products.create();
-    mitem[PROD] = product;
+    config->product(sid, product);
 
     std::vector<reco::TrackExtrapolation>::const_iterator ti = collection->begin();
 
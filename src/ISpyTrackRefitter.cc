@@ -1,23 +1,47 @@
 #include "ISpy/Analyzers/interface/ISpyTrackRefitter.h"
+#include "ISpy/Analyzers/interface/ISpyAssociations.h"
+#include "ISpy/Analyzers/interface/ISpyService.h"
 #include "TrackPropagation/SteppingHelixPropagator/interface/SteppingHelixPropagator.h"
 #include "MagneticField/Engine/interface/MagneticField.h"
 #include "TrackingTools/TransientTrack/interface/TransientTrack.h"
 #include "ISpy/Services/interface/IgCollection.h"
 #include "DataFormats/GeometrySurface/interface/PlaneBuilder.h"
 
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
 void
-ISpyTrackRefitter::refitTrack(IgCollectionItem& item, 
-			      IgAssociations& association, 
-			      IgDataStorage* storage, 
-			      reco::TrackRef track, 
-			      const MagneticField* field,
-			      double in, double out, double step) 
+ISpyTrackRefitter::writePoints(IgCollectionItem& item,
+			       ISpyAssociations& association,
+			       IgDataStorage* storage,
+			       const std::vector<IgV3d>& points)
+{
+  if ( points.empty() )
+    return;
+
+  IgCollection &collection = storage->getCollection("Points_V1");
+  IgProperty POS = collection.addProperty("pos", IgV3d());
+
+  for ( std::vector<IgV3d>::const_iterator pi = points.begin(), piEnd = points.end(); pi != piEnd; ++pi )
+  {
+    IgCollectionItem ipoint = collection.create ();
+    ipoint[POS] = *pi;
+    association.associate (item, ipoint);
+  }
+}
+
+void
+ISpyTrackRefitter::propagate(std::vector<IgV3d>& points,
+			     reco::TrackRef track, 
+			     const MagneticField* field,
+			     double in, double out, double step,
+			     double maxSagitta, int maxFailed) 
 {    
   if ( track.isNonnull() )
   {
-    IgCollection &points = storage->getCollection("Points_V1");
-    IgProperty POS = points.addProperty("pos", IgV3d());
-
     reco::TransientTrack aRealTrack(track, field);
 
     //Get a propagator and inner/outer state
@@ -58,6 +82,18 @@ ISpyTrackRefitter::refitTrack(IgCollectionItem& item,
                               yAxis.x(), yAxis.y(), yAxis.z(),
                               zAxis.x(), zAxis.y(), zAxis.z());
 
+    // Adaptive step: enough steps for the chord between two points to
+    // stay within maxSagitta (cm) of the track, taking the radius of
+    // curvature in the stronger field of the two ends
+    if ( maxSagitta > 0.0 )
+    {
+      double b = std::max(field->inTesla(gPin).mag(), field->inTesla(gPout).mag());
+      double radius = b > 0.0 ? 100.0*(*track).pt()/(0.299792458*b) : 0.0; // cm
+      int n = radius > 0.0 ? int(std::ceil(InOutVector.mag()/std::sqrt(8.0*radius*maxSagitta))) : 1;
+
+      step = 1.0/std::min(100, std::max(2, n));
+    }
+
     // Define step size and number of extra steps on inside and outside
     int nSteps = 0;
     int nStepsInside = 0;
@@ -95,17 +131,21 @@ ISpyTrackRefitter::refitTrack(IgCollectionItem& item,
     GlobalTrajectoryParameters GTPout (gPout, gVout, aRealTrack.impactPointTSCP ().charge (), field);
     FreeTrajectoryState FTSout (GTPout);
 
-    int nGood = 0;
-    int nBad = 0;
+    points.reserve(points.size() + nStepsInside + nSteps + 1 + nStepsOutside);
 
-    // Do nStepsInside propagations on inside to plot track
-    GlobalPoint GP = gPin; 
-    GP -= nStepsInside * StepVector;
-    Basic3DVector<float> Basic3DV (StepVector.x (), StepVector.y (), StepVector.z ());
+    // Each of the three parts is walked away from the track and given
+    // up after maxFailed failed propagations in a row (e.g. the track
+    // leaving the field map), keeping the points before them
+    int nFailed = 0;
+
+    // Do nStepsInside propagations on inside to plot track, from the
+    // inner state inwards; the points are then put back in order
+    size_t first = points.size();
+    GlobalPoint GP = gPin + StepVector;
 	
     for (int istep = 0; istep < nStepsInside; ++istep) 
     {
-      GP += StepVector;
+      GP -= StepVector;
       Surface::PositionType pos (GP.x (), GP.y (), GP.z ());
       PlaneBuilder::ReturnType SteppingPlane = PlaneBuilder ().plane (pos, rot);
       TrajectoryStateOnSurface trj =  reversePropagator.propagate (FTSin, *SteppingPlane);
@@ -116,19 +156,18 @@ ISpyTrackRefitter::refitTrack(IgCollectionItem& item,
         float y = trj.globalPosition ().y () / 100.0;
         float z = trj.globalPosition ().z () / 100.0;		   
         
-        IgCollectionItem ipoint = points.create ();
-        ipoint[POS] = IgV3d(x, y, z);
-        association.associate (item, ipoint);		
+        points.push_back(IgV3d(x, y, z));
         
-        nGood++;
+        nFailed = 0;
       } 
-      else 
-      {
-        nBad++;
-      }
+      else if ( ++nFailed == maxFailed )
+        break;
     }
 
+    std::reverse(points.begin() + first, points.end());
+
     // Do nStep propagations from track Inner state to track Outer state
+    nFailed = 0;
     
     GP = gPin - StepVector;
     float w = 0;
@@ -160,22 +199,19 @@ ISpyTrackRefitter::refitTrack(IgCollectionItem& item,
         float y = (1.0-w2)*y1 + w2*y2;
         float z = (1.0-w2)*z1 + w2*z2;
 
-        IgCollectionItem ipoint = points.create ();
-        ipoint[POS] = IgV3d(x,y,z);
-        association.associate (item, ipoint);		
+        points.push_back(IgV3d(x, y, z));
     
-        nGood++;
+        nFailed = 0;
       } 
-      else 
-      {
-        nBad++;
-      }
+      else if ( ++nFailed == maxFailed )
+        break;
       
       w += 1.0/float(nSteps);
     }
     
     // Do nStepsInside propagations on Outside to plot track
     GP = gPout;
+    nFailed = 0;
     
     for (int istep = 0; istep < nStepsOutside; ++istep) 
     {
@@ -189,16 +225,108 @@ ISpyTrackRefitter::refitTrack(IgCollectionItem& item,
         float x = trj.globalPosition ().x () / 100.0;
         float y = trj.globalPosition ().y () / 100.0;
         float z = trj.globalPosition ().z () / 100.0;		   
-        IgCollectionItem ipoint = points.create ();
-        ipoint[POS] = IgV3d (x,y,z);
-        association.associate (item, ipoint);		
+        points.push_back(IgV3d(x, y, z));
       
-        nGood++;
+        nFailed = 0;
       } 
-      else 
-      {
-        nBad++;
-      }
+      else if ( ++nFailed == maxFailed )
+        break;
     }
   }
 }
+
+bool
+ISpyTrackRefitter::helix(Helix& h,
+                         reco::TrackRef track,
+                         const MagneticField* field,
+                         double in, double out)
+{
+  if ( track.isNull() || ! (*track).innerOk() || ! (*track).outerOk() )
+    return false;
+
+  GlobalPoint gPin((*track).innerPosition().x(),
+                   (*track).innerPosition().y(),
+                   (*track).innerPosition().z());
+
+  GlobalPoint gPout((*track).outerPosition().x(),
+                    (*track).outerPosition().y(),
+                    (*track).outerPosition().z());
+
+  // Uniform within 2% at both ends and half way: this holds inside
+  // the solenoid, not in the return yoke
+  float bIn = field->inTesla(gPin).z();
+  float bMid = field->inTesla(GlobalPoint(0.5*(gPin.x() + gPout.x()),
+                                          0.5*(gPin.y() + gPout.y()),
+                                          0.5*(gPin.z() + gPout.z()))).z();
+  float bOut = field->inTesla(gPout).z();
+  float tolerance = 0.02*std::fabs(bIn) + 0.01;
+
+  if ( std::fabs(bMid - bIn) > tolerance || std::fabs(bOut - bIn) > tolerance )
+    return false;
+
+  double px = (*track).innerMomentum().x();
+  double py = (*track).innerMomentum().y();
+  double pz = (*track).innerMomentum().z();
+  double pt = std::sqrt(px*px + py*py);
+
+  if ( pt <= 0.0 )
+    return false;
+
+  // 0.2998 GeV/(T m) for a unit charge
+  double curvature = -0.299792458*(*track).charge()*bIn/pt;
+
+  // Transverse path length from the inner to the outer position,
+  // along the arc over their chord
+  double dx = (gPout.x() - gPin.x())/100.0;
+  double dy = (gPout.y() - gPin.y())/100.0;
+  double chord = std::sqrt(dx*dx + dy*dy);
+  double halfAngle = 0.5*std::fabs(curvature)*chord;
+
+  if ( halfAngle >= 1.0 )
+    return false;
+
+  double length = halfAngle > 1e-6 ? 2.0*std::asin(halfAngle)/std::fabs(curvature) : chord;
+
+  h.pos = IgV3d(gPin.x()/100.0, gPin.y()/100.0, gPin.z()/100.0);
+  h.p = IgV3d(px, py, pz);
+  h.curvature = curvature;
+  h.s1 = -in*length;
+  h.s2 = (1.0 + out)*length;
+
+  return true;
+}
+
+void
+ISpyTrackRefitter::writeHelix(IgCollectionItem& item,
+                              ISpyAssociations& association,
+                              IgDataStorage* storage,
+                              const Helix& h)
+{
+  IgCollection &helices = storage->getCollection("HelixSegments_V1");
+  IgProperty POS = helices.addProperty("pos", IgV3d());
+  IgProperty P = helices.addProperty("p", IgV3d());
+  IgProperty CURVATURE = helices.addProperty("curvature", 0.0);
+  IgProperty S1 = helices.addProperty("s1", 0.0);
+  IgProperty S2 = helices.addProperty("s2", 0.0);
+
+  IgCollectionItem helix = helices.create();
+  helix[POS] = h.pos;
+  helix[P] = h.p;
+  helix[CURVATURE] = h.curvature;
+  helix[S1] = h.s1;
+  helix[S2] = h.s2;
+
+  association.associate(item, helix);
+}
+
+void
+ISpyTrackRefitter::reportError(edm::service::ISpyService& config, edm::StreamID sid,
+                               const char* message, const Refit& refit)
+{
+  static std::atomic<bool> logged(false);
+
+  config.error(sid, message, [message] { return std::string(message); });
+
+  if ( ! logged.exchange(true) )
+    edm::LogWarning("ISpyTrackRefitter") << message << ":\n" << refit.error;
+}
@@ -26,10 +26,18 @@
 using namespace edm::service;
 
 ISpyTrackerGeometry::ISpyTrackerGeometry(const edm::ParameterSet& iPSet)
+  : cacheIdentifier_(0),
+    timer_(iPSet.getUntrackedParameter<unsigned int>("benchmarkRepeat", 0))
 {}
 
 void
-ISpyTrackerGeometry::analyze(const edm::Event& event, const edm::EventSetup& eventSetup) 
+ISpyTrackerGeometry::endJob(void)
+{
+  timer_.report("ISpyTrackerGeometry");
+}
+
+void
+ISpyTrackerGeometry::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {    
   edm::Service<ISpyService> config;
 
@@ -42,37 +50,46 @@ ISpyTrackerGeometry::analyze(const edm::Event& event, const edm::EventSetup& eve
       "or remove the module that requires it";
   }
 
+  const TrackerDigiGeometryRecord& record = eventSetup.get<TrackerDigiGeometryRecord>();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if ( record.cacheIdentifier() == cacheIdentifier_ )
+    return;
+
+  cacheIdentifier_ = record.cacheIdentifier();
+
   eventSetup.get<GlobalTrackingGeometryRecord>().get(globalTrackingGeom_);
-  eventSetup.get<TrackerDigiGeometryRecord>().get(trackerGeom_);
+  record.get(trackerGeom_);
   eventSetup.get<TrackerTopologyRcd>().get(trackerTopology_);
 
-  IgDataStorage *storage  = config->esStorage ();
+  IgDataStorage *storage  = config->esStorage(sid);
 
-  if ( trackerGeom_.isValid() &&  watch_trackerGeom_.check(eventSetup))
+  if ( trackerGeom_.isValid() )
   {
     // FIXME: Only if we want full tracker in 3D:
     // buildTracker3D(storage);
 
-    buildPixelBarrel3D(storage);
-    buildPixelEndcapPlus3D(storage);
-    buildPixelEndcapMinus3D(storage);
+    timer_.run("buildPixelBarrel3D", storage, [&](IgDataStorage *s) { buildPixelBarrel3D (s); });
+    timer_.run("buildPixelEndcapPlus3D", storage, [&](IgDataStorage *s) { buildPixelEndcapPlus3D (s); });
+    timer_.run("buildPixelEndcapMinus3D", storage, [&](IgDataStorage *s) { buildPixelEndcapMinus3D (s); });
 
-    buildTIB3D(storage);
-    buildTOB3D(storage);
-    buildTECPlus3D(storage);
-    buildTECMinus3D(storage);
+    timer_.run("buildTIB3D", storage, [&](IgDataStorage *s) { buildTIB3D (s); });
+    timer_.run("buildTOB3D", storage, [&](IgDataStorage *s) { buildTOB3D (s); });
+    timer_.run("buildTECPlus3D", storage, [&](IgDataStorage *s) { buildTECPlus3D (s); });
+    timer_.run("buildTECMinus3D", storage, [&](IgDataStorage *s) { buildTECMinus3D (s); });
 
-    buildTIDPlus3D(storage);
-    buildTIDMinus3D(storage);
+    timer_.run("buildTIDPlus3D", storage, [&](IgDataStorage *s) { buildTIDPlus3D (s); });
+    timer_.run("buildTIDMinus3D", storage, [&](IgDataStorage *s) { buildTIDMinus3D (s); });
 
-    buildTrackerRPhi(storage);
-    buildTrackerRZ(storage);
+    timer_.run("buildTrackerRPhi", storage, [&](IgDataStorage *s) { buildTrackerRPhi (s); });
+    timer_.run("buildTrackerRZ", storage, [&](IgDataStorage *s) { buildTrackerRZ (s); });
   
   }
 }
 
 void
-ISpyTrackerGeometry::buildTracker3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTracker3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("Tracker3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -87,6 +104,7 @@ ISpyTrackerGeometry::buildTracker3D (IgDataStorage *storage)
 
   TrackerGeometry::DetContainer::const_iterator it  = trackerGeom_->detUnits ().begin ();
   TrackerGeometry::DetContainer::const_iterator end = trackerGeom_->detUnits ().end ();
+
   for (; it != end; ++it)
   {	    
     uint32_t id = (*it)->geographicalId ().rawId ();
@@ -147,7 +165,7 @@ ISpyTrackerGeometry::buildTracker3D (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildPixelBarrel3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildPixelBarrel3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("PixelBarrel3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -162,7 +180,7 @@ ISpyTrackerGeometry::buildPixelBarrel3D (IgDataStorage *storage)
 
   TrackerGeometry::DetContainer::const_iterator it  = trackerGeom_->detsPXB ().begin ();
   TrackerGeometry::DetContainer::const_iterator end = trackerGeom_->detsPXB ().end ();
-  
+
   for (; it != end; ++it)
   {	    
     uint32_t id = (*it)->geographicalId ().rawId ();
@@ -223,7 +241,7 @@ ISpyTrackerGeometry::buildPixelBarrel3D (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildPixelEndcap3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildPixelEndcap3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("PixelEndcap3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -238,6 +256,7 @@ ISpyTrackerGeometry::buildPixelEndcap3D (IgDataStorage *storage)
 
   TrackerGeometry::DetContainer::const_iterator it  = trackerGeom_->detsPXF ().begin ();
   TrackerGeometry::DetContainer::const_iterator end = trackerGeom_->detsPXF ().end ();
+
   for (; it != end; ++it)
   {	    
     uint32_t id = (*it)->geographicalId ().rawId ();
@@ -298,7 +317,7 @@ ISpyTrackerGeometry::buildPixelEndcap3D (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildPixelEndcapPlus3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildPixelEndcapPlus3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("PixelEndcapPlus3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -378,7 +397,7 @@ ISpyTrackerGeometry::buildPixelEndcapPlus3D (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildPixelEndcapMinus3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildPixelEndcapMinus3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("PixelEndcapMinus3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -456,7 +475,7 @@ ISpyTrackerGeometry::buildPixelEndcapMinus3D (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildTIB3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTIB3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("SiStripTIB3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -471,6 +490,7 @@ ISpyTrackerGeometry::buildTIB3D (IgDataStorage *storage)
 
   TrackerGeometry::DetContainer::const_iterator it  = trackerGeom_->detsTIB ().begin ();
   TrackerGeometry::DetContainer::const_iterator end = trackerGeom_->detsTIB ().end ();
+
   for (; it != end; ++it)
   {	    
     uint32_t id = (*it)->geographicalId ().rawId ();
@@ -530,7 +550,7 @@ ISpyTrackerGeometry::buildTIB3D (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildTOB3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTOB3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("SiStripTOB3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -545,6 +565,7 @@ ISpyTrackerGeometry::buildTOB3D (IgDataStorage *storage)
 
   TrackerGeometry::DetContainer::const_iterator it  = trackerGeom_->detsTOB ().begin ();
   TrackerGeometry::DetContainer::const_iterator end = trackerGeom_->detsTOB ().end ();
+
   for (; it != end; ++it)
   {	    
     uint32_t id = (*it)->geographicalId ().rawId ();
@@ -604,7 +625,7 @@ ISpyTrackerGeometry::buildTOB3D (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildTEC3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTEC3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("SiStripTEC3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -619,6 +640,7 @@ ISpyTrackerGeometry::buildTEC3D (IgDataStorage *storage)
 
   TrackerGeometry::DetContainer::const_iterator it  = trackerGeom_->detsTEC ().begin ();
   TrackerGeometry::DetContainer::const_iterator end = trackerGeom_->detsTEC ().end ();
+
   for (; it != end; ++it)
   {	    
     uint32_t id = (*it)->geographicalId ().rawId ();
@@ -679,7 +701,7 @@ ISpyTrackerGeometry::buildTEC3D (IgDataStorage *storage)
 
 
 void
-ISpyTrackerGeometry::buildTECPlus3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTECPlus3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("SiStripTECPlus3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -756,7 +778,7 @@ ISpyTrackerGeometry::buildTECPlus3D (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildTECMinus3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTECMinus3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("SiStripTECMinus3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -833,7 +855,7 @@ ISpyTrackerGeometry::buildTECMinus3D (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildTID3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTID3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("SiStripTID3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -848,6 +870,7 @@ ISpyTrackerGeometry::buildTID3D (IgDataStorage *storage)
 
   TrackerGeometry::DetContainer::const_iterator it  = trackerGeom_->detsTID ().begin ();
   TrackerGeometry::DetContainer::const_iterator end = trackerGeom_->detsTID ().end ();
+
   for (; it != end; ++it)
   {	    
     uint32_t id = (*it)->geographicalId ().rawId ();
@@ -908,7 +931,7 @@ ISpyTrackerGeometry::buildTID3D (IgDataStorage *storage)
 
 
 void
-ISpyTrackerGeometry::buildTIDPlus3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTIDPlus3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("SiStripTIDPlus3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -986,7 +1009,7 @@ ISpyTrackerGeometry::buildTIDPlus3D (IgDataStorage *storage)
 
 
 void
-ISpyTrackerGeometry::buildTIDMinus3D (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTIDMinus3D (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("SiStripTIDMinus3D_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -1064,7 +1087,7 @@ ISpyTrackerGeometry::buildTIDMinus3D (IgDataStorage *storage)
 
 
 void
-ISpyTrackerGeometry::buildTrackerRPhi (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTrackerRPhi (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("TrackerRPhi_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
@@ -1143,7 +1166,7 @@ ISpyTrackerGeometry::buildTrackerRPhi (IgDataStorage *storage)
 }
 
 void
-ISpyTrackerGeometry::buildTrackerRZ (IgDataStorage *storage)
+ISpyTrackerGeometry::buildTrackerRZ (IgDataStorage *storage) const
 {
   IgCollection &geometry = storage->getCollection ("TrackerRZ_V1");
   IgProperty DET_ID  = geometry.addProperty ("detid", int (0)); 
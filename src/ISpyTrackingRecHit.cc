@@ -25,7 +25,7 @@ ISpyTrackingRecHit::ISpyTrackingRecHit (const edm::ParameterSet& iConfig)
 }
 
 void
-ISpyTrackingRecHit::analyze( const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyTrackingRecHit::analyze( edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -38,16 +38,18 @@ ISpyTrackingRecHit::analyze( const edm::Event& event, const edm::EventSetup& eve
       "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
   
-  edm::ESHandle<GlobalTrackingGeometry> geom;
-  eventSetup.get<GlobalTrackingGeometryRecord> ().get (geom);
+  const GlobalTrackingGeometry* geom = config->esContext(sid, eventSetup).globalTrackingGeometry();
       
-  if ( ! geom.isValid() )
+  if ( ! geom )
   {
     std::string error = 
       "### Error: ISpyTrackingRecHit::analyze: Invalid GlobalTrackingGeometryRecord ";
-    config->error (error);
+    config->error (sid, error);
     return;
   }
 
@@ -62,23 +64,22 @@ ISpyTrackingRecHit::analyze( const edm::Event& event, const edm::EventSetup& eve
                           + inputTag_.instance() + ":" 
                           + inputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 	
     IgCollection &recHits = storage->getCollection("TrackingRecHits_V1");
     IgProperty POS = recHits.addProperty("pos", IgV3d());
 
+    ISpyLocalPosition positions(geom);
+
     for (TrackingRecHitCollection::const_iterator it=collection->begin(), itEnd=collection->end(); it!=itEnd; ++it)
     {
       if ((*it).isValid () && !(*it).geographicalId ().null ())
       {
-        LocalPoint point = ISpyLocalPosition::localPosition(&(*it), geom.product ());
+        GlobalPoint point = positions.globalPosition(&(*it));
         
-        float x = geom->idToDet ((*it).geographicalId ())->surface ().toGlobal (point).x () / 100.0;
-        float y = geom->idToDet ((*it).geographicalId ())->surface ().toGlobal (point).y () / 100.0;
-        float z = geom->idToDet ((*it).geographicalId ())->surface ().toGlobal (point).z () / 100.0;
+        float x = point.x () / 100.0;
+        float y = point.y () / 100.0;
+        float z = point.z () / 100.0;
 
         IgCollectionItem irechit = recHits.create();
         irechit[POS] = IgV3d (static_cast<double>(x), static_cast<double>(y), static_cast<double>(z));
@@ -88,12 +89,13 @@ ISpyTrackingRecHit::analyze( const edm::Event& event, const edm::EventSetup& eve
   
   else 
   {
-    std::string error = "### Error: TrackingRecHits "
-                        + edm::TypeID (typeid (TrackingRecHitCollection)).friendlyClassName () + ":" 
-                        + inputTag_.label() + ":"
-                        + inputTag_.instance() + ":" 
-                        + inputTag_.process() + " are not found.";
-    config->error (error);
+    config->error (sid, &inputTag_, [&] {
+      return "### Error: TrackingRecHits "
+             + edm::TypeID (typeid (TrackingRecHitCollection)).friendlyClassName () + ":"
+             + inputTag_.label() + ":"
+             + inputTag_.instance() + ":"
+             + inputTag_.process() + " are not found.";
+    });
   }
 }
 
@@ -6,6 +6,7 @@
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/Run.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/Exception.h"
@@ -24,7 +25,7 @@ ISpyTriggerEvent::ISpyTriggerEvent(const edm::ParameterSet& iConfig)
   : triggerEventTag_(iConfig.getParameter<edm::InputTag>("triggerEventTag")),
     triggerResultsTag_(iConfig.getParameter<edm::InputTag>("triggerResultsTag")),
     processName_(iConfig.getParameter<std::string>("processName")),
-    hltConfigProvided_(true)
+    pathDictionary_(iConfig.getUntrackedParameter<bool>("pathDictionary", false))
 {
   // Force the InputTags specified to have the same process name as given in processName.
   edm::InputTag tmpEventTag(iConfig.getParameter<edm::InputTag>("triggerEventTag"));
@@ -32,18 +33,97 @@ ISpyTriggerEvent::ISpyTriggerEvent(const edm::ParameterSet& iConfig)
 
   edm::InputTag tmpResultsTag(iConfig.getParameter<edm::InputTag>("triggerResultsTag"));
   triggerResultsTag_ = edm::InputTag(tmpResultsTag.label(), tmpResultsTag.instance(), processName_);
+
+  triggerEventToken_ = consumes<TriggerEvent>(triggerEventTag_);
+  triggerResultsToken_ = consumes<TriggerResults>(triggerResultsTag_);
 }
 
-void
-ISpyTriggerEvent::beginRun(const edm::Run& iRun, const edm::EventSetup& iSetup)
+std::shared_ptr<ISpyTriggerRun>
+ISpyTriggerEvent::globalBeginRun(const edm::Run& iRun, const edm::EventSetup& iSetup) const
 {
+  std::shared_ptr<ISpyTriggerRun> run(new ISpyTriggerRun);
+
+  HLTConfigProvider hltConfig;
   bool changed(false);
-  if ( ! hltConfig_.init(iRun, iSetup, processName_, changed) )
-    hltConfigProvided_ = false;
+  run->hltConfigProvided = hltConfig.init(iRun, iSetup, processName_, changed);
+
+  // Names, module labels, types and filter tags are fixed for the run
+  // so look them up here once rather than for every path of every event.
+  if ( ! run->hltConfigProvided )
+    return run;
+
+  const unsigned int n(hltConfig.size());
+  run->paths.resize(n);
+
+  edm::Service<ISpyService> config;
+
+  for ( unsigned int i = 0; i != n; ++i )
+  {
+    ISpyTriggerRun::TriggerPath& path = run->paths[i];
+
+    path.name = hltConfig.triggerName(i);
+    path.nameId = pathDictionary_ && config.isAvailable() ? config->intern(path.name) : -1;
+    path.index = hltConfig.triggerIndex(path.name);
+
+    if ( path.index >= n )
+      continue;
+
+    path.moduleLabels = hltConfig.moduleLabels(path.index);
+    path.moduleTypes.reserve(path.moduleLabels.size());
+    path.filterTags.reserve(path.moduleLabels.size());
+
+    for ( std::vector<std::string>::const_iterator ml = path.moduleLabels.begin(), mlEnd = path.moduleLabels.end();
+          ml != mlEnd; ++ml )
+    {
+      path.moduleTypes.push_back(hltConfig.moduleType(*ml));
+      path.filterTags.push_back(InputTag(*ml, "", processName_));
+    }
+
+    if ( pathDictionary_ && config.isAvailable() )
+    {
+      for ( unsigned int j = 0; j != path.moduleLabels.size(); ++j )
+      {
+        path.moduleLabelIds.push_back(config->intern(path.moduleLabels[j]));
+        path.moduleTypeIds.push_back(config->intern(path.moduleTypes[j]));
+      }
+    }
+  }
+
+  return run;
+}
+
+namespace
+{
+  // TriggerPaths_V1 and TriggerObjects_V1 carry the path names, module
+  // labels and types; the V2 collections carry their ids in the
+  // archive's string table instead (see ISpyService::intern).
+  struct ByName
+  {
+    typedef std::string Type;
+
+    static const char* paths(void) { return "TriggerPaths_V1"; }
+    static const char* objects(void) { return "TriggerObjects_V1"; }
+
+    static const std::string& name(const ISpyTriggerRun::TriggerPath& path) { return path.name; }
+    static const std::string& moduleLabel(const ISpyTriggerRun::TriggerPath& path, unsigned int j) { return path.moduleLabels[j]; }
+    static const std::string& moduleType(const ISpyTriggerRun::TriggerPath& path, unsigned int j) { return path.moduleTypes[j]; }
+  };
+
+  struct ById
+  {
+    typedef int Type;
+
+    static const char* paths(void) { return "TriggerPaths_V2"; }
+    static const char* objects(void) { return "TriggerObjects_V2"; }
+
+    static int name(const ISpyTriggerRun::TriggerPath& path) { return path.nameId; }
+    static int moduleLabel(const ISpyTriggerRun::TriggerPath& path, unsigned int j) { return path.moduleLabelIds[j]; }
+    static int moduleType(const ISpyTriggerRun::TriggerPath& path, unsigned int j) { return path.moduleTypeIds[j]; }
+  };
 }
 
 void
-ISpyTriggerEvent::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+ISpyTriggerEvent::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -56,57 +136,63 @@ ISpyTriggerEvent::analyze(const edm::Event& event, const edm::EventSetup& eventS
       "or remove the module that requires it";
   }
 
-  IgDataStorage* storage = config->storage();
-  IgCollection& triggerPaths = storage->getCollection("TriggerPaths_V1");
+  if ( config->pruned(moduleDescription().id()) )
+    return;
 
-  // Always create an HLT trigger collection
-  // even an empty one.
-  // It is needed to allow correct event filtering
-  // at the client level.
-  
-  IgProperty NAME = triggerPaths.addProperty("Name", std::string());
-  IgProperty INDEX = triggerPaths.addProperty("Index", int(0));
-  IgProperty WR = triggerPaths.addProperty("WasRun", int(0));
-  IgProperty AC = triggerPaths.addProperty("Accept", int(0));
-  IgProperty ER = triggerPaths.addProperty("Error", int(0));
-  IgProperty OBS = triggerPaths.addProperty("Objects", std::string());
+  IgDataStorage* storage = config->storage(sid);
+  const ISpyTriggerRun* run = runCache(event.getRun().index());
+
+  // With the path dictionary the events only carry the ids of the
+  // path names, module labels and types in the archive's string table.
+  if ( pathDictionary_ )
+    write<ById>(sid, event, storage, *run);
+  else
+    write<ByName>(sid, event, storage, *run);
+}
 
-  if ( ! hltConfigProvided_ )
+bool
+ISpyTriggerEvent::inputs(edm::StreamID sid, const edm::Event& event, IgDataStorage* storage,
+                         const ISpyTriggerRun& run,
+                         Handle<TriggerEvent>& triggerEvent,
+                         Handle<TriggerResults>& triggerResults) const
+{
+  edm::Service<ISpyService> config;
+
+  if ( ! run.hltConfigProvided )
   {
     std::string error = 
       "### Error: ISpyTriggerEvent: cannot initialize HLTConfigProvider with process name "+processName_;
-    config->error (error);
-    return;
+    config->error (sid, error);
+    return false;
   }
     
-  Handle<TriggerEvent> triggerEvent;
-  event.getByLabel(triggerEventTag_, triggerEvent);
-
-  Handle<TriggerResults> triggerResults;
-  event.getByLabel(triggerResultsTag_, triggerResults);
-
+  event.getByToken(triggerEventToken_, triggerEvent);
+  event.getByToken(triggerResultsToken_, triggerResults);
 
   if ( ! triggerEvent.isValid() )
   {
-    std::string error = "### Error: TriggerEvent "
-                        + edm::TypeID (typeid (TriggerEvent)).friendlyClassName() + ":"
-                        + triggerEventTag_.label() + ":"
-                        + triggerEventTag_.instance() + ":"
-                        + triggerEventTag_.process() + " not found.";
-    config->error (error);
+    config->error (sid, &triggerEventTag_, [&] {
+      return "### Error: TriggerEvent "
+             + edm::TypeID (typeid (TriggerEvent)).friendlyClassName() + ":"
+             + triggerEventTag_.label() + ":"
+             + triggerEventTag_.instance() + ":"
+             + triggerEventTag_.process() + " not found.";
+    });
   }
     
   if ( ! triggerResults.isValid() )
   {
-    std::string error = "### Error: TriggerResults "
-                        + edm::TypeID (typeid (TriggerResults)).friendlyClassName() + ":"
-                        + triggerResultsTag_.label() + ":"
-                        + triggerResultsTag_.instance() + ":"
-                        + triggerResultsTag_.process() + " not found.";
-    config->error (error);
+    config->error (sid, &triggerResultsTag_, [&] {
+      return "### Error: TriggerResults "
+             + edm::TypeID (typeid (TriggerResults)).friendlyClassName() + ":"
+             + triggerResultsTag_.label() + ":"
+             + triggerResultsTag_.instance() + ":"
+             + triggerResultsTag_.process() + " not found.";
+    });
   }
-    
-  
+
+  if ( ! triggerEvent.isValid() || ! triggerResults.isValid() )
+    return false;
 
   std::string tevent = "TriggerEvent "
                        + edm::TypeID (typeid (TriggerEvent)).friendlyClassName() + ":"
@@ -120,72 +206,49 @@ ISpyTriggerEvent::analyze(const edm::Event& event, const edm::EventSetup& eventS
                         + triggerResultsTag_.instance() + ":"
                         + triggerResultsTag_.process();
 
-  IgCollection& products = storage->getCollection("Products_V1");
-  IgProperty PROD = products.addProperty("Product", std::string ());
-  IgCollectionItem item = products.create();
-  item[PROD] = tevent+"  "+tresult;
-
-  IgCollection& triggerObjects = storage->getCollection("TriggerObjects_V1");
-
-  IgProperty PATH = triggerObjects.addProperty("path", std::string());
-  IgProperty SLOT = triggerObjects.addProperty("slot", int(0));
-  IgProperty ML = triggerObjects.addProperty("moduleLabel", std::string());
-  IgProperty MT = triggerObjects.addProperty("moduleType", std::string());
-  IgProperty ID = triggerObjects.addProperty("VID", int(0));
-  IgProperty KEY = triggerObjects.addProperty("KEY", int(0));
-  IgProperty TID = triggerObjects.addProperty("id", int(0));
-  IgProperty PT = triggerObjects.addProperty("pt", 0.0);
-  IgProperty ETA = triggerObjects.addProperty("eta", 0.0);
-  IgProperty PHI = triggerObjects.addProperty("phi", 0.0);
-  IgProperty MASS = triggerObjects.addProperty("mass", 0.0);
+  config->product(sid, tevent+"  "+tresult);
 
   // This is the number of triggers over which we iterate
-  const unsigned int n(hltConfig_.size());
+  const unsigned int n(run.paths.size());
     
-  if ( triggerResults->size() != hltConfig_.size() )
+  if ( triggerResults->size() != n )
   {   
     std::string error = "### Error: ISpyTriggerEvent: TriggerResults.size() != HLTConfigProvider.size()";
-    config->error (error);
-    return;
+    config->error (sid, error);
+    return false;
   }
-   
+
   for ( unsigned int i = 0; i != n; ++i )
   {
-    IgCollectionItem tp = triggerPaths.create();
-      
-    std::string triggerName = hltConfig_.triggerName(i); 
-    unsigned int triggerIndex = hltConfig_.triggerIndex(triggerName);
-      
-    if ( triggerIndex >= n )
+    if ( run.paths[i].index >= n )
     {
-      std::string error = "### Error: ISpyTriggerEvent: "+triggerName+" not found";
-      config->error (error);
-      return;
+      std::string error = "### Error: ISpyTriggerEvent: "+run.paths[i].name+" not found";
+      config->error (sid, error);
+      return false;
     }
-      
-    tp[NAME] = triggerName;
-    tp[INDEX] = triggerIndex;
-      
-    tp[WR] = static_cast<int>(triggerResults->wasrun(triggerIndex));
-    tp[AC] = static_cast<int>(triggerResults->accept(triggerIndex));
-    tp[ER] = static_cast<int>(triggerResults->error(triggerIndex));
+  }
 
-    const std::vector<std::string>& moduleLabels(hltConfig_.moduleLabels(triggerIndex));
-    const unsigned int moduleIndex(triggerResults->index(triggerIndex));  
+  return true;
+}
 
-    std::stringstream ss;
+namespace
+{
+  // Calls f(slot, vid, key, object) for each object of the filters of
+  // path up to the last module that ran
+  template <class F>
+  void forEachObject(const TriggerEvent& triggerEvent, const ISpyTriggerRun::TriggerPath& path,
+                     unsigned int moduleIndex, F f)
+  {
+    const TriggerObjectCollection& triggerObjectCollection(triggerEvent.getObjects());
 
-    for ( unsigned int j = 0; j <= moduleIndex; ++j ) 
+    for ( unsigned int j = 0; j <= moduleIndex && j < path.filterTags.size(); ++j ) 
     {
-      const std::string&  moduleLabel(moduleLabels[j]);
-      const std::string  moduleType(hltConfig_.moduleType(moduleLabel));
-      
-      const unsigned int filterIndex(triggerEvent->filterIndex(InputTag(moduleLabel,"",processName_)));
+      const unsigned int filterIndex(triggerEvent.filterIndex(path.filterTags[j]));
 
-      if ( filterIndex < triggerEvent->sizeFilters() ) 
+      if ( filterIndex < triggerEvent.sizeFilters() ) 
       {
-        const Vids& VIDS = triggerEvent->filterIds(filterIndex);
-        const Keys& KEYS = triggerEvent->filterKeys(filterIndex);
+        const Vids& VIDS = triggerEvent.filterIds(filterIndex);
+        const Keys& KEYS = triggerEvent.filterKeys(filterIndex);
         
         const size_type nI = VIDS.size();
         const size_type nK = KEYS.size();
@@ -193,31 +256,80 @@ ISpyTriggerEvent::analyze(const edm::Event& event, const edm::EventSetup& eventS
         assert(nI==nK);
         const size_type N(std::max(nI,nK));
 
-        const TriggerObjectCollection& triggerObjectCollection(triggerEvent->getObjects());
-          
         for ( size_type k = 0; k != N; ++k )
-        {
-          ss << VIDS[k] << "/" << KEYS[k] <<" ";
-          
-          IgCollectionItem t = triggerObjects.create();
-          const TriggerObject& triggerObject(triggerObjectCollection[KEYS[k]]);
-	 
-          t[PATH] = triggerName;
-          t[SLOT] = j;
-          t[ML] = moduleLabel;
-          t[MT] = moduleType;
-          
-          t[ID] = static_cast<int>(VIDS[k]);
-          t[KEY] = static_cast<int>(KEYS[k]);
-  
-          t[TID] = static_cast<int>(triggerObject.id());
-          t[PT] = static_cast<double>(triggerObject.pt());
-          t[ETA] = static_cast<double>(triggerObject.eta());
-          t[PHI] = static_cast<double>(triggerObject.phi());
-          t[MASS] = static_cast<double>(triggerObject.mass());
-        }        
+          f(j, VIDS[k], KEYS[k], triggerObjectCollection[KEYS[k]]);
       }
     }
+  }
+}
+
+template <class P>
+void
+ISpyTriggerEvent::write(edm::StreamID sid, const edm::Event& event, IgDataStorage* storage,
+                        const ISpyTriggerRun& run) const
+{
+  typedef typename P::Type Type;
+
+  // Always create an HLT trigger collection
+  // even an empty one.
+  // It is needed to allow correct event filtering
+  // at the client level.
+  IgCollection& triggerPaths = storage->getCollection(P::paths());
+  IgProperty NAME = triggerPaths.addProperty("Name", Type());
+  IgProperty INDEX = triggerPaths.addProperty("Index", int(0));
+  IgProperty WR = triggerPaths.addProperty("WasRun", int(0));
+  IgProperty AC = triggerPaths.addProperty("Accept", int(0));
+  IgProperty ER = triggerPaths.addProperty("Error", int(0));
+  IgProperty OBS = triggerPaths.addProperty("Objects", std::string());
+
+  Handle<TriggerEvent> triggerEvent;
+  Handle<TriggerResults> triggerResults;
+
+  if ( ! inputs(sid, event, storage, run, triggerEvent, triggerResults) )
+    return;
+
+  IgCollection& triggerObjects = storage->getCollection(P::objects());
+  IgProperty PATH = triggerObjects.addProperty("path", Type());
+  IgProperty SLOT = triggerObjects.addProperty("slot", int(0));
+  IgProperty ML = triggerObjects.addProperty("moduleLabel", Type());
+  IgProperty MT = triggerObjects.addProperty("moduleType", Type());
+  IgProperty ID = triggerObjects.addProperty("VID", int(0));
+  IgProperty KEY = triggerObjects.addProperty("KEY", int(0));
+  IgProperty TID = triggerObjects.addProperty("id", int(0));
+  IgProperty PT = triggerObjects.addProperty("pt", 0.0);
+  IgProperty ETA = triggerObjects.addProperty("eta", 0.0);
+  IgProperty PHI = triggerObjects.addProperty("phi", 0.0);
+  IgProperty MASS = triggerObjects.addProperty("mass", 0.0);
+
+  for ( std::vector<ISpyTriggerRun::TriggerPath>::const_iterator path = run.paths.begin(), pathEnd = run.paths.end();
+        path != pathEnd; ++path )
+  {
+    IgCollectionItem tp = triggerPaths.create();
+    tp[NAME] = P::name(*path);
+    tp[INDEX] = path->index;
+    tp[WR] = static_cast<int>(triggerResults->wasrun(path->index));
+    tp[AC] = static_cast<int>(triggerResults->accept(path->index));
+    tp[ER] = static_cast<int>(triggerResults->error(path->index));
+
+    std::stringstream ss;
+
+    forEachObject(*triggerEvent, *path, triggerResults->index(path->index),
+                  [&](unsigned int j, int vid, size_type key, const TriggerObject& triggerObject) {
+      ss << vid << "/" << key <<" ";
+
+      IgCollectionItem t = triggerObjects.create();
+      t[PATH] = P::name(*path);
+      t[SLOT] = j;
+      t[ML] = P::moduleLabel(*path, j);
+      t[MT] = P::moduleType(*path, j);
+      t[ID] = vid;
+      t[KEY] = static_cast<int>(key);
+      t[TID] = static_cast<int>(triggerObject.id());
+      t[PT] = static_cast<double>(triggerObject.pt());
+      t[ETA] = static_cast<double>(triggerObject.eta());
+      t[PHI] = static_cast<double>(triggerObject.phi());
+      t[MASS] = static_cast<double>(triggerObject.mass());
+    });
       
     tp[OBS] = ss.str();
   }    
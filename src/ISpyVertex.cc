@@ -25,7 +25,7 @@ ISpyVertex::ISpyVertex(const edm::ParameterSet& iConfig)
   secVertexToken_ = consumes<VertexCollection>(secVertexInputTag_);
 }
 
-void ISpyVertex::analyze(const edm::Event& event, const edm::EventSetup& eventSetup)
+void ISpyVertex::analyze(edm::StreamID sid, const edm::Event& event, const edm::EventSetup& eventSetup) const
 {
   edm::Service<ISpyService> config;
 
@@ -38,7 +38,10 @@ void ISpyVertex::analyze(const edm::Event& event, const edm::EventSetup& eventSe
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   edm::Handle<VertexCollection> priCollection;
   event.getByToken(priVertexToken_, priCollection);
@@ -51,10 +54,7 @@ void ISpyVertex::analyze(const edm::Event& event, const edm::EventSetup& eventSe
                           + priVertexInputTag_.instance() + ":"
                           + priVertexInputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& vertices = storage->getCollection("PrimaryVertices_V1");
 
@@ -91,11 +91,12 @@ void ISpyVertex::analyze(const edm::Event& event, const edm::EventSetup& eventSe
 
   else
   {
-    std::string error = "### Error: Vertices "
-                        + edm::TypeID (typeid (VertexCollection)).friendlyClassName() + ":"
-                        + priVertexInputTag_.label() + ":"
-                        + priVertexInputTag_.instance() + " are not found";
-    config->error(error);
+    config->error (sid, &priVertexInputTag_, [&] {
+      return "### Error: Vertices "
+             + edm::TypeID (typeid (VertexCollection)).friendlyClassName() + ":"
+             + priVertexInputTag_.label() + ":"
+             + priVertexInputTag_.instance() + " are not found";
+    });
   }
 
 
@@ -110,10 +111,7 @@ void ISpyVertex::analyze(const edm::Event& event, const edm::EventSetup& eventSe
                           + secVertexInputTag_.instance() + ":"
                           + secVertexInputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& vertices = storage->getCollection("SecondaryVertices_V1");
 
@@ -150,11 +148,12 @@ void ISpyVertex::analyze(const edm::Event& event, const edm::EventSetup& eventSe
   
   else
   {
-    std::string error = "### Error: Vertices "
-                        + edm::TypeID (typeid (VertexCollection)).friendlyClassName() + ":"
-                        + secVertexInputTag_.label() + ":"
-                        + secVertexInputTag_.instance() + " are not found";
-    config->error(error);
+    config->error (sid, &secVertexInputTag_, [&] {
+      return "### Error: Vertices "
+             + edm::TypeID (typeid (VertexCollection)).friendlyClassName() + ":"
+             + secVertexInputTag_.label() + ":"
+             + secVertexInputTag_.instance() + " are not found";
+    });
   }
 
 
@@ -23,7 +23,7 @@ ISpyVertexCompositeCandidate::ISpyVertexCompositeCandidate(const ParameterSet& i
   vertexCompositeCandidateToken_ = consumes<VertexCompositeCandidateCollection>(vertexCompositeCandidateInputTag_);
 }
 
-void ISpyVertexCompositeCandidate::analyze(const Event& event, const EventSetup& eventSetup)
+void ISpyVertexCompositeCandidate::analyze(edm::StreamID sid, const Event& event, const EventSetup& eventSetup) const
 {
   Service<ISpyService> config;
 
@@ -36,7 +36,10 @@ void ISpyVertexCompositeCandidate::analyze(const Event& event, const EventSetup&
      "or remove the module that requires it";
   }
 
-  IgDataStorage *storage = config->storage();
+  if ( config->pruned(moduleDescription().id()) )
+    return;
+
+  IgDataStorage *storage = config->storage(sid);
 
   Handle<VertexCompositeCandidateCollection> vccCollection;
   event.getByToken(vertexCompositeCandidateToken_, vccCollection);
@@ -49,10 +52,7 @@ void ISpyVertexCompositeCandidate::analyze(const Event& event, const EventSetup&
                           + vertexCompositeCandidateInputTag_.instance() + ":"
                           + vertexCompositeCandidateInputTag_.process();
 
-    IgCollection& products = storage->getCollection("Products_V1");
-    IgProperty PROD = products.addProperty("Product", std::string ());
-    IgCollectionItem item = products.create();
-    item[PROD] = product;
+    config->product(sid, product);
 
     IgCollection& vccs = storage->getCollection("VertexCompositeCandidates_V1");
 
@@ -76,11 +76,12 @@ void ISpyVertexCompositeCandidate::analyze(const Event& event, const EventSetup&
 
   else
   {
-    std::string error = "### Error: VertexCompositeCandidates "
-                        + TypeID (typeid (VertexCompositeCandidateCollection)).friendlyClassName() + ":"
-                        + vertexCompositeCandidateInputTag_.label() + ":"
-                        + vertexCompositeCandidateInputTag_.instance() + " are not found";
-    config->error(error);
+    config->error (sid, &vertexCompositeCandidateInputTag_, [&] {
+      return "### Error: VertexCompositeCandidates "
+             + TypeID (typeid (VertexCompositeCandidateCollection)).friendlyClassName() + ":"
+             + vertexCompositeCandidateInputTag_.label() + ":"
+             + vertexCompositeCandidateInputTag_.instance() + " are not found";
+    });
   }
 
 